@@ -28,8 +28,10 @@
 #define ERH_UNREACHABLE_CODE                 (7u)
 #define ERH_OPT_TYPE_INVALID                 (8u)
 #define ERH_APP_UDP_RX_ERROR				 (9u)
+#define ERH_SD_SNAPSHOT_INVALID              (10u)
+#define ERH_SD_WATCH_EVENT_LOST              (11u)
 
-#define ERH_NUMBER_OF_ERRORS                 (10u)
+#define ERH_NUMBER_OF_ERRORS                 (12u)
 #define ERH_SIZE_OF_ERH_BUFFER               (255u)
 
 /* **************************************************** */
@@ -0,0 +1,61 @@
+// Include guard starts here
+#ifndef SI_SD_BINDING_H_
+#define SI_SD_BINDING_H_
+
+/**
+ * @file    SI_SD_binding.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Client side binding of a remote service instance.
+ *           Resolves (service, instance, major) in the remote service registry once and caches the offered endpoint.
+ *           The cache is revalidated by comparing the generation of the registry element, so a send costs
+ *           a handle dereference instead of a registry search. Registry search is done again only if SD
+ *           reports a changed or expired offer."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+#include "SI_client.h"
+
+#include "SI_SD_config.h"
+#include "SI_SD_service_manager.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+/**
+ * Binding handle, keep one instance per used remote service instance.
+ */
+struct SI_SD_Binding
+{
+    uint16 service_id;
+    uint16 instance_id;
+    uint8 major;
+    struct SD_remote_Service* service;  // resolved registry element, NULLPTR if not resolved yet
+    uint32 generation;                  // generation of service at resolution
+    struct SD_Endpoint endpoint;        // cached endpoint of the offer
+};
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+void SI_SD_BINDING_init(struct SI_SD_Binding* binding, uint16 service_id, uint16 instance_id, uint8 major);
+const struct SD_Endpoint* SI_SD_BINDING_resolve(struct SI_SD_Binding* binding);
+
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+boolean SI_SD_BINDING_request(struct SI_SD_Binding* binding, const struct SI_CLIENT_RequestParams* params,
+                              const uint8* payload, uint32 payload_length,
+                              SI_CLIENT_ResponseCallback_fptr callback, void* user_data, uint16* out_session_id);
+#endif
+
+// Include guard stops here
+#endif // SI_SD_BINDING_H_
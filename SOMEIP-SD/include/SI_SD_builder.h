@@ -0,0 +1,59 @@
+// Include guard starts here
+#ifndef SI_SD_BUILDER_H_
+#define SI_SD_BUILDER_H_
+
+/**
+ * @file    SI_SD_builder.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Builds SOME/IP Service Discovery payloads into a Tx buffer (see SI_SD_MESSAGE_init()).
+ *           Entries are serialised straight into the buffer, options are collected and appended when the payload is closed.
+ *           Identical options are stored once and referenced by the option run of every entry using them,
+ *           so many entries fit into a single datagram.
+ *
+ *           Usage: init -> add entries while they fit -> SI_SD_PROVIDER_send() -> invalidate"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+#include "SI_message.h"
+
+#include "SI_SD_config.h"
+#include "SI_SD_payload.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+struct SI_SD_PayloadBuilder
+{
+    struct SI_MessageBuilder message;
+    uint32 entries_length_offset;       // position of the "Length of Entries Array" field in message
+    uint32 entries_num;
+    struct SI_SD_IPv4EndpointOption options[SI_SD_CFG_BUILDER_MAX_OPTIONS];
+    uint32 options_num;
+    boolean closed;                     // entries and options arrays are complete
+};
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+boolean SI_SD_BUILDER_init(struct SI_SD_PayloadBuilder* builder);
+boolean SI_SD_BUILDER_add_service_entry(struct SI_SD_PayloadBuilder* builder, const struct SI_SD_ServiceEntry* entry,
+                                        const struct SI_SD_IPv4EndpointOption* option);
+boolean SI_SD_BUILDER_add_eventgroup_entry(struct SI_SD_PayloadBuilder* builder, const struct SI_SD_EventgroupEntry* entry,
+                                           const struct SI_SD_IPv4EndpointOption* option);
+boolean SI_SD_BUILDER_close(struct SI_SD_PayloadBuilder* builder);
+boolean SI_SD_BUILDER_is_empty(const struct SI_SD_PayloadBuilder* builder);
+boolean SI_SD_BUILDER_invalidate(struct SI_SD_PayloadBuilder* builder);
+
+// Include guard stops here
+#endif // SI_SD_BUILDER_H_
@@ -30,24 +30,123 @@
 #define SI_SD_CFG_MAX_REMOTE_SERVICES       (8u)
 
 /**
- * Maximum number of subscriptions that a node can handle
+ * Number of slots in the hash index of the remote service registry (open addressing).
+ * Value must be a power of two and bigger than SI_SD_CFG_MAX_REMOTE_SERVICES, twice as big keeps probe sequences short.
+ */
+#define SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE (2u * SI_SD_CFG_MAX_REMOTE_SERVICES)
+
+/**
+ * Maximum number of subscriptions that a node can handle (subscribers of local eventgroups).
+ * Subscription table uses open addressing, value must be a power of two.
  */
 #define SI_SD_CFG_MAX_SUBSCRIPTIONS        (8u)
 
 /**
- * Port used by SOME/IP-SD protocoll to communicate multicast messages.
+ * Maximum number of local service instances that a node can offer
  */
-#define SI_SD_CFG_PORT_NUMBER               (SI_SD_CONST_DEFAULT_PORT_NUMBER)
+#define SI_SD_CFG_MAX_LOCAL_SERVICES        (8u)
+
+/**
+ * Initial Wait Phase: the first offer is sent after a random delay between
+ * SI_SD_CFG_INITIAL_DELAY_MIN_MS and SI_SD_CFG_INITIAL_DELAY_MAX_MS [ms].
+ * Randomisation prevents every node of the network sending its offers at the same time after power on.
+ */
+#define SI_SD_CFG_INITIAL_DELAY_MIN_MS      (10u)
+#define SI_SD_CFG_INITIAL_DELAY_MAX_MS      (100u)
+
+/**
+ * Repetition Phase: offer is repeated SI_SD_CFG_REPETITIONS_MAX times, delay between the offers
+ * starts from SI_SD_CFG_REPETITIONS_BASE_DELAY_MS [ms] and it is doubled after every repetition.
+ * Zero SI_SD_CFG_REPETITIONS_MAX skips the Repetition Phase.
+ */
+#define SI_SD_CFG_REPETITIONS_BASE_DELAY_MS (200u)
+#define SI_SD_CFG_REPETITIONS_MAX           (3u)
+
+/**
+ * Main Phase: offer is sent cyclically with this delay [ms]. Zero disables cyclic offers.
+ */
+#define SI_SD_CFG_CYCLIC_OFFER_DELAY_MS     (2000u)
+
+/**
+ * Offers answering FindService entries are delayed by a random time between
+ * SI_SD_CFG_REQUEST_RESPONSE_DELAY_MIN_MS and SI_SD_CFG_REQUEST_RESPONSE_DELAY_MAX_MS [ms],
+ * so several servers do not answer the same Find at once. Zero values answer immediately.
+ */
+#define SI_SD_CFG_REQUEST_RESPONSE_DELAY_MIN_MS     (10u)
+#define SI_SD_CFG_REQUEST_RESPONSE_DELAY_MAX_MS     (50u)
+
+/**
+ * TTL of sent offers [sec]. Must be longer than SI_SD_CFG_CYCLIC_OFFER_DELAY_MS, otherwise
+ * remote nodes drop the offer between two cyclic offers.
+ */
+#define SI_SD_CFG_OFFER_TTL                 (3u)
 
 /**
- * The maximum number of entries that a node can handle
+ * Maximum number of different options in a sent SD message. Entries using an identical option share it,
+ * a new entry needing a further option starts a new datagram.
  */
-#define SI_SD_SERVICE_ENTRIES_MAX_NUMBER    (SI_SD_CFG_MAX_REMOTE_SERVICES)
+#define SI_SD_CFG_BUILDER_MAX_OPTIONS       (16u)
 
 /**
- * The maximum number of options that a node can handle
+ * Maximum number of remote SD nodes whose session is tracked to detect their reboot (see SI_SD_peer.h)
  */
-#define SI_SD_SERVICE_OPTIONS_MAX_NUMBER    (SI_SD_CFG_MAX_REMOTE_SERVICES)
+#define SI_SD_CFG_MAX_PEERS                 (16u)
+
+/**
+ * Maximum number of availability watches (see SI_SD_watch.h) and the number of registry changes
+ * that can wait for the watch callbacks
+ */
+#define SI_SD_CFG_MAX_WATCHES               (16u)
+#define SI_SD_CFG_WATCH_QUEUE_SIZE          (2u * SI_SD_CFG_MAX_REMOTE_SERVICES)
+
+/**
+ * Maximum number of options of a received SD message. Options are variable length, their positions are indexed
+ * once per message (see struct SI_SD_PARSER_Context). Entries referencing further options are ignored.
+ */
+#define SI_SD_CFG_PARSER_MAX_OPTIONS        (32u)
+
+/**
+ * Port used by SOME/IP-SD protocoll to communicate multicast messages.
+ */
+#define SI_SD_CFG_PORT_NUMBER               (SI_SD_CONST_DEFAULT_PORT_NUMBER)
+
+/**
+ * Critical section hooks of the shared SD state. Received SD messages may be processed by several workers
+ * (e.g. one per network interface, see SI_SD_PROCESS_receive()) in parallel with SI_SD_PROVIDER_tick_ms().
+ * Each lock guards one table, no lock is taken while another one is held, except the session lock
+ * that is taken inside the others when a message is sent. Locks need not be recursive.
+ *
+ * Default: single threaded, no locking. Override them (e.g. with RTOS mutexes) through compiler definitions.
+ */
+#ifndef SI_SD_CFG_REMOTE_REGISTRY_LOCK
+#define SI_SD_CFG_REMOTE_REGISTRY_LOCK()    do { } while (0)        // remote service registry and its TTL timers
+#define SI_SD_CFG_REMOTE_REGISTRY_UNLOCK()  do { } while (0)
+#endif
+
+#ifndef SI_SD_CFG_SUBSCRIPTION_LOCK
+#define SI_SD_CFG_SUBSCRIPTION_LOCK()       do { } while (0)        // subscription table
+#define SI_SD_CFG_SUBSCRIPTION_UNLOCK()     do { } while (0)
+#endif
+
+#ifndef SI_SD_CFG_OFFER_LOCK
+#define SI_SD_CFG_OFFER_LOCK()              do { } while (0)        // offer state machines of local services
+#define SI_SD_CFG_OFFER_UNLOCK()            do { } while (0)
+#endif
+
+#ifndef SI_SD_CFG_PEER_LOCK
+#define SI_SD_CFG_PEER_LOCK()               do { } while (0)        // session table of the remote SD nodes
+#define SI_SD_CFG_PEER_UNLOCK()             do { } while (0)
+#endif
+
+#ifndef SI_SD_CFG_WATCH_LOCK
+#define SI_SD_CFG_WATCH_LOCK()              do { } while (0)        // availability watches
+#define SI_SD_CFG_WATCH_UNLOCK()            do { } while (0)
+#endif
+
+#ifndef SI_SD_CFG_SESSION_LOCK
+#define SI_SD_CFG_SESSION_LOCK()            do { } while (0)        // session counters of the SD context
+#define SI_SD_CFG_SESSION_UNLOCK()          do { } while (0)
+#endif
 
 /* **************************************************** */
 /*                  Type definitions                    */
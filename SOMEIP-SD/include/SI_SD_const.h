@@ -116,6 +116,41 @@
 #define SI_SD_CONST_ENTRY_ARRAY_DIV_RATIO           (4u)
 
 #define SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP          (0x11u)
+#define SI_SD_CONST_IPV4_PROTOCOL_TYPE_TCP          (0x06u)
+
+/**
+ * Size of the "Length" and "Type" fields of an option. "Length" counts the bytes following them,
+ * so an option takes ("Length" + SI_SD_CONST_OPTION_HEADER_SIZE) bytes in the options array.
+ */
+#define SI_SD_CONST_OPTION_HEADER_SIZE              (3u)
+
+/**
+ * Value of the "Length" field of IPv4 Endpoint and IPv4 Multicast options (type field is not included)
+ */
+#define SI_SD_CONST_IPV4_OPTION_LENGTH              (0x0009u)
+
+/**
+ * Value of the "Length" field of IPv6 Endpoint, IPv6 Multicast and IPv6 SD Endpoint options
+ */
+#define SI_SD_CONST_IPV6_OPTION_LENGTH              (0x0015u)
+#define SI_SD_CONST_IPV6_ADDRESS_SIZE               (16u)
+
+/**
+ * Value of the "Length" field of the Load Balancing option
+ */
+#define SI_SD_CONST_LOAD_BALANCING_OPTION_LENGTH    (0x0005u)
+
+/**
+ * Wildcard values of Find entries: any instance, any major version, any minor version
+ */
+#define SI_SD_CONST_ANY_INSTANCE_ID                 (0xFFFFu)
+#define SI_SD_CONST_ANY_MAJOR_VERSION               (0xFFu)
+#define SI_SD_CONST_ANY_MINOR_VERSION               (0xFFFFFFFFu)
+
+/**
+ * TTL value meaning "valid until the next reboot"
+ */
+#define SI_SD_CONST_TTL_INFINITE                    (0x00FFFFFFu)
 
 /* **************************************************** */
 /*                  Type definitions                    */
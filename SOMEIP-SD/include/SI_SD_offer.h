@@ -0,0 +1,93 @@
+// Include guard starts here
+#ifndef SI_SD_OFFER_H_
+#define SI_SD_OFFER_H_
+
+/**
+ * @file    SI_SD_offer.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Server side of SOME/IP Service Discovery: offers local service instances.
+ *           Every offered service instance runs the SD timing state machine:
+ *           Initial Wait Phase (random delay) -> Repetition Phase (exponentially growing delay) -> Main Phase (cyclic offers).
+ *           Services in Main Phase are offered together from a pre-serialised datagram.
+ *           Stopping an offered service sends StopOffer. FindService entries matching an offered service
+ *           are answered after the request-response delay. Timing is driven by SI_SD_PROVIDER_tick_ms()."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+
+#include "SI_SD_config.h"
+#include "SI_SD_service_manager.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+enum SI_SD_OFFER_State_t
+{
+    SI_SD_OFFER_State_DOWN = 0x00u,             // not offered
+    SI_SD_OFFER_State_INITIAL_WAIT = 0x01u,
+    SI_SD_OFFER_State_REPETITION = 0x02u,
+    SI_SD_OFFER_State_MAIN = 0x03u
+};
+
+/**
+ * Local service instance offered by this node. Key: Service ID and Instance ID.
+ */
+struct SI_SD_OFFER_service
+{
+    boolean used;
+    uint16 service_id;
+    uint16 instance_id;
+    uint8 major;
+    uint32 minor;
+    struct SD_Endpoint endpoint;        // endpoint of the service instance (network order)
+    enum SI_SD_OFFER_State_t state;
+    uint32 remaining_ms;                // time until the next offer (Main Phase: see the shared cyclic offer timer)
+    uint32 repetition_delay_ms;         // current delay of the Repetition Phase
+    uint32 repetitions;                 // number of offers sent in the Repetition Phase
+    boolean answer_pending;             // a FindService entry is waiting for the answer
+    struct SD_Context* answer_context;  // SD instance the FindService entry was received on, answer is sent through it
+    uint32 answer_remaining_ms;         // time until the answer is sent
+    uint32 answer_ipv4_be;              // destination of the answer (network order)
+    uint16 answer_port_be;              // destination of the answer (network order)
+    boolean answer_unicast;             // FALSE: answer is sent to the SD multicast group
+};
+
+struct SI_SD_OFFER_counters
+{
+    uint32 offers_sent;         // number of sent OfferService entries
+    uint32 stop_offers_sent;    // number of sent StopOfferService entries
+    uint32 tx_failed;           // number of failed transmissions
+    uint32 finds_answered;      // number of offers sent as answer of FindService entries
+    uint32 finds_merged;        // number of FindService entries answered together with an already pending answer
+    uint32 cyclic_rebuilds;     // number of times the pre-serialised cyclic offer datagram was rebuilt
+};
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+struct SI_SD_OFFER_service* SI_SD_OFFER_add(uint16 service_id, uint16 instance_id, uint8 major, uint32 minor,
+                                            uint32 ipv4_be, uint16 port_be);
+struct SI_SD_OFFER_service* SI_SD_OFFER_find(uint16 service_id, uint16 instance_id);
+boolean SI_SD_OFFER_start(struct SD_Context *sd_context, struct SI_SD_OFFER_service* service);
+boolean SI_SD_OFFER_stop(struct SD_Context *sd_context, struct SI_SD_OFFER_service* service);
+void SI_SD_OFFER_shutdown(struct SD_Context *sd_context);
+boolean SI_SD_OFFER_send(struct SD_Context *sd_context, const struct SI_SD_OFFER_service* service,
+                         uint32 dst_ipv4_be, uint16 dst_port_be, boolean unicast, uint32 ttl);
+void SI_SD_OFFER_answer_find(struct SD_Context *sd_context, const struct SI_SD_ServiceEntry* find,
+                             uint32 src_ipv4_be, uint16 src_port_be, boolean unicast);
+void SI_SD_OFFER_tick(struct SD_Context *sd_context, const uint32 elapsed_time_ms);
+void SI_SD_OFFER_get_counters(struct SI_SD_OFFER_counters* out_counters);
+
+// Include guard stops here
+#endif // SI_SD_OFFER_H_
@@ -6,13 +6,13 @@
  * @file    SI_SD_parser.h
  * @author  Erdei Sándor (sandorerdei21@gmail.com)
  * @date
- * @brief   "Parser modul responsible to turn received byte arrays into organized structures.
- *           The main task of the modul is to fill received_service_registry variable for SI_SD_provider.
- * 
- *           The modul is implemented with major simplifications:
- *           It assumes that in every received Service Discovery message there is only one Service Entry (type 1 entry)
- *           and only one IPv4 Endpoint type Option. The modul is partially prepared for bigger SD messages and it can be 
- *           fixed by re-writing the SI_SD_PARSER_fill_received_service_registry() function logic."
+ * @brief   "Parser modul responsible to turn received SOME/IP Service Discovery datagrams into registry updates.
+ *           Entries are deserialised one by one straight from the datagram, the option they reference is resolved
+ *           and the entry is applied at once: offers to the remote service registry, Find entries to the offer
+ *           state machines, Eventgroup Entries to the subscriptions. No intermediate copy of the message is kept.
+ *
+ *           Both option runs of an entry are resolved. Unknown options are skipped if they are discardable,
+ *           otherwise only the entry referencing them is ignored."
  */
 
 /* **************************************************** */
@@ -33,13 +33,33 @@
 /* **************************************************** */
 
 struct SD_Payload;
+struct SD_Context;
+
+/**
+ * State of parsing one received SD message. Owned by the caller (e.g. on the stack of the SD worker).
+ */
+struct SI_SD_PARSER_Context
+{
+    struct SD_Context* sd_context;      // SD instance answers and acknowledgements are sent through
+    uint32 src_ipv4_be;                 // sender of the message (network order)
+    uint16 src_port_be;                 // sender of the message (network order)
+    boolean unicast;                    // unicast flag of the message
+    uint16 option_offsets[SI_SD_CFG_PARSER_MAX_OPTIONS];  // position of the options in the options array
+    uint32 options_numof;               // number of indexed options
+    uint32 entries_applied;             // number of entries applied to the registries
+    uint32 entries_skipped;             // number of entries with unsupported type
+    uint32 entries_rejected;            // number of entries referencing missing or unknown, not discardable options
+    uint32 options_skipped;             // number of unknown, discardable options
+};
 
 /* **************************************************** */
 /*               Function declarations                  */
 /* **************************************************** */
 
 boolean SI_SD_PARSER_parse_datagram(uint8* udp_payload, uint32 udp_payload_length, struct SD_Header* out_header, struct SD_Payload* out_payload);
-boolean SI_SD_PARSER_parse_payload(struct SD_Payload* in_payload);
+void SI_SD_PARSER_init_context(struct SI_SD_PARSER_Context* parser_context, struct SD_Context* sd_context,
+                               uint32 src_ipv4_be, uint16 src_port_be, boolean unicast);
+boolean SI_SD_PARSER_parse_payload(struct SI_SD_PARSER_Context* parser_context, struct SD_Payload* in_payload);
 
 // Include guard stops here
 #endif // SI_SD_PARSER_H_
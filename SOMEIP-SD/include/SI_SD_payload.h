@@ -9,8 +9,8 @@
  * @brief   "Interface for handling SOME/IP Service Discovery payload, provides check functions for easy handling.
  * 
  *           The modul is implemented with major simplifications:
- *           The modul only handles Service (type 1) entries and only IPv4 Endpoint type options.
- *           EventGroup entries and options with other types are not supported."
+ *           The modul handles Service (type 1) and Eventgroup (type 2) entries, but only IPv4 Endpoint
+ *           and IPv4 Multicast type options. Options with other types are not supported."
  * 
  */
 
@@ -31,28 +31,12 @@
 /*                  Type definitions                    */
 /* **************************************************** */
 
-enum SI_SD_EntryRelatedAction_t
-{
-    SI_SD_EntryRelatedAction_None = 0x00u,
-    SI_SD_EntryRelatedAction_Save = 0x01u,
-    SI_SD_EntryRelatedAction_Update = 0x02u,
-    SI_SD_EntryRelatedAction_Delete = 0x03u,
-    SI_SD_EntryRelatedAction_Provide = 0x04u
-};
-
-enum SI_SD_OptionRelatedAction_t
-{
-    SI_SD_OptionRelatedAction_None = 0x00u,
-    SI_SD_OptionRelatedAction_Save = 0x01u,
-    SI_SD_OptionRelatedAction_Update = 0x02u,
-    SI_SD_OptionRelatedAction_Delete = 0x03u,
-    SI_SD_OptionRelatedAction_Provide = 0x04u
-};
-
 enum SD_EntryTypes
 {
     SD_EntryTypes_Find =  ((uint8)0x00u),
     SD_EntryTypes_Offer = ((uint8)0x01u),  /* Offer (ttl>0) / StopOffer (ttl=0) */
+    SD_EntryTypes_Subscribe = ((uint8)0x06u),      /* Subscribe (ttl>0) / StopSubscribe (ttl=0) */
+    SD_EntryTypes_SubscribeAck = ((uint8)0x07u),   /* SubscribeAck (ttl>0) / SubscribeNack (ttl=0) */
 };
 
 struct SI_SD_ServiceEntry
@@ -69,11 +53,34 @@ struct SI_SD_ServiceEntry
     uint32 minor_version;
 };
 
+/**
+ * Eventgroup Entry (type 2): Subscribe, StopSubscribe, SubscribeAck and SubscribeNack
+ */
+struct SI_SD_EventgroupEntry
+{
+    enum SD_EntryTypes type;
+    uint8 index_1st_option_run;
+    uint8 index_2nd_option_run;
+    uint8 number_of_options1;
+    uint8 number_of_options2;
+    uint16 serviceID;
+    uint16 instanceID;
+    uint8 major_version;
+    uint32 ttl;
+    uint8 counter;                      // distinguishes parallel subscriptions to the same eventgroup (4 bit)
+    uint16 eventgroupID;
+};
+
 enum SD_OptionTypes_t
 {
+    SD_OptionTypes_CONFIGURATION     = 0x01u,
+    SD_OptionTypes_LOAD_BALANCING    = 0x02u,
     SD_OptionTypes_IPV4_ENDPOINT     = 0x04u,
+    SD_OptionTypes_IPV6_ENDPOINT     = 0x06u,
     SD_OptionTypes_IPV4_MC           = 0x14u,
-    SD_OptionTypes_IPV4_SD_Endpoint  = 0x24u
+    SD_OptionTypes_IPV6_MC           = 0x16u,
+    SD_OptionTypes_IPV4_SD_Endpoint  = 0x24u,
+    SD_OptionTypes_IPV6_SD_Endpoint  = 0x26u
 };
 
 struct SI_SD_IPv4EndpointOption
@@ -86,22 +93,66 @@ struct SI_SD_IPv4EndpointOption
     uint16 port_number;
 };
 
+/**
+ * IPv6 Endpoint, IPv6 Multicast and IPv6 SD Endpoint options
+ */
+struct SI_SD_IPv6EndpointOption
+{
+    uint16 length;
+    enum SD_OptionTypes_t type;
+    boolean discardable_flag;
+    uint8 IPv6_address[SI_SD_CONST_IPV6_ADDRESS_SIZE];
+    uint8 l4_proto;
+    uint16 port_number;
+};
+
+struct SI_SD_LoadBalancingOption
+{
+    uint16 priority;                    // lower value: preferred
+    uint16 weight;                      // among instances of the same priority
+};
+
+/**
+ * Configuration option: DNS-SD TXT record style strings, each prefixed by its length, terminated by a zero length
+ */
+struct SI_SD_ConfigurationOption
+{
+    const uint8* data;                  // points into the received datagram, NULLPTR if there is none
+    uint16 length;
+};
+
+/**
+ * Options referenced by the two option runs of a received entry. Options of the same type are not repeated
+ * in a valid message, except the endpoint options, that may appear once per transport protocol:
+ * UDP endpoints are preferred over TCP ones.
+ */
+struct SI_SD_EntryOptions
+{
+    boolean has_ipv4_endpoint;
+    struct SI_SD_IPv4EndpointOption ipv4_endpoint;
+    boolean has_ipv4_multicast;
+    struct SI_SD_IPv4EndpointOption ipv4_multicast;
+    boolean has_ipv4_sd_endpoint;
+    struct SI_SD_IPv4EndpointOption ipv4_sd_endpoint;
+    boolean has_ipv6_endpoint;
+    struct SI_SD_IPv6EndpointOption ipv6_endpoint;
+    boolean has_ipv6_multicast;
+    struct SI_SD_IPv6EndpointOption ipv6_multicast;
+    boolean has_ipv6_sd_endpoint;
+    struct SI_SD_IPv6EndpointOption ipv6_sd_endpoint;
+    boolean has_load_balancing;
+    struct SI_SD_LoadBalancingOption load_balancing;
+    struct SI_SD_ConfigurationOption configuration;
+};
+
+/**
+ * SD payload of a received datagram (after the preamble). Entries are applied straight from the raw bytes.
+ */
 struct SD_Payload
 {
     /* raw byte array */
     uint8* data;
     uint32 length;
-
-    /* parsed structures */
-    uint32 entries_length;
-    struct SI_SD_ServiceEntry entries[SI_SD_SERVICE_ENTRIES_MAX_NUMBER];
-    enum SI_SD_EntryRelatedAction_t entry_action[SI_SD_SERVICE_ENTRIES_MAX_NUMBER];
-    boolean enty_validity[SI_SD_SERVICE_ENTRIES_MAX_NUMBER];
-
-    uint32 options_length;
-    struct SI_SD_IPv4EndpointOption options[SI_SD_SERVICE_OPTIONS_MAX_NUMBER];
-    enum SI_SD_OptionRelatedAction_t option_action[SI_SD_SERVICE_OPTIONS_MAX_NUMBER];
-    boolean option_validity[SI_SD_SERVICE_OPTIONS_MAX_NUMBER];
 };
 
 /* **************************************************** */
@@ -119,6 +170,16 @@ boolean SI_SD_PAYLOAD_create_single_entry(enum SD_EntryTypes type,
                                             uint32 ttl,
                                             uint32 minor_version,
                                             struct SI_SD_ServiceEntry* out_entry);
+boolean SI_SD_PAYLOAD_create_eventgroup_entry(enum SD_EntryTypes type,
+                                              uint8 index_1st_option_run,
+                                              uint8 number_of_options1,
+                                              uint16 serviceID,
+                                              uint16 instanceID,
+                                              uint8 major_version,
+                                              uint32 ttl,
+                                              uint8 counter,
+                                              uint16 eventgroupID,
+                                              struct SI_SD_EventgroupEntry* out_entry);
 boolean SI_SD_PAYLOAD_create_option(uint16 length,
                                     enum SD_OptionTypes_t type,
                                     boolean discardable_flag,
@@ -0,0 +1,67 @@
+// Include guard starts here
+#ifndef SI_SD_PEER_H_
+#define SI_SD_PEER_H_
+
+/**
+ * @file    SI_SD_peer.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Tracks the remote SD nodes (peers) by their address: last session ID and reboot flag of their
+ *           multicast and unicast messages. A peer rebooted if it sets the reboot flag again, or its session ID
+ *           does not increase while the flag is set (session counters of the new life started again).
+ *           State learnt from the previous life of the peer (offers, subscriptions) is stale then.
+ *           Table is full: the peer silent for the longest time is forgotten."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+
+#include "SI_SD_config.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+/**
+ * Session state of the messages of a peer sent to the multicast group or to this node
+ */
+struct SD_PeerChannel
+{
+    boolean seen;                       // a message was received on this channel
+    uint16 session_id;                  // session ID of the last message
+    boolean reboot_flag;                // reboot flag of the last message
+};
+
+struct SD_Peer
+{
+    boolean used;
+    uint32 ipv4_be;                     // address of the peer (network order)
+    uint32 last_seen;                   // value of the message counter at the last message of the peer
+    struct SD_PeerChannel multicast;
+    struct SD_PeerChannel unicast;
+};
+
+struct SI_SD_PEER_counters
+{
+    uint32 reboots_detected;    // number of detected peer reboots
+    uint32 evicted;             // number of peers forgotten because the table was full
+};
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+void SI_SD_PEER_init(void);
+boolean SI_SD_PEER_update(uint32 ipv4_be, uint16 session_id, boolean reboot_flag, boolean multicast);
+boolean SI_SD_PEER_get(uint32 ipv4_be, struct SD_Peer* out_peer);
+void SI_SD_PEER_get_counters(struct SI_SD_PEER_counters* out_counters);
+
+// Include guard stops here
+#endif // SI_SD_PEER_H_
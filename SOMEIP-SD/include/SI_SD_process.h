@@ -24,11 +24,11 @@
 #include "SI_dispatcher.h"
 #include "SI_parser.h"
 #include "SI_header.h"
-#include "SI_service_manager.h"
 #include "SI_message.h"
 
-#include "SI_SD_Header.h"
+#include "SI_SD_header.h"
 #include "SI_SD_payload.h"
+#include "SI_SD_service_manager.h"
 
 /* **************************************************** */
 /*                       Defines                        */
@@ -50,6 +50,8 @@ struct SD_MessageContext
 /* **************************************************** */
 
 boolean SI_SD_PROCESS_multicast(struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf, const ip_addr_t *src_addr, u16_t src_port);
+boolean SI_SD_PROCESS_receive(struct SD_Context *sd_context, struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf,
+                              const ip_addr_t *src_addr, u16_t src_port, boolean multicast);
 
 // Include guard stops here
 #endif /* SI_SD_PROCESS_H_ */
\ No newline at end of file
@@ -20,6 +20,7 @@
 
 #include "SI_header.h"
 #include "SI_message.h"
+#include "SI_timerwheel.h"
 
 #include "SI_SD_config.h"
 #include "SI_SD_parser.h"
@@ -33,17 +34,8 @@
 /*                  Type definitions                    */
 /* **************************************************** */
 
-/**
- * Contains Entry and Option fields from received SOME/IP Service Discovery messages
-*/
-struct SD_received_Service
-{
-    struct SI_SD_ServiceEntry entry;
-    enum SI_SD_EntryRelatedAction_t entry_action;
-    struct SI_SD_IPv4EndpointOption option;
-    enum SI_SD_OptionRelatedAction_t option_action;
-    boolean used;
-};
+struct SI_SD_PayloadBuilder;
+struct SI_SD_Watch;
 
 /**
  * Contains endpoint information: IPv4 address, port number
@@ -58,6 +50,12 @@ struct SD_Endpoint
 /**
  * Defines a service instance
  * Contains IDs, endpoint info, ttl and validity
+ * @note generation: incremented every time the element stops describing the same offer
+ *       (endpoint change, StopOffer, expiry, eviction). Bindings compare it to detect stale cached endpoints.
+ * @note expiry: absolute deadline of the offer in the TTL timer wheel of the service manager,
+ *       re-armed by every received offer. Not armed for SI_SD_CONST_TTL_INFINITE.
+ * @note lru_prev, lru_next: registry indices of the neighbours in the LRU list of valid elements
+ *       (most recently offered first), free elements are chained through lru_next.
  */
 struct SD_remote_Service
 {
@@ -66,8 +64,14 @@ struct SD_remote_Service
     uint8  major;                       // major version number
     uint32 minor;                       // minor version number
     struct SD_Endpoint endpoint;        // IP address, port number, protocol type
-    uint32  ttl;                        // [sec]; 0u means "not valid"
+    uint32 peer_ipv4_be;                // SD node that offered the service (network order), see SI_SD_peer.h
+    uint32  ttl;                        // [sec] TTL of the last received offer; 0u means "not valid"
     boolean valid;
+    uint32 generation;
+    struct SI_TIMERWHEEL_node expiry;
+    uint32 expiry_overflow_sec;         // part of TTL beyond the range of the timer wheel, armed when expiry fires
+    uint16 lru_prev;
+    uint16 lru_next;
 };
 
 /**
@@ -104,8 +108,6 @@ struct SD_Context
 
     boolean  reboot_flag;               // set TRUE after boot; clear after a session ID cycle
 
-    uint32   ttl_timebase;
-
     struct SD_TransportHandler_vtable tx_handler;    // function pointer of Transport layer send() function
 
     void *tx_user_ctx;
@@ -118,13 +120,24 @@ struct SD_Context
 boolean SI_SD_PROVIDER_init(struct SD_Context *sd_context, const uint32 local_ipv4_be,
                            const uint16 sd_port_be, const uint32 sd_multicast_ipv4_be,
                            const struct SD_TransportHandler_vtable *tx_handler, void *tx_user_ctx);
-void SI_SD_PROVIDER_received_registry_resolver(void);
+void SI_SD_PROVIDER_apply_offer(const struct SI_SD_ServiceEntry* entry, const struct SI_SD_IPv4EndpointOption* option,
+                                uint32 src_ipv4_be);
+void SI_SD_PROVIDER_remove_peer(uint32 peer_ipv4_be);
+void SI_SD_PROVIDER_announce_services(const struct SI_SD_Watch* watch);
+uint32 SI_SD_PROVIDER_save_snapshot(uint8* buffer, uint32 buffer_size, uint32 now_sec);
+uint32 SI_SD_PROVIDER_load_snapshot(const uint8* buffer, uint32 length, uint32 now_sec);
 struct SD_remote_Service* SI_SD_PROVIDER_lookup_service(uint16 service_id,
                                                               uint16 instance_id,
                                                               uint8 major);
+struct SD_remote_Service* SI_SD_PROVIDER_resolve_service(uint16 service_id, uint16 instance_id, uint8 major,
+                                                         struct SD_Endpoint* out_endpoint, uint32* out_generation);
+void SI_SD_PROVIDER_tick_ms(struct SD_Context *sd_context, const uint32 elapsed_time_ms);
 void SI_SD_PROVIDER_tick(struct SD_Context *sd_context, const uint32 elapsed_time_sec);
-
-boolean SI_SD_PROVIDER_allocate_service__soft(struct SD_remote_Service* to_be_saved, struct SD_remote_Service **allocated_space);
-struct SD_remote_Service* SI_SD_PROVIDER_allocate_service__force(struct SD_remote_Service* to_be_saved);
+struct SD_Context* SI_SD_PROVIDER_get_context(void);
+boolean SI_SD_PROVIDER_send(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be, boolean unicast,
+                            struct SI_SD_PayloadBuilder* payload);
+boolean SI_SD_PROVIDER_serialize(struct SI_SD_PayloadBuilder* payload);
+boolean SI_SD_PROVIDER_send_serialized(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be, boolean unicast,
+                                       uint8* datagram, uint32 length);
 
 #endif /* SI_SD_SERVICE_MANAGER_H_ */
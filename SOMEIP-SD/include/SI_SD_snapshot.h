@@ -0,0 +1,72 @@
+// Include guard starts here
+#ifndef SI_SD_SNAPSHOT_H_
+#define SI_SD_SNAPSHOT_H_
+
+/**
+ * @file    SI_SD_snapshot.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Binary format of the remote service registry snapshot (see SI_SD_PROVIDER_save_snapshot()).
+ *           The snapshot is kept over a restart (e.g. in retained RAM, flash or a file of the host),
+ *           services whose offer has not expired yet are usable right after SI_SD_PROVIDER_load_snapshot().
+ *
+ *           Layout, every field is big endian, addresses and ports are in network order:
+ *           header  [magic:32 | version:16 | record size:16 | record count:32 | checksum of the records:32]
+ *           record  [service ID:16 | instance ID:16 | major:8 | reserved:24 | minor:32 | IPv4 address:32 | port:16 |
+ *                    reserved:16 | offering SD node:32 | absolute expiry [sec]:32]
+ *           Expiry is given in the clock of the caller (e.g. RTC seconds), it has to keep running over the restart."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+
+#include "SI_SD_service_manager.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define SI_SD_SNAPSHOT_MAGIC                (0x53445343u)   // "SDSC"
+#define SI_SD_SNAPSHOT_VERSION              (1u)
+#define SI_SD_SNAPSHOT_HEADER_SIZE          (16u)
+#define SI_SD_SNAPSHOT_RECORD_SIZE          (28u)
+
+/**
+ * Expiry of offers with infinite TTL
+ */
+#define SI_SD_SNAPSHOT_EXPIRY_INFINITE      (0xFFFFFFFFu)
+
+/**
+ * Length of a snapshot of records_num services, SI_SD_SNAPSHOT_SIZE(SI_SD_CFG_MAX_REMOTE_SERVICES) holds the whole registry
+ */
+#define SI_SD_SNAPSHOT_SIZE(records_num)    (SI_SD_SNAPSHOT_HEADER_SIZE + ((records_num) * SI_SD_SNAPSHOT_RECORD_SIZE))
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+struct SI_SD_SNAPSHOT_record
+{
+    uint16 service_id;
+    uint16 instance_id;
+    uint8 major;
+    uint32 minor;
+    struct SD_Endpoint endpoint;        // network order
+    uint32 peer_ipv4_be;                // SD node that offered the service (network order)
+    uint32 expiry_sec;                  // absolute, SI_SD_SNAPSHOT_EXPIRY_INFINITE never expires
+};
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+void SI_SD_SNAPSHOT_write_header(uint8* out_buffer, uint32 records_num);
+boolean SI_SD_SNAPSHOT_read_header(const uint8* buffer, uint32 length, uint32* out_records_num);
+void SI_SD_SNAPSHOT_serialize_record(const struct SI_SD_SNAPSHOT_record* in_record, uint8* out_record);
+void SI_SD_SNAPSHOT_deserialize_record(const uint8* in_record, struct SI_SD_SNAPSHOT_record* out_record);
+
+// Include guard stops here
+#endif // SI_SD_SNAPSHOT_H_
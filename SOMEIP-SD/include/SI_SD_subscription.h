@@ -0,0 +1,87 @@
+// Include guard starts here
+#ifndef SI_SD_SUBSCRIPTION_H_
+#define SI_SD_SUBSCRIPTION_H_
+
+/**
+ * @file    SI_SD_subscription.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Publish/Subscribe handling of SOME/IP Service Discovery.
+ *           Received Subscribe entries are stored in a preallocated subscription table (open addressing,
+ *           key: Service ID, Instance ID, Eventgroup ID and subscriber endpoint), answered with SubscribeAck
+ *           or SubscribeNack and forwarded to the event publisher (SI_event).
+ *           Subscriptions expire when their TTL elapses. Does not allocate heap dynamically."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+
+#include "SI_SD_const.h"
+#include "SI_SD_config.h"
+#include "SI_SD_payload.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/**
+ * TTL value meaning "valid until the next reboot", such subscriptions never expire
+ */
+#define SI_SD_SUBSCRIPTION_TTL_INFINITE     (SI_SD_CONST_TTL_INFINITE)
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+struct SD_Context;
+
+/**
+ * Subscription of a remote node to a local eventgroup.
+ * Key: Service ID, Instance ID, Eventgroup ID and subscriber endpoint.
+ */
+struct SD_Subscription
+{
+    boolean valid;
+    boolean deleted;
+    uint16 service_id;
+    uint16 instance_id;
+    uint16 eventgroup_id;
+    uint32 ipv4_be;             // address of the subscriber (network order)
+    uint16 port;                // port of the subscriber (host order)
+    uint32 peer_ipv4_be;        // SD node that subscribed (network order), see SI_SD_peer.h
+    uint32 ttl;                 // [sec] remaining lifetime, SI_SD_SUBSCRIPTION_TTL_INFINITE never expires
+};
+
+struct SI_SD_SUBSCRIPTION_counters
+{
+    uint32 subscribed;          // number of new subscriptions
+    uint32 renewed;             // number of Subscribe entries refreshing an existing subscription
+    uint32 stopped;             // number of StopSubscribe entries
+    uint32 expired;             // number of subscriptions removed due to TTL
+    uint32 peer_rebooted;       // number of subscriptions removed because the subscriber rebooted
+    uint32 nacked;              // number of rejected Subscribe entries
+    uint32 acks_received;       // number of SubscribeAck entries received (subscriptions of this node)
+    uint32 nacks_received;      // number of SubscribeNack entries received (subscriptions of this node)
+};
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+void SI_SD_SUBSCRIPTION_apply(struct SD_Context *sd_context, const struct SI_SD_EventgroupEntry* entry,
+                              const struct SI_SD_IPv4EndpointOption* option, uint32 src_ipv4_be, uint16 src_port_be,
+                              uint32 peer_ipv4_be);
+struct SD_Subscription* SI_SD_SUBSCRIPTION_find(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4_be, uint16 port);
+boolean SI_SD_SUBSCRIPTION_subscribe(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be,
+                                     uint16 service_id, uint16 instance_id, uint8 major, uint16 eventgroup_id,
+                                     uint32 ttl, uint32 local_ipv4_be, uint16 local_port);
+void SI_SD_SUBSCRIPTION_tick(const uint32 elapsed_time_sec);
+void SI_SD_SUBSCRIPTION_remove_peer(uint32 peer_ipv4_be);
+uint32 SI_SD_SUBSCRIPTION_get_count(void);
+void SI_SD_SUBSCRIPTION_get_counters(struct SI_SD_SUBSCRIPTION_counters* out_counters);
+
+// Include guard stops here
+#endif // SI_SD_SUBSCRIPTION_H_
@@ -0,0 +1,91 @@
+// Include guard starts here
+#ifndef SI_SD_WATCH_H_
+#define SI_SD_WATCH_H_
+
+/**
+ * @file    SI_SD_watch.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Availability notifications of remote service instances, instead of polling SI_SD_PROVIDER_lookup_service().
+ *           A watch selects service instances by Service ID, Instance ID (or any) and major version (or any),
+ *           its callback is called when a selected instance becomes available, unavailable (StopOffer, TTL expiry,
+ *           reboot of the offering node, eviction) or its endpoint changes.
+ *
+ *           A new watch is told about the already available instances at once (from SI_SD_WATCH_add()).
+ *
+ *           Changes of the registry are queued under the registry lock and callbacks are called after it is released
+ *           (from SI_SD_PROCESS_receive() and SI_SD_PROVIDER_tick_ms()), so a callback may use the SD API."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+
+#include "SI_SD_config.h"
+#include "SI_SD_service_manager.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+enum SI_SD_WATCH_Event_t
+{
+    SI_SD_WATCH_Event_AVAILABLE = 0x00u,            // instance is offered
+    SI_SD_WATCH_Event_UNAVAILABLE = 0x01u,          // offer is stopped, expired or removed
+    SI_SD_WATCH_Event_ENDPOINT_CHANGED = 0x02u      // instance is offered on a new endpoint
+};
+
+/**
+ * Copy of the registry element at the time of the change
+ */
+struct SI_SD_WATCH_ServiceInfo
+{
+    uint16 service_id;
+    uint16 instance_id;
+    uint8 major;
+    uint32 minor;
+    struct SD_Endpoint endpoint;        // network order
+};
+
+typedef void (*SI_SD_WATCH_Callback_fptr)(enum SI_SD_WATCH_Event_t event, const struct SI_SD_WATCH_ServiceInfo* info, void* user_data);
+
+struct SI_SD_Watch
+{
+    boolean used;
+    uint16 service_id;
+    uint16 instance_id;                 // SI_SD_CONST_ANY_INSTANCE_ID: any instance
+    uint8 major;                        // SI_SD_CONST_ANY_MAJOR_VERSION: any major version
+    SI_SD_WATCH_Callback_fptr callback;
+    void* user_data;
+};
+
+struct SI_SD_WATCH_counters
+{
+    uint32 events_queued;       // number of registry changes queued for the watches
+    uint32 events_collapsed;    // number of registry changes merged into the queued change of the same instance
+    uint32 events_dropped;      // number of registry changes lost because the queue was full (reported to ERH)
+    uint32 callbacks_called;    // number of callback calls
+};
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+struct SI_SD_Watch* SI_SD_WATCH_add(uint16 service_id, uint16 instance_id, uint8 major,
+                                    SI_SD_WATCH_Callback_fptr callback, void* user_data);
+boolean SI_SD_WATCH_remove(struct SI_SD_Watch* watch);
+void SI_SD_WATCH_get_counters(struct SI_SD_WATCH_counters* out_counters);
+
+// Used by the service manager
+void SI_SD_WATCH_init(void);
+void SI_SD_WATCH_enqueue(enum SI_SD_WATCH_Event_t event, const struct SD_remote_Service* service, const struct SI_SD_Watch* target);
+void SI_SD_WATCH_dispatch(void);
+
+// Include guard stops here
+#endif // SI_SD_WATCH_H_
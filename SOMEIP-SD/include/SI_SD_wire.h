@@ -36,9 +36,17 @@
 
 void SI_SD_WIRE_serialize_header(const struct SD_Header* in_header, uint8* out_header);
 void SI_SD_WIRE_deserialize_header(const uint8* in_header, struct SD_Header* out_header);
+void SI_SD_WIRE_patch_header(uint8* header, uint16 session_id, uint32 preamble);
 
 void SI_SD_WIRE_deserialize_ServiceEntry(uint8 *in_entry, struct SI_SD_ServiceEntry *out_entry);
+void SI_SD_WIRE_serialize_ServiceEntry(const struct SI_SD_ServiceEntry *in_entry, uint8 *out_entry);
+void SI_SD_WIRE_deserialize_option_header(uint8 *in_option, uint16 *out_length, uint8 *out_type, boolean *out_discardable);
 void SI_SD_WIRE_deserialize_IPv4EndpointOption(uint8 *in_option, struct SI_SD_IPv4EndpointOption *out_option);
+void SI_SD_WIRE_deserialize_IPv6EndpointOption(uint8 *in_option, struct SI_SD_IPv6EndpointOption *out_option);
+void SI_SD_WIRE_deserialize_LoadBalancingOption(uint8 *in_option, struct SI_SD_LoadBalancingOption *out_option);
+void SI_SD_WIRE_deserialize_EventgroupEntry(uint8 *in_entry, struct SI_SD_EventgroupEntry *out_entry);
+void SI_SD_WIRE_serialize_EventgroupEntry(const struct SI_SD_EventgroupEntry *in_entry, uint8 *out_entry);
+void SI_SD_WIRE_serialize_IPv4EndpointOption(const struct SI_SD_IPv4EndpointOption *in_option, uint8 *out_option);
 
 /* **************************************************** */
 /*               Function definitions                   */
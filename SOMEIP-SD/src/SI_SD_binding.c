@@ -0,0 +1,131 @@
+/**
+ * @file    SI_SD_binding.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_SD_binding.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_SD_binding.h"
+
+#include "lwip/def.h"       // for lwip_ntohs
+#include "SI_types.h"
+#include "SI_client.h"
+
+#include "SI_SD_service_manager.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static inline boolean SI_SD_BINDING_is_fresh(const struct SI_SD_Binding* binding);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+void SI_SD_BINDING_init(struct SI_SD_Binding* binding, uint16 service_id, uint16 instance_id, uint8 major)
+{
+    if (NULLPTR == binding)
+    {
+        return;
+    }
+
+    binding->service_id = service_id;
+    binding->instance_id = instance_id;
+    binding->major = major;
+    binding->service = NULLPTR;
+    binding->generation = 0u;
+    binding->endpoint.ipv4_be = 0u;
+    binding->endpoint.port_be = 0u;
+}
+
+/**
+ * Returns the offered endpoint of the bound service instance.
+ * Registry is searched only at the first call and after the offer changed or expired.
+ *
+ * @returns pointer for cached endpoint, NULLPTR if service instance is not offered
+ */
+const struct SD_Endpoint* SI_SD_BINDING_resolve(struct SI_SD_Binding* binding)
+{
+    if (NULLPTR == binding)
+    {
+        return NULLPTR;
+    }
+
+    if (TRUE == SI_SD_BINDING_is_fresh(binding))
+    {
+        return &(binding->endpoint);
+    }
+
+    binding->service = SI_SD_PROVIDER_resolve_service(binding->service_id, binding->instance_id, binding->major,
+                                                      &(binding->endpoint), &(binding->generation));
+    if (NULLPTR == binding->service)
+    {
+        return NULLPTR;
+    }
+    return &(binding->endpoint);
+}
+
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+/**
+ * Sends a request to the bound service instance, see SI_CLIENT_request().
+ * Destination of params is replaced by the resolved endpoint.
+ *
+ * @returns TRUE if request is sent, FALSE if service instance is not offered or sending failed
+ */
+boolean SI_SD_BINDING_request(struct SI_SD_Binding* binding, const struct SI_CLIENT_RequestParams* params,
+                              const uint8* payload, uint32 payload_length,
+                              SI_CLIENT_ResponseCallback_fptr callback, void* user_data, uint16* out_session_id)
+{
+    const struct SD_Endpoint* endpoint = SI_SD_BINDING_resolve(binding);
+    struct SI_CLIENT_RequestParams resolved_params;
+
+    if ((NULLPTR == endpoint) || (NULLPTR == params))
+    {
+        return FALSE;
+    }
+
+    resolved_params = *params;
+    resolved_params.dst_ipv4 = endpoint->ipv4_be;
+    resolved_params.dst_port = lwip_ntohs(endpoint->port_be);
+    resolved_params.service_id = binding->service_id;
+
+    return SI_CLIENT_request(&resolved_params, payload, payload_length, callback, user_data, out_session_id);
+}
+#endif
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+/**
+ * Cached endpoint is valid while the registry element describes the same offer
+ */
+static inline boolean SI_SD_BINDING_is_fresh(const struct SI_SD_Binding* binding)
+{
+    return ((NULLPTR != binding->service) &&
+            (TRUE == binding->service->valid) &&
+            (binding->generation == binding->service->generation));
+}
+
+/* END OF SI_SD_BINDING.C FILE */
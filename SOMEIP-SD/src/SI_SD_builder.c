@@ -0,0 +1,270 @@
+/**
+ * @file    SI_SD_builder.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_SD_builder.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_SD_builder.h"
+
+#include "SI_types.h"
+#include "SI_const.h"
+#include "SI_endian.h"
+#include "SI_message.h"
+
+#include "SI_SD_const.h"
+#include "SI_SD_message.h"
+#include "SI_SD_wire.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static boolean SI_SD_BUILDER_option_equals(const struct SI_SD_IPv4EndpointOption* a, const struct SI_SD_IPv4EndpointOption* b);
+static boolean SI_SD_BUILDER_reserve_option(struct SI_SD_PayloadBuilder* builder, const struct SI_SD_IPv4EndpointOption* option,
+                                            uint8* out_index);
+static boolean SI_SD_BUILDER_put_entry(struct SI_SD_PayloadBuilder* builder, const uint8* entry, const struct SI_SD_IPv4EndpointOption* option);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Allocates a Tx buffer and reserves the SD preamble and the "Length of Entries Array" field.
+ *
+ * @returns TRUE if Tx buffer is allocated
+ */
+boolean SI_SD_BUILDER_init(struct SI_SD_PayloadBuilder* builder)
+{
+    const uint8 placeholder[SI_SD_CONST_ENTRIES_ARRAY_LENGTH_SIZE] = {0u};
+
+    if ((NULLPTR == builder) || (FALSE == SI_SD_MESSAGE_init(&(builder->message))))
+    {
+        return FALSE;
+    }
+
+    builder->entries_length_offset = builder->message.cursor;
+    builder->entries_num = 0u;
+    builder->options_num = 0u;
+    builder->closed = FALSE;
+
+    return SI_SD_MESSAGE_put(&(builder->message), placeholder, SI_SD_CONST_ENTRIES_ARRAY_LENGTH_SIZE);
+}
+
+/**
+ * Adds a Service Entry (Find / Offer / StopOffer) referencing the given option in its 1st option run.
+ * Option run fields of entry are overwritten.
+ *
+ * @param option (optional): endpoint of the service. If not needed give NULLPTR.
+ *
+ * @returns FALSE if entry does not fit into the datagram: send the built message, then continue with a new one
+ */
+boolean SI_SD_BUILDER_add_service_entry(struct SI_SD_PayloadBuilder* builder, const struct SI_SD_ServiceEntry* entry,
+                                        const struct SI_SD_IPv4EndpointOption* option)
+{
+    struct SI_SD_ServiceEntry placed;
+    uint8 serialized[SI_SD_CONST_ENTRY_ARRAY_SIZE];
+    uint8 option_index = 0u;
+
+    if ((NULLPTR == builder) || (NULLPTR == entry) || (TRUE == builder->closed) ||
+        ((NULLPTR != option) && (FALSE == SI_SD_BUILDER_reserve_option(builder, option, &option_index))))
+    {
+        return FALSE;
+    }
+
+    placed = *entry;
+    placed.index_1st_option_run = option_index;
+    placed.index_2nd_option_run = 0u;
+    placed.number_of_options1 = (NULLPTR != option) ? (1u) : (0u);
+    placed.number_of_options2 = 0u;
+    SI_SD_WIRE_serialize_ServiceEntry(&placed, serialized);
+
+    return SI_SD_BUILDER_put_entry(builder, serialized, option);
+}
+
+/**
+ * Adds an Eventgroup Entry (Subscribe / SubscribeAck) referencing the given option in its 1st option run.
+ * Option run fields of entry are overwritten.
+ *
+ * @param option (optional): endpoint or multicast option. If not needed give NULLPTR.
+ *
+ * @returns FALSE if entry does not fit into the datagram: send the built message, then continue with a new one
+ */
+boolean SI_SD_BUILDER_add_eventgroup_entry(struct SI_SD_PayloadBuilder* builder, const struct SI_SD_EventgroupEntry* entry,
+                                           const struct SI_SD_IPv4EndpointOption* option)
+{
+    struct SI_SD_EventgroupEntry placed;
+    uint8 serialized[SI_SD_CONST_ENTRY_ARRAY_SIZE];
+    uint8 option_index = 0u;
+
+    if ((NULLPTR == builder) || (NULLPTR == entry) || (TRUE == builder->closed) ||
+        ((NULLPTR != option) && (FALSE == SI_SD_BUILDER_reserve_option(builder, option, &option_index))))
+    {
+        return FALSE;
+    }
+
+    placed = *entry;
+    placed.index_1st_option_run = option_index;
+    placed.index_2nd_option_run = 0u;
+    placed.number_of_options1 = (NULLPTR != option) ? (1u) : (0u);
+    placed.number_of_options2 = 0u;
+    SI_SD_WIRE_serialize_EventgroupEntry(&placed, serialized);
+
+    return SI_SD_BUILDER_put_entry(builder, serialized, option);
+}
+
+/**
+ * Completes the entries array and appends the options array. No entry can be added afterwards.
+ *
+ * @returns TRUE if payload is complete
+ */
+boolean SI_SD_BUILDER_close(struct SI_SD_PayloadBuilder* builder)
+{
+    uint32 i = 0u;
+    uint8 serialized[SI_SD_CONST_OPTION_ARRAY_SIZE];
+
+    if (NULLPTR == builder)
+    {
+        return FALSE;
+    }
+
+    if (TRUE == builder->closed)
+    {
+        return TRUE;
+    }
+
+    u32_to_u8array(&(builder->message.data[builder->entries_length_offset]), (builder->entries_num * SI_SD_CONST_ENTRY_ARRAY_SIZE));
+
+    u32_to_u8array(serialized, (builder->options_num * SI_SD_CONST_OPTION_ARRAY_SIZE));
+    if (FALSE == SI_SD_MESSAGE_put(&(builder->message), serialized, SI_SD_CONST_OPTIONS_ARRAY_LENGTH_SIZE))
+    {
+        return FALSE;
+    }
+
+    for (i = 0u; i < builder->options_num; i++)
+    {
+        SI_SD_WIRE_serialize_IPv4EndpointOption(&(builder->options[i]), serialized);
+        if (FALSE == SI_SD_MESSAGE_put(&(builder->message), serialized, SI_SD_CONST_OPTION_ARRAY_SIZE))
+        {
+            return FALSE;
+        }
+    }
+
+    builder->closed = TRUE;
+    return TRUE;
+}
+
+boolean SI_SD_BUILDER_is_empty(const struct SI_SD_PayloadBuilder* builder)
+{
+    return ((NULLPTR == builder) || (0u == builder->entries_num));
+}
+
+/**
+ * Releases the Tx buffer
+ */
+boolean SI_SD_BUILDER_invalidate(struct SI_SD_PayloadBuilder* builder)
+{
+    if (NULLPTR == builder)
+    {
+        return FALSE;
+    }
+
+    builder->entries_num = 0u;
+    builder->options_num = 0u;
+    builder->closed = FALSE;
+    return SI_SD_MESSAGE_invalidate(&(builder->message));
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static boolean SI_SD_BUILDER_option_equals(const struct SI_SD_IPv4EndpointOption* a, const struct SI_SD_IPv4EndpointOption* b)
+{
+    return ((a->type == b->type) && (a->length == b->length) && (a->discardable_flag == b->discardable_flag) &&
+            (a->IPv4_address == b->IPv4_address) && (a->l4_proto == b->l4_proto) && (a->port_number == b->port_number));
+}
+
+/**
+ * @param out_index: index of the identical option already in the payload, or the index the option is going to get
+ *
+ * @returns FALSE if a new option is needed but there is no free place for it
+ */
+static boolean SI_SD_BUILDER_reserve_option(struct SI_SD_PayloadBuilder* builder, const struct SI_SD_IPv4EndpointOption* option,
+                                            uint8* out_index)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < builder->options_num; i++)
+    {
+        if (TRUE == SI_SD_BUILDER_option_equals(option, &(builder->options[i])))
+        {
+            *out_index = (uint8)i;
+            return TRUE;
+        }
+    }
+
+    if (SI_SD_CFG_BUILDER_MAX_OPTIONS <= builder->options_num)
+    {
+        return FALSE;
+    }
+
+    *out_index = (uint8)builder->options_num;
+    return TRUE;
+}
+
+/**
+ * Writes the serialised entry into the Tx buffer if the entry, a possibly new option and the options array
+ * still fit under the MTU. Option is stored only if it is not in the payload yet.
+ */
+static boolean SI_SD_BUILDER_put_entry(struct SI_SD_PayloadBuilder* builder, const uint8* entry, const struct SI_SD_IPv4EndpointOption* option)
+{
+    uint8 option_index = 0u;
+    boolean new_option = FALSE;
+    uint32 needed = 0u;
+    const uint32 limit = (builder->message.cap < SI_CONST_UDP_MTU_LENGTH) ? (builder->message.cap) : (SI_CONST_UDP_MTU_LENGTH);
+
+    if (NULLPTR != option)
+    {
+        (void)SI_SD_BUILDER_reserve_option(builder, option, &option_index);
+        new_option = (option_index == builder->options_num);
+    }
+
+    needed = builder->message.cursor + SI_SD_CONST_ENTRY_ARRAY_SIZE + SI_SD_CONST_OPTIONS_ARRAY_LENGTH_SIZE +
+             ((builder->options_num + ((TRUE == new_option) ? (1u) : (0u))) * SI_SD_CONST_OPTION_ARRAY_SIZE);
+
+    if ((limit < needed) || (FALSE == SI_SD_MESSAGE_put(&(builder->message), entry, SI_SD_CONST_ENTRY_ARRAY_SIZE)))
+    {
+        return FALSE;
+    }
+
+    if (TRUE == new_option)
+    {
+        builder->options[builder->options_num] = *option;
+        builder->options_num += 1u;
+    }
+    builder->entries_num += 1u;
+    return TRUE;
+}
+
+/* END OF SI_SD_BUILDER.C FILE */
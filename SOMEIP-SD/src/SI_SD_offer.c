@@ -0,0 +1,764 @@
+/**
+ * @file    SI_SD_offer.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_SD_offer.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_SD_offer.h"
+
+#include <assert.h>
+#include <string.h>         // for memcpy
+
+#include "lwip/def.h"       // for lwip_ntohl, lwip_ntohs
+#include "SI_types.h"
+#include "SI_const.h"
+#include "SI_hash.h"
+
+#include "SI_SD_const.h"
+#include "SI_SD_config.h"
+#include "SI_SD_payload.h"
+#include "SI_SD_builder.h"
+#include "SI_SD_service_manager.h"
+
+static_assert(SI_SD_CFG_REQUEST_RESPONSE_DELAY_MIN_MS <= SI_SD_CFG_REQUEST_RESPONSE_DELAY_MAX_MS, "FATAL ERROR: SI_SD_CFG_REQUEST_RESPONSE_DELAY_MIN_MS is bigger than SI_SD_CFG_REQUEST_RESPONSE_DELAY_MAX_MS!");
+static_assert(SI_SD_CFG_INITIAL_DELAY_MIN_MS <= SI_SD_CFG_INITIAL_DELAY_MAX_MS, "FATAL ERROR: SI_SD_CFG_INITIAL_DELAY_MIN_MS is bigger than SI_SD_CFG_INITIAL_DELAY_MAX_MS!");
+static_assert((SI_SD_CFG_OFFER_TTL * 1000u) > SI_SD_CFG_CYCLIC_OFFER_DELAY_MS, "FATAL ERROR: offers expire before the next cyclic offer, SI_SD_CFG_OFFER_TTL is too short!");
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/**
+ * Offers fitting into one cyclic datagram in the worst case, when no option is shared
+ */
+#define SI_SD_OFFER_CYCLIC_OFFERS_PER_DATAGRAM_MIN  (((SI_CONST_UDP_MTU_LENGTH - SI_SD_CONST_HEADER_LENGTH) / \
+                                                      (SI_SD_CONST_ENTRY_ARRAY_SIZE + SI_SD_CONST_OPTION_ARRAY_SIZE)) < SI_SD_CFG_BUILDER_MAX_OPTIONS ? \
+                                                     ((SI_CONST_UDP_MTU_LENGTH - SI_SD_CONST_HEADER_LENGTH) / \
+                                                      (SI_SD_CONST_ENTRY_ARRAY_SIZE + SI_SD_CONST_OPTION_ARRAY_SIZE)) : SI_SD_CFG_BUILDER_MAX_OPTIONS)
+
+/**
+ * Number of datagrams the cyclic offers of all local services need in the worst case
+ */
+#define SI_SD_OFFER_CYCLIC_DATAGRAMS_MAX            ((SI_SD_CFG_MAX_LOCAL_SERVICES + SI_SD_OFFER_CYCLIC_OFFERS_PER_DATAGRAM_MIN - 1u) / \
+                                                     SI_SD_OFFER_CYCLIC_OFFERS_PER_DATAGRAM_MIN)
+
+static_assert(0u < SI_SD_OFFER_CYCLIC_OFFERS_PER_DATAGRAM_MIN, "FATAL ERROR: an offer does not fit into a datagram!");
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/**
+ * One pre-serialised datagram of the cyclic offers
+ */
+struct SI_SD_OFFER_cyclic_datagram
+{
+    uint8 data[SI_CONST_UDP_MTU_LENGTH];
+    uint32 length;
+    uint32 offers_num;          // number of OfferService entries in data
+};
+
+/**
+ * Services in Main Phase share the cyclic offer timer and the pre-serialised datagrams.
+ * Before each send only the session ID and the flags are patched, the datagrams are rebuilt
+ * only if the set of services in Main Phase changed.
+ */
+struct SI_SD_OFFER_cyclic_cache
+{
+    struct SI_SD_OFFER_cyclic_datagram datagrams[SI_SD_OFFER_CYCLIC_DATAGRAMS_MAX];
+    uint32 datagrams_num;
+    boolean valid;              // FALSE: datagrams have to be rebuilt before the next send
+    uint32 remaining_ms;        // time until the next cyclic offer
+};
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SI_SD_OFFER_service g_services[SI_SD_CFG_MAX_LOCAL_SERVICES];
+static struct SI_SD_OFFER_counters g_counters;
+static uint32 g_random_state = 0u;
+
+// Multicast offers due at the same time are packed into as few datagrams as possible
+static struct SI_SD_PayloadBuilder g_batch;
+static boolean g_batch_active = FALSE;
+static uint32 g_batch_offers = 0u;
+static uint32 g_batch_stop_offers = 0u;
+
+static struct SI_SD_OFFER_cyclic_cache g_cyclic;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static uint32 SI_SD_OFFER_random_delay(const struct SD_Context *sd_context, uint32 min_ms, uint32 max_ms);
+static boolean SI_SD_OFFER_find_matches(const struct SI_SD_OFFER_service* service, const struct SI_SD_ServiceEntry* find);
+static void SI_SD_OFFER_send_answer(struct SI_SD_OFFER_service* service);
+static boolean SI_SD_OFFER_create_entry(const struct SI_SD_OFFER_service* service, uint32 ttl,
+                                        struct SI_SD_ServiceEntry* out_entry, struct SI_SD_IPv4EndpointOption* out_option);
+static void SI_SD_OFFER_batch_add(struct SD_Context *sd_context, const struct SI_SD_OFFER_service* service, uint32 ttl);
+static void SI_SD_OFFER_batch_flush(struct SD_Context *sd_context);
+static void SI_SD_OFFER_stop_service(struct SD_Context *sd_context, struct SI_SD_OFFER_service* service);
+static boolean SI_SD_OFFER_main_phase_running(void);
+static void SI_SD_OFFER_enter_main_phase(struct SI_SD_OFFER_service* service);
+static boolean SI_SD_OFFER_store_cyclic(struct SI_SD_PayloadBuilder* payload, uint32 offers_num);
+static boolean SI_SD_OFFER_build_cyclic(void);
+static void SI_SD_OFFER_send_cyclic(struct SD_Context *sd_context);
+static void SI_SD_OFFER_timer_expired(struct SD_Context *sd_context, struct SI_SD_OFFER_service* service);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Registers a local service instance, it is not offered until SI_SD_OFFER_start() is called.
+ *
+ * @param ipv4_be: address of the service instance (network order)
+ * @param port_be: UDP port of the service instance (network order)
+ *
+ * @returns handle of the service, NULLPTR if it is already registered or there is no free element
+ */
+struct SI_SD_OFFER_service* SI_SD_OFFER_add(uint16 service_id, uint16 instance_id, uint8 major, uint32 minor,
+                                            uint32 ipv4_be, uint16 port_be)
+{
+    uint32 i = 0u;
+
+    if (NULLPTR != SI_SD_OFFER_find(service_id, instance_id))
+    {
+        return NULLPTR;
+    }
+
+    for (i = 0u; i < SI_SD_CFG_MAX_LOCAL_SERVICES; i++)
+    {
+        if (FALSE == g_services[i].used)
+        {
+            g_services[i].used = TRUE;
+            g_services[i].service_id = service_id;
+            g_services[i].instance_id = instance_id;
+            g_services[i].major = major;
+            g_services[i].minor = minor;
+            g_services[i].endpoint.ipv4_be = ipv4_be;
+            g_services[i].endpoint.port_be = port_be;
+            g_services[i].state = SI_SD_OFFER_State_DOWN;
+            g_services[i].remaining_ms = 0u;
+            g_services[i].repetition_delay_ms = 0u;
+            g_services[i].repetitions = 0u;
+            g_services[i].answer_pending = FALSE;
+            g_services[i].answer_context = NULLPTR;
+            return &(g_services[i]);
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * @returns registered local service instance, NULLPTR if there is none
+ */
+struct SI_SD_OFFER_service* SI_SD_OFFER_find(uint16 service_id, uint16 instance_id)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_SD_CFG_MAX_LOCAL_SERVICES; i++)
+    {
+        if ((TRUE == g_services[i].used) && (service_id == g_services[i].service_id) && (instance_id == g_services[i].instance_id))
+        {
+            return &(g_services[i]);
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * Service instance becomes available: Initial Wait Phase starts.
+ *
+ * @returns TRUE if state machine is started (or it is already running)
+ */
+boolean SI_SD_OFFER_start(struct SD_Context *sd_context, struct SI_SD_OFFER_service* service)
+{
+    if ((NULLPTR == sd_context) || (NULLPTR == service) || (FALSE == service->used))
+    {
+        return FALSE;
+    }
+
+    SI_SD_CFG_OFFER_LOCK();
+    if (SI_SD_OFFER_State_DOWN == service->state)
+    {
+        service->state = SI_SD_OFFER_State_INITIAL_WAIT;
+        service->remaining_ms = SI_SD_OFFER_random_delay(sd_context, SI_SD_CFG_INITIAL_DELAY_MIN_MS, SI_SD_CFG_INITIAL_DELAY_MAX_MS);
+        service->repetitions = 0u;
+    }
+    SI_SD_CFG_OFFER_UNLOCK();
+    return TRUE;
+}
+
+/**
+ * Service instance becomes unavailable. StopOffer is sent if the service was offered already.
+ *
+ * @returns TRUE if service is stopped
+ */
+boolean SI_SD_OFFER_stop(struct SD_Context *sd_context, struct SI_SD_OFFER_service* service)
+{
+    if ((NULLPTR == sd_context) || (NULLPTR == service) || (FALSE == service->used))
+    {
+        return FALSE;
+    }
+
+    SI_SD_CFG_OFFER_LOCK();
+    SI_SD_OFFER_stop_service(sd_context, service);
+    SI_SD_OFFER_batch_flush(sd_context);
+    SI_SD_CFG_OFFER_UNLOCK();
+    return TRUE;
+}
+
+/**
+ * Stops every offered service instance, StopOffer entries are packed together.
+ * @note Call this before the node shuts down, remote nodes drop the services at once instead of waiting for TTL.
+ */
+void SI_SD_OFFER_shutdown(struct SD_Context *sd_context)
+{
+    uint32 i = 0u;
+
+    if (NULLPTR == sd_context)
+    {
+        return;
+    }
+
+    SI_SD_CFG_OFFER_LOCK();
+    for (i = 0u; i < SI_SD_CFG_MAX_LOCAL_SERVICES; i++)
+    {
+        if (TRUE == g_services[i].used)
+        {
+            SI_SD_OFFER_stop_service(sd_context, &(g_services[i]));
+        }
+    }
+    SI_SD_OFFER_batch_flush(sd_context);
+    SI_SD_CFG_OFFER_UNLOCK();
+}
+
+/**
+ * Sends an OfferService entry (StopOfferService if ttl is 0) of the service instance.
+ *
+ * @param dst_ipv4_be: destination address (network order)
+ * @param dst_port_be: destination port (network order)
+ * @param unicast: TRUE if offer is sent to a single node
+ * @param ttl: [sec] lifetime of the offer
+ *
+ * @returns TRUE if message is sent
+ */
+boolean SI_SD_OFFER_send(struct SD_Context *sd_context, const struct SI_SD_OFFER_service* service,
+                         uint32 dst_ipv4_be, uint16 dst_port_be, boolean unicast, uint32 ttl)
+{
+    boolean sent = FALSE;
+    struct SI_SD_ServiceEntry entry;
+    struct SI_SD_IPv4EndpointOption option;
+    struct SI_SD_PayloadBuilder payload;
+
+    if ((NULLPTR == service) || (FALSE == SI_SD_OFFER_create_entry(service, ttl, &entry, &option)) ||
+        (FALSE == SI_SD_BUILDER_init(&payload)))
+    {
+        return FALSE;
+    }
+
+    if (TRUE == SI_SD_BUILDER_add_service_entry(&payload, &entry, &option))
+    {
+        sent = SI_SD_PROVIDER_send(sd_context, dst_ipv4_be, dst_port_be, unicast, &payload);
+    }
+    (void)SI_SD_BUILDER_invalidate(&payload);
+
+    if (FALSE == sent)
+    {
+        g_counters.tx_failed += 1u;
+        return FALSE;
+    }
+
+    if (0u == ttl)
+    {
+        g_counters.stop_offers_sent += 1u;
+    }
+    else
+    {
+        g_counters.offers_sent += 1u;
+    }
+    return TRUE;
+}
+
+/**
+ * Answers a FindService entry: every matching offered service instance sends an offer after the request-response delay.
+ * Services in Initial Wait Phase do not answer, their first offer is sent soon anyway.
+ *
+ * @param src_ipv4_be: address of the requester (network order)
+ * @param src_port_be: SD port of the requester (network order)
+ * @param unicast: unicast flag of the received message. If it is not set, the answer is sent to the SD multicast group.
+ */
+void SI_SD_OFFER_answer_find(struct SD_Context *sd_context, const struct SI_SD_ServiceEntry* find,
+                             uint32 src_ipv4_be, uint16 src_port_be, boolean unicast)
+{
+    uint32 i = 0u;
+    struct SI_SD_OFFER_service* service = NULLPTR;
+
+    if ((NULLPTR == sd_context) || (NULLPTR == find))
+    {
+        return;
+    }
+
+    SI_SD_CFG_OFFER_LOCK();
+    for (i = 0u; i < SI_SD_CFG_MAX_LOCAL_SERVICES; i++)
+    {
+        service = &(g_services[i]);
+
+        if ((FALSE == service->used) ||
+            ((SI_SD_OFFER_State_REPETITION != service->state) && (SI_SD_OFFER_State_MAIN != service->state)) ||
+            (FALSE == SI_SD_OFFER_find_matches(service, find)))
+        {
+            continue;
+        }
+
+        if ((TRUE == service->answer_pending) && (sd_context != service->answer_context))
+        {
+            // Answer of another SD instance (interface) is scheduled: send it now, the new requester gets its own
+            SI_SD_OFFER_send_answer(service);
+        }
+
+        if (TRUE == service->answer_pending)
+        {
+            // Answer is already scheduled: requesters are served together through the multicast group
+            if ((FALSE == unicast) || (src_ipv4_be != service->answer_ipv4_be) || (src_port_be != service->answer_port_be))
+            {
+                service->answer_unicast = FALSE;
+            }
+            g_counters.finds_merged += 1u;
+            continue;
+        }
+
+        service->answer_pending = TRUE;
+        service->answer_context = sd_context;
+        service->answer_ipv4_be = src_ipv4_be;
+        service->answer_port_be = src_port_be;
+        service->answer_unicast = unicast;
+        service->answer_remaining_ms = SI_SD_OFFER_random_delay(sd_context, SI_SD_CFG_REQUEST_RESPONSE_DELAY_MIN_MS,
+                                                                SI_SD_CFG_REQUEST_RESPONSE_DELAY_MAX_MS);
+        if (0u == service->answer_remaining_ms)
+        {
+            SI_SD_OFFER_send_answer(service);
+        }
+    }
+    SI_SD_CFG_OFFER_UNLOCK();
+}
+
+/**
+ * Timekeeping: sends the offers that are due. Offers of the same tick share datagrams,
+ * cyclic offers of the Main Phase are sent from the pre-serialised datagram.
+ * Answers of FindService entries are sent through the SD instance they were received on.
+ * @note Called by SI_SD_PROVIDER_tick_ms().
+ *
+ * @param sd_context: SD instance offers are sent through
+ */
+void SI_SD_OFFER_tick(struct SD_Context *sd_context, const uint32 elapsed_time_ms)
+{
+    uint32 i = 0u;
+    struct SI_SD_OFFER_service* service = NULLPTR;
+
+    SI_SD_CFG_OFFER_LOCK();
+    if ((0u < SI_SD_CFG_CYCLIC_OFFER_DELAY_MS) && (TRUE == SI_SD_OFFER_main_phase_running()))
+    {
+        if (elapsed_time_ms < g_cyclic.remaining_ms)
+        {
+            g_cyclic.remaining_ms -= elapsed_time_ms;
+        }
+        else
+        {
+            g_cyclic.remaining_ms = SI_SD_CFG_CYCLIC_OFFER_DELAY_MS;
+            SI_SD_OFFER_send_cyclic(sd_context);
+        }
+    }
+
+    for (i = 0u; i < SI_SD_CFG_MAX_LOCAL_SERVICES; i++)
+    {
+        service = &(g_services[i]);
+
+        if (TRUE == service->answer_pending)
+        {
+            if (elapsed_time_ms < service->answer_remaining_ms)
+            {
+                service->answer_remaining_ms -= elapsed_time_ms;
+            }
+            else
+            {
+                SI_SD_OFFER_send_answer(service);
+            }
+        }
+
+        if ((FALSE == service->used) || (SI_SD_OFFER_State_DOWN == service->state) || (SI_SD_OFFER_State_MAIN == service->state))
+        {
+            continue;
+        }
+
+        if (elapsed_time_ms < service->remaining_ms)
+        {
+            service->remaining_ms -= elapsed_time_ms;
+        }
+        else
+        {
+            SI_SD_OFFER_timer_expired(sd_context, service);
+        }
+    }
+
+    SI_SD_OFFER_batch_flush(sd_context);
+    SI_SD_CFG_OFFER_UNLOCK();
+}
+
+void SI_SD_OFFER_get_counters(struct SI_SD_OFFER_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+/**
+ * @returns random delay between min_ms and max_ms [ms]. Seeded with the local address, so nodes powered on
+ *          at the same time get different delays.
+ */
+static uint32 SI_SD_OFFER_random_delay(const struct SD_Context *sd_context, uint32 min_ms, uint32 max_ms)
+{
+    const uint32 range = (max_ms - min_ms + 1u);
+
+    g_random_state = SI_HASH_combine(g_random_state, sd_context->local_ipv4_be);
+    return (min_ms + (g_random_state % range));
+}
+
+/**
+ * Find entries may use wildcards for Instance ID, major and minor version
+ */
+static boolean SI_SD_OFFER_find_matches(const struct SI_SD_OFFER_service* service, const struct SI_SD_ServiceEntry* find)
+{
+    return ((find->serviceID == service->service_id) &&
+            ((SI_SD_CONST_ANY_INSTANCE_ID == find->instanceID) || (find->instanceID == service->instance_id)) &&
+            ((SI_SD_CONST_ANY_MAJOR_VERSION == find->major_version) || (find->major_version == service->major)) &&
+            ((SI_SD_CONST_ANY_MINOR_VERSION == find->minor_version) || (find->minor_version == service->minor)));
+}
+
+/**
+ * Sends the scheduled answer through the SD instance the FindService entry was received on
+ */
+static void SI_SD_OFFER_send_answer(struct SI_SD_OFFER_service* service)
+{
+    struct SD_Context *sd_context = service->answer_context;
+    boolean sent = FALSE;
+
+    service->answer_pending = FALSE;
+
+    if (TRUE == service->answer_unicast)
+    {
+        sent = SI_SD_OFFER_send(sd_context, service, service->answer_ipv4_be, service->answer_port_be, TRUE, SI_SD_CFG_OFFER_TTL);
+    }
+    else
+    {
+        sent = SI_SD_OFFER_send(sd_context, service, sd_context->multicast_ipv4_be, sd_context->sd_port_be, FALSE, SI_SD_CFG_OFFER_TTL);
+    }
+
+    if (TRUE == sent)
+    {
+        g_counters.finds_answered += 1u;
+    }
+}
+
+static boolean SI_SD_OFFER_create_entry(const struct SI_SD_OFFER_service* service, uint32 ttl,
+                                        struct SI_SD_ServiceEntry* out_entry, struct SI_SD_IPv4EndpointOption* out_option)
+{
+    return ((TRUE == SI_SD_PAYLOAD_create_single_entry(SD_EntryTypes_Offer, 0u, 0u, 1u, 0u, service->service_id, service->instance_id,
+                                                       service->major, ttl, service->minor, out_entry)) &&
+            (TRUE == SI_SD_PAYLOAD_create_option(SI_SD_CONST_IPV4_OPTION_LENGTH, SD_OptionTypes_IPV4_ENDPOINT, FALSE,
+                                                 lwip_ntohl(service->endpoint.ipv4_be), SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP,
+                                                 lwip_ntohs(service->endpoint.port_be), out_option)));
+}
+
+/**
+ * Adds an offer (StopOffer if ttl is 0) to the multicast batch. A full datagram is sent and a new one is started.
+ */
+static void SI_SD_OFFER_batch_add(struct SD_Context *sd_context, const struct SI_SD_OFFER_service* service, uint32 ttl)
+{
+    struct SI_SD_ServiceEntry entry;
+    struct SI_SD_IPv4EndpointOption option;
+
+    if (FALSE == SI_SD_OFFER_create_entry(service, ttl, &entry, &option))
+    {
+        return;
+    }
+
+    if ((TRUE == g_batch_active) && (FALSE == SI_SD_BUILDER_add_service_entry(&g_batch, &entry, &option)))
+    {
+        // datagram is full
+        SI_SD_OFFER_batch_flush(sd_context);
+    }
+
+    if (FALSE == g_batch_active)
+    {
+        if ((FALSE == SI_SD_BUILDER_init(&g_batch)) || (FALSE == SI_SD_BUILDER_add_service_entry(&g_batch, &entry, &option)))
+        {
+            (void)SI_SD_BUILDER_invalidate(&g_batch);
+            g_counters.tx_failed += 1u;
+            return;
+        }
+        g_batch_active = TRUE;
+    }
+
+    if (0u == ttl)
+    {
+        g_batch_stop_offers += 1u;
+    }
+    else
+    {
+        g_batch_offers += 1u;
+    }
+}
+
+/**
+ * Sends the batched offers to the SD multicast group
+ */
+static void SI_SD_OFFER_batch_flush(struct SD_Context *sd_context)
+{
+    if (FALSE == g_batch_active)
+    {
+        return;
+    }
+
+    if (TRUE == SI_SD_PROVIDER_send(sd_context, sd_context->multicast_ipv4_be, sd_context->sd_port_be, FALSE, &g_batch))
+    {
+        g_counters.offers_sent += g_batch_offers;
+        g_counters.stop_offers_sent += g_batch_stop_offers;
+    }
+    else
+    {
+        g_counters.tx_failed += 1u;
+    }
+
+    (void)SI_SD_BUILDER_invalidate(&g_batch);
+    g_batch_active = FALSE;
+    g_batch_offers = 0u;
+    g_batch_stop_offers = 0u;
+}
+
+/**
+ * StopOffer is batched if the service was offered already
+ */
+static void SI_SD_OFFER_stop_service(struct SD_Context *sd_context, struct SI_SD_OFFER_service* service)
+{
+    if ((SI_SD_OFFER_State_REPETITION == service->state) || (SI_SD_OFFER_State_MAIN == service->state))
+    {
+        SI_SD_OFFER_batch_add(sd_context, service, 0u);
+    }
+
+    if (SI_SD_OFFER_State_MAIN == service->state)
+    {
+        g_cyclic.valid = FALSE;
+    }
+
+    service->state = SI_SD_OFFER_State_DOWN;
+    service->remaining_ms = 0u;
+    service->answer_pending = FALSE;
+}
+
+static boolean SI_SD_OFFER_main_phase_running(void)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_SD_CFG_MAX_LOCAL_SERVICES; i++)
+    {
+        if ((TRUE == g_services[i].used) && (SI_SD_OFFER_State_MAIN == g_services[i].state))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Service joins the shared cyclic offers. The first service entering Main Phase starts the cyclic offer timer.
+ */
+static void SI_SD_OFFER_enter_main_phase(struct SI_SD_OFFER_service* service)
+{
+    if (FALSE == SI_SD_OFFER_main_phase_running())
+    {
+        g_cyclic.remaining_ms = SI_SD_CFG_CYCLIC_OFFER_DELAY_MS;
+    }
+
+    service->state = SI_SD_OFFER_State_MAIN;
+    service->remaining_ms = 0u;
+    g_cyclic.valid = FALSE;
+}
+
+/**
+ * Serialises the built message into the next free cyclic datagram and releases the builder
+ *
+ * @returns TRUE if datagram is stored
+ */
+static boolean SI_SD_OFFER_store_cyclic(struct SI_SD_PayloadBuilder* payload, uint32 offers_num)
+{
+    boolean stored = FALSE;
+    struct SI_SD_OFFER_cyclic_datagram* datagram = NULLPTR;
+
+    if ((SI_SD_OFFER_CYCLIC_DATAGRAMS_MAX > g_cyclic.datagrams_num) && (TRUE == SI_SD_PROVIDER_serialize(payload)))
+    {
+        datagram = &(g_cyclic.datagrams[g_cyclic.datagrams_num]);
+        memcpy(datagram->data, payload->message.data, payload->message.length);
+        datagram->length = payload->message.length;
+        datagram->offers_num = offers_num;
+        g_cyclic.datagrams_num += 1u;
+        stored = TRUE;
+    }
+
+    (void)SI_SD_BUILDER_invalidate(payload);
+    return stored;
+}
+
+/**
+ * Serialises the offers of every service in Main Phase into the cyclic datagrams.
+ * Offers not fitting into a datagram continue in the next one.
+ *
+ * @returns TRUE if datagrams are valid
+ */
+static boolean SI_SD_OFFER_build_cyclic(void)
+{
+    uint32 i = 0u;
+    uint32 offers_num = 0u;
+    boolean built = TRUE;
+    struct SI_SD_ServiceEntry entry;
+    struct SI_SD_IPv4EndpointOption option;
+    struct SI_SD_PayloadBuilder payload;
+
+    g_cyclic.valid = FALSE;
+    g_cyclic.datagrams_num = 0u;
+
+    if (FALSE == SI_SD_BUILDER_init(&payload))
+    {
+        return FALSE;
+    }
+
+    for (i = 0u; (i < SI_SD_CFG_MAX_LOCAL_SERVICES) && (TRUE == built); i++)
+    {
+        if ((TRUE == g_services[i].used) && (SI_SD_OFFER_State_MAIN == g_services[i].state))
+        {
+            built = SI_SD_OFFER_create_entry(&(g_services[i]), SI_SD_CFG_OFFER_TTL, &entry, &option);
+
+            if ((TRUE == built) && (FALSE == SI_SD_BUILDER_add_service_entry(&payload, &entry, &option)))
+            {
+                // datagram is full, the offer starts the next one
+                built = ((0u < offers_num) &&
+                         (TRUE == SI_SD_OFFER_store_cyclic(&payload, offers_num)) &&
+                         (TRUE == SI_SD_BUILDER_init(&payload)) &&
+                         (TRUE == SI_SD_BUILDER_add_service_entry(&payload, &entry, &option)));
+                offers_num = 0u;
+            }
+
+            offers_num += 1u;
+        }
+    }
+
+    if (TRUE == built)
+    {
+        g_cyclic.valid = SI_SD_OFFER_store_cyclic(&payload, offers_num);
+        g_counters.cyclic_rebuilds += (TRUE == g_cyclic.valid) ? 1u : 0u;
+    }
+    else
+    {
+        (void)SI_SD_BUILDER_invalidate(&payload);
+    }
+
+    return g_cyclic.valid;
+}
+
+/**
+ * Sends the cyclic offers to the SD multicast group, datagrams are rebuilt first if they are outdated.
+ * Every datagram gets its own session ID.
+ */
+static void SI_SD_OFFER_send_cyclic(struct SD_Context *sd_context)
+{
+    uint32 i = 0u;
+    struct SI_SD_OFFER_cyclic_datagram* datagram = NULLPTR;
+
+    if ((FALSE == g_cyclic.valid) && (FALSE == SI_SD_OFFER_build_cyclic()))
+    {
+        g_counters.tx_failed += 1u;
+        return;
+    }
+
+    for (i = 0u; i < g_cyclic.datagrams_num; i++)
+    {
+        datagram = &(g_cyclic.datagrams[i]);
+        if (FALSE == SI_SD_PROVIDER_send_serialized(sd_context, sd_context->multicast_ipv4_be, sd_context->sd_port_be, FALSE,
+                                                    datagram->data, datagram->length))
+        {
+            g_counters.tx_failed += 1u;
+        }
+        else
+        {
+            g_counters.offers_sent += datagram->offers_num;
+        }
+    }
+}
+
+/**
+ * Delay of the current phase elapsed: sends the offer and steps the state machine
+ */
+static void SI_SD_OFFER_timer_expired(struct SD_Context *sd_context, struct SI_SD_OFFER_service* service)
+{
+    SI_SD_OFFER_batch_add(sd_context, service, SI_SD_CFG_OFFER_TTL);
+
+    switch (service->state)
+    {
+        case SI_SD_OFFER_State_INITIAL_WAIT:
+        {
+            if (0u < SI_SD_CFG_REPETITIONS_MAX)
+            {
+                service->state = SI_SD_OFFER_State_REPETITION;
+                service->repetitions = 0u;
+                service->repetition_delay_ms = SI_SD_CFG_REPETITIONS_BASE_DELAY_MS;
+                service->remaining_ms = SI_SD_CFG_REPETITIONS_BASE_DELAY_MS;
+            }
+            else
+            {
+                SI_SD_OFFER_enter_main_phase(service);
+            }
+            break;
+        }
+        case SI_SD_OFFER_State_REPETITION:
+        {
+            service->repetitions += 1u;
+            if (SI_SD_CFG_REPETITIONS_MAX <= service->repetitions)
+            {
+                SI_SD_OFFER_enter_main_phase(service);
+            }
+            else
+            {
+                // delay is doubled after every repetition
+                service->repetition_delay_ms <<= 1u;
+                service->remaining_ms = service->repetition_delay_ms;
+            }
+            break;
+        }
+        case SI_SD_OFFER_State_MAIN:
+            /* FALL THROUGH: cyclic offers are sent by SI_SD_OFFER_send_cyclic() */
+        case SI_SD_OFFER_State_DOWN:
+            /* FALL THROUGH */
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/* END OF SI_SD_OFFER.C FILE */
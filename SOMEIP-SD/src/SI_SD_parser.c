@@ -12,6 +12,9 @@
 
 #include "SI_SD_parser.h"
 
+#include <string.h>         // for memset
+
+#include "lwip/def.h"       // for lwip_htonl, lwip_htons
 #include "SI_types.h"
 #include "SI_endian.h"
 #include "SI_message.h"
@@ -21,11 +24,11 @@
 #include "SI_SD_payload.h"
 #include "SI_SD_message.h"
 #include "SI_SD_service_manager.h"
+#include "SI_SD_offer.h"
+#include "SI_SD_subscription.h"
 #include "SI_SD_wire.h"
 #include "ERH.h"
 
-_Static_assert(SI_SD_SERVICE_OPTIONS_MAX_NUMBER==SI_SD_SERVICE_ENTRIES_MAX_NUMBER, "Fatal error: SI_SD_SERVICE_OPTIONS_MAX_NUMBER s not equals to SI_SD_SERVICE_ENTRIES_MAX_NUMBER, received Service Discovery messages might be unprocessable!");
-
 /* **************************************************** */
 /*                       Defines                        */
 /* **************************************************** */
@@ -38,13 +41,6 @@ _Static_assert(SI_SD_SERVICE_OPTIONS_MAX_NUMBER==SI_SD_SERVICE_ENTRIES_MAX_NUMBE
 /*                True global variables                 */
 /* **************************************************** */
 
-extern struct SD_received_Service received_service_registry[SI_SD_SERVICE_ENTRIES_MAX_NUMBER];
-
-struct SI_SD_ServiceEntry parsed_entries_pool[SI_SD_SERVICE_ENTRIES_MAX_NUMBER] = {0u};
-enum SI_SD_EntryRelatedAction_t parsed_entries_action[SI_SD_SERVICE_ENTRIES_MAX_NUMBER] = {SI_SD_EntryRelatedAction_None};
-struct SI_SD_IPv4EndpointOption parsed_options_pool[SI_SD_SERVICE_OPTIONS_MAX_NUMBER] = {0u};
-enum SI_SD_OptionRelatedAction_t parsed_options_action[SI_SD_SERVICE_OPTIONS_MAX_NUMBER] = {SI_SD_OptionRelatedAction_None};
-
 /* **************************************************** */
 /*                Local type definitions                */
 /* **************************************************** */
@@ -53,9 +49,16 @@ enum SI_SD_OptionRelatedAction_t parsed_options_action[SI_SD_SERVICE_OPTIONS_MAX
 /*             Local function declarations              */
 /* **************************************************** */
 
-static enum SI_SD_EntryRelatedAction_t SI_SD_PARSER_evaluate_entry(struct SI_SD_ServiceEntry *parsed_entry);
-static enum SI_SD_OptionRelatedAction_t SI_SD_PARSER_evaluate_option(struct SI_SD_IPv4EndpointOption *parsed_option);
-static void SI_SD_PARSER_fill_received_service_registry(void);
+static void SI_SD_PARSER_index_options(struct SI_SD_PARSER_Context* parser_context, uint8* options, uint32 options_length);
+static boolean SI_SD_PARSER_resolve_options(struct SI_SD_PARSER_Context* parser_context, uint8* options,
+                                            uint8 index_1st_option_run, uint8 number_of_options1,
+                                            uint8 index_2nd_option_run, uint8 number_of_options2,
+                                            struct SI_SD_EntryOptions* out_options);
+static boolean SI_SD_PARSER_resolve_run(struct SI_SD_PARSER_Context* parser_context, uint8* options,
+                                        uint8 index, uint8 number_of_options, struct SI_SD_EntryOptions* out_options);
+static boolean SI_SD_PARSER_decode_option(uint8* option, uint16 length, uint8 type, struct SI_SD_EntryOptions* out_options);
+static void SI_SD_PARSER_reply_address(const struct SI_SD_PARSER_Context* parser_context, const struct SI_SD_EntryOptions* entry_options,
+                                       uint32* out_ipv4_be, uint16* out_port_be);
 
 /* **************************************************** */
 /*             Global function definitions              */
@@ -91,85 +94,148 @@ boolean SI_SD_PARSER_parse_datagram(uint8* udp_payload, uint32 udp_payload_lengt
 }
 
 /**
+ * Prepares the context of parsing a received SD message
+ *
+ * @param sd_context: SD instance answers and acknowledgements are sent through
+ * @param src_ipv4_be: address of the sender (network order)
+ * @param src_port_be: port of the sender (network order)
+ * @param unicast: unicast flag of the received message
+ */
+void SI_SD_PARSER_init_context(struct SI_SD_PARSER_Context* parser_context, struct SD_Context* sd_context,
+                               uint32 src_ipv4_be, uint16 src_port_be, boolean unicast)
+{
+    if (NULLPTR == parser_context)
+    {
+        return;
+    }
+
+    parser_context->sd_context = sd_context;
+    parser_context->src_ipv4_be = src_ipv4_be;
+    parser_context->src_port_be = src_port_be;
+    parser_context->unicast = unicast;
+    parser_context->options_numof = 0u;
+    parser_context->entries_applied = 0u;
+    parser_context->entries_skipped = 0u;
+    parser_context->entries_rejected = 0u;
+    parser_context->options_skipped = 0u;
+}
+
+/**
+ * Applies every entry of the payload in a single pass: offers update the remote service registry,
+ * Find entries are answered by matching local services, Eventgroup Entries update the subscriptions.
+ * Reentrant: state of parsing is kept in parser_context, see SI_SD_PARSER_init_context().
+ *
+ * @returns FALSE if entries or options array does not fit into the payload
+ *
  * @note Information about the SOME/IP Service Discovery payload format,
  * including the Entries and Options arrays are detailed on the 23. page of the specification.
  */
-boolean SI_SD_PARSER_parse_payload(struct SD_Payload* in_payload)
+boolean SI_SD_PARSER_parse_payload(struct SI_SD_PARSER_Context* parser_context, struct SD_Payload* in_payload)
 {
     uint32 i = 0u;
-    uint8* entries_array = NULLPTR;
     uint8* entries = NULLPTR;
     uint32 entries_length = 0u;
     uint32 entries_numof = 0u;
     uint8* options_array = NULLPTR;
     uint8* options = NULLPTR;
     uint32 options_length = 0u;
-    uint32 options_numof = 0u;
-    enum SI_SD_EntryRelatedAction_t entry_action = SI_SD_EntryRelatedAction_None;
-    struct SI_SD_ServiceEntry parsed_entry = {0u};
-    enum SI_SD_OptionRelatedAction_t option_action = SI_SD_OptionRelatedAction_None;
-    struct SI_SD_IPv4EndpointOption parsed_option = {0u};
     uint8* entries_element = NULLPTR;
-    uint8* option_element = NULLPTR;
-
-    if (NULLPTR == in_payload)
+    struct SI_SD_ServiceEntry service_entry;
+    struct SI_SD_EventgroupEntry eventgroup_entry;
+    struct SI_SD_EntryOptions entry_options;
+    uint32 reply_ipv4_be = 0u;
+    uint16 reply_port_be = 0u;
+
+    if ((NULLPTR == parser_context) || (NULLPTR == in_payload) || (NULLPTR == in_payload->data) ||
+        ((SI_SD_CONST_ENTRIES_ARRAY_LENGTH_SIZE + SI_SD_CONST_OPTIONS_ARRAY_LENGTH_SIZE) > in_payload->length))
     {
         return FALSE;
     }
 
-    entries_array = in_payload->data;
-    entries = (entries_array + SI_SD_CONST_ENTRIES_ARRAY_LENGTH_SIZE);
-    entries_length = be_get_u32(entries_array);
-    entries_numof = (entries_length >> SI_SD_CONST_ENTRY_ARRAY_DIV_RATIO);
-
-    options_array = entries_array + SI_SD_CONST_ENTRIES_ARRAY_LENGTH_SIZE + entries_length;
-    options = (options_array + SI_SD_CONST_OPTIONS_ARRAY_LENGTH_SIZE);
-    options_length = be_get_u32(options_array);
-    options_numof = (options_length / SI_SD_CONST_OPTION_ARRAY_SIZE);
+    entries = (in_payload->data + SI_SD_CONST_ENTRIES_ARRAY_LENGTH_SIZE);
+    entries_length = u8array_to_u32(in_payload->data);
 
-    if (SI_SD_SERVICE_ENTRIES_MAX_NUMBER < entries_numof)
+    // IMPORTANT: lengths are checked by subtraction in order to prevent issues due to unsigned integer overflow
+    if ((in_payload->length - (SI_SD_CONST_ENTRIES_ARRAY_LENGTH_SIZE + SI_SD_CONST_OPTIONS_ARRAY_LENGTH_SIZE)) < entries_length)
     {
-        entries_numof = SI_SD_SERVICE_ENTRIES_MAX_NUMBER;
+        return FALSE;
     }
 
-    if (SI_SD_SERVICE_OPTIONS_MAX_NUMBER < options_numof)
+    options_array = entries + entries_length;
+    options = (options_array + SI_SD_CONST_OPTIONS_ARRAY_LENGTH_SIZE);
+    options_length = u8array_to_u32(options_array);
+
+    if ((in_payload->length - (SI_SD_CONST_ENTRIES_ARRAY_LENGTH_SIZE + SI_SD_CONST_OPTIONS_ARRAY_LENGTH_SIZE) - entries_length) < options_length)
     {
-        options_numof = SI_SD_SERVICE_OPTIONS_MAX_NUMBER;
+        return FALSE;
     }
 
+    entries_numof = (entries_length >> SI_SD_CONST_ENTRY_ARRAY_DIV_RATIO);
+    SI_SD_PARSER_index_options(parser_context, options, options_length);
+
     for (i = 0u; i < entries_numof; i++)
     {
         entries_element = &(entries[i*SI_SD_CONST_ENTRY_ARRAY_SIZE]);
 
-        SI_SD_WIRE_deserialize_ServiceEntry(entries_element, &parsed_entry);
-
-        entry_action = SI_SD_PARSER_evaluate_entry(&parsed_entry);
-
-        parsed_entries_pool[i] = parsed_entry;
-        parsed_entries_action[i] = entry_action;
-    }
-
-    for (i = 0u; i < options_numof; i++)
-    {
-        option_element = &(options[i*SI_SD_CONST_OPTION_ARRAY_SIZE]);
-
-        // note: in case of other option type, parsing will be different
-        SI_SD_WIRE_deserialize_IPv4EndpointOption(option_element, &parsed_option);
-
-        if (SD_OptionTypes_IPV4_ENDPOINT != parsed_option.type)
+        switch (entries_element[0u])
         {
-            ERH_report_error(ERH_OPT_TYPE_INVALID, 0u, 0u, 0u, 0u, 0u, 0u);
-            return FALSE;
+            case SD_EntryTypes_Find:
+                /* FALL THROUGH */
+            case SD_EntryTypes_Offer:
+            {
+                SI_SD_WIRE_deserialize_ServiceEntry(entries_element, &service_entry);
+                if (FALSE == SI_SD_PARSER_resolve_options(parser_context, options,
+                                                          service_entry.index_1st_option_run, service_entry.number_of_options1,
+                                                          service_entry.index_2nd_option_run, service_entry.number_of_options2,
+                                                          &entry_options))
+                {
+                    parser_context->entries_rejected += 1u;
+                    continue;
+                }
+
+                if (SD_EntryTypes_Find == service_entry.type)
+                {
+                    SI_SD_PARSER_reply_address(parser_context, &entry_options, &reply_ipv4_be, &reply_port_be);
+                    SI_SD_OFFER_answer_find(parser_context->sd_context, &service_entry, reply_ipv4_be, reply_port_be, parser_context->unicast);
+                }
+                else
+                {
+                    SI_SD_PROVIDER_apply_offer(&service_entry,
+                                               ((TRUE == entry_options.has_ipv4_endpoint) ? (&(entry_options.ipv4_endpoint)) : (NULLPTR)),
+                                               parser_context->src_ipv4_be);
+                }
+                break;
+            }
+            case SD_EntryTypes_Subscribe:
+                /* FALL THROUGH */
+            case SD_EntryTypes_SubscribeAck:
+            {
+                SI_SD_WIRE_deserialize_EventgroupEntry(entries_element, &eventgroup_entry);
+                if (FALSE == SI_SD_PARSER_resolve_options(parser_context, options,
+                                                          eventgroup_entry.index_1st_option_run, eventgroup_entry.number_of_options1,
+                                                          eventgroup_entry.index_2nd_option_run, eventgroup_entry.number_of_options2,
+                                                          &entry_options))
+                {
+                    parser_context->entries_rejected += 1u;
+                    continue;
+                }
+
+                SI_SD_PARSER_reply_address(parser_context, &entry_options, &reply_ipv4_be, &reply_port_be);
+                SI_SD_SUBSCRIPTION_apply(parser_context->sd_context, &eventgroup_entry,
+                                         ((TRUE == entry_options.has_ipv4_endpoint) ? (&(entry_options.ipv4_endpoint)) : (NULLPTR)),
+                                         reply_ipv4_be, reply_port_be, parser_context->src_ipv4_be);
+                break;
+            }
+            default:
+            {
+                // Entry type is not supported, it is skipped
+                parser_context->entries_skipped += 1u;
+                continue;
+            }
         }
-
-        option_action = SI_SD_PARSER_evaluate_option(&parsed_option);
-
-        parsed_options_pool[i] = parsed_option;
-        parsed_options_action[i] = option_action;
+        parser_context->entries_applied += 1u;
     }
 
-    SI_SD_PARSER_fill_received_service_registry();
-
     return TRUE;
 }
 
@@ -177,90 +243,205 @@ boolean SI_SD_PARSER_parse_payload(struct SD_Payload* in_payload)
 /*             Local function definitions               */
 /* **************************************************** */
 
-static boolean SI_SD_PARSER_find_registered_entry(struct SI_SD_ServiceEntry *parsed_entry)
+/**
+ * Records the position of every option of the options array. Options are variable length:
+ * an option takes its "Length" field + SI_SD_CONST_OPTION_HEADER_SIZE bytes.
+ * Indexing stops at a malformed option (it does not fit into the array), options behind it cannot be referenced.
+ */
+static void SI_SD_PARSER_index_options(struct SI_SD_PARSER_Context* parser_context, uint8* options, uint32 options_length)
 {
-    struct SD_remote_Service* registered_service = NULLPTR;
+    uint32 offset = 0u;
+    uint16 length = 0u;
 
-    registered_service = SI_SD_PROVIDER_lookup_service(parsed_entry->serviceID,
-                                                       parsed_entry->instanceID,
-                                                       parsed_entry->major_version);
+    parser_context->options_numof = 0u;
 
-    if (NULLPTR != registered_service)
+    // Every option has at least the Length, Type and Reserved / Discardable flag fields
+    while ((SI_SD_CONST_OPTION_HEADER_SIZE < (options_length - offset)) &&
+           (SI_SD_CFG_PARSER_MAX_OPTIONS > parser_context->options_numof))
     {
-        return TRUE;
+        length = u8array_to_u16(&(options[offset]));
+
+        if ((0u == length) || ((options_length - offset - SI_SD_CONST_OPTION_HEADER_SIZE) < length))
+        {
+            ERH_report_error(ERH_OPT_TYPE_INVALID, offset, length, options_length, 0u, 0u, 0u);
+            break;
+        }
+
+        parser_context->option_offsets[parser_context->options_numof] = (uint16)offset;
+        parser_context->options_numof += 1u;
+        offset += ((uint32)length + SI_SD_CONST_OPTION_HEADER_SIZE);
     }
-    return FALSE;
 }
 
-static enum SI_SD_EntryRelatedAction_t SI_SD_PARSER_evaluate_entry(struct SI_SD_ServiceEntry *parsed_entry)
+/**
+ * Collects the options referenced by both option runs of an entry.
+ *
+ * @returns FALSE if the entry shall be ignored: it references an option that is missing or unknown and not discardable
+ */
+static boolean SI_SD_PARSER_resolve_options(struct SI_SD_PARSER_Context* parser_context, uint8* options,
+                                            uint8 index_1st_option_run, uint8 number_of_options1,
+                                            uint8 index_2nd_option_run, uint8 number_of_options2,
+                                            struct SI_SD_EntryOptions* out_options)
 {
-    const boolean invalid_parameter = (NULLPTR == parsed_entry);
-    const boolean invalid_entry = ((SD_EntryTypes_Find != parsed_entry->type) && (SD_EntryTypes_Offer != parsed_entry->type));
+    (void)memset(out_options, 0, sizeof(struct SI_SD_EntryOptions));
+    out_options->configuration.data = NULLPTR;
 
-    if (invalid_parameter || invalid_entry)
-    {
-        return SI_SD_EntryRelatedAction_None;
-    }
+    return ((TRUE == SI_SD_PARSER_resolve_run(parser_context, options, index_1st_option_run, number_of_options1, out_options)) &&
+            (TRUE == SI_SD_PARSER_resolve_run(parser_context, options, index_2nd_option_run, number_of_options2, out_options)));
+}
 
-    if (SD_EntryTypes_Find == parsed_entry->type)
-    {
-        // Received message asks for service information
-        return SI_SD_EntryRelatedAction_Provide;
-    }
-    else if (TRUE == SI_SD_PARSER_find_registered_entry(parsed_entry))
+static boolean SI_SD_PARSER_resolve_run(struct SI_SD_PARSER_Context* parser_context, uint8* options,
+                                        uint8 index, uint8 number_of_options, struct SI_SD_EntryOptions* out_options)
+{
+    uint32 i = 0u;
+    uint32 option_index = 0u;
+    uint8* option = NULLPTR;
+    uint16 length = 0u;
+    uint8 type = 0u;
+    boolean discardable = FALSE;
+
+    for (i = 0u; i < number_of_options; i++)
     {
-        // Received message is an offer and we already know of it
-        if (0u == parsed_entry->ttl)
+        option_index = ((uint32)index + i);
+        if (parser_context->options_numof <= option_index)
         {
-            return SI_SD_EntryRelatedAction_Delete;
+            return FALSE;
         }
-        else
+
+        option = &(options[parser_context->option_offsets[option_index]]);
+        SI_SD_WIRE_deserialize_option_header(option, &length, &type, &discardable);
+
+        if (FALSE == SI_SD_PARSER_decode_option(option, length, type, out_options))
         {
-            return SI_SD_EntryRelatedAction_Update;
+            if (FALSE == discardable)
+            {
+                ERH_report_error(ERH_OPT_TYPE_INVALID, type, length, option_index, 0u, 0u, 0u);
+                return FALSE;
+            }
+            parser_context->options_skipped += 1u;
         }
     }
-    else
-    {
-        // Received message is an offer and we never heard of it
-        return SI_SD_EntryRelatedAction_Save;
-    }
-
-    // Unreachable code
-    return SI_SD_EntryRelatedAction_None;
+    return TRUE;
 }
 
-static enum SI_SD_OptionRelatedAction_t SI_SD_PARSER_evaluate_option(struct SI_SD_IPv4EndpointOption *parsed_option)
+/**
+ * Stores a known option into out_options. Endpoint options: UDP endpoint replaces a TCP one.
+ *
+ * @returns FALSE if option type is unknown or its length does not match the type
+ */
+static boolean SI_SD_PARSER_decode_option(uint8* option, uint16 length, uint8 type, struct SI_SD_EntryOptions* out_options)
 {
-    const boolean invalid_parameter = (NULLPTR == parsed_option);
-    const boolean invalid_option = (SD_OptionTypes_IPV4_ENDPOINT != parsed_option->type);
+    struct SI_SD_IPv4EndpointOption ipv4;
 
-    if (invalid_parameter || invalid_option)
+    switch (type)
     {
-        return SI_SD_OptionRelatedAction_None;
+        case SD_OptionTypes_IPV4_ENDPOINT:
+        {
+            if (SI_SD_CONST_IPV4_OPTION_LENGTH != length)
+            {
+                return FALSE;
+            }
+            SI_SD_WIRE_deserialize_IPv4EndpointOption(option, &ipv4);
+            if ((FALSE == out_options->has_ipv4_endpoint) ||
+                ((SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP != out_options->ipv4_endpoint.l4_proto) && (SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP == ipv4.l4_proto)))
+            {
+                out_options->ipv4_endpoint = ipv4;
+                out_options->has_ipv4_endpoint = TRUE;
+            }
+            return TRUE;
+        }
+        case SD_OptionTypes_IPV4_MC:
+        {
+            if (SI_SD_CONST_IPV4_OPTION_LENGTH != length)
+            {
+                return FALSE;
+            }
+            SI_SD_WIRE_deserialize_IPv4EndpointOption(option, &(out_options->ipv4_multicast));
+            out_options->has_ipv4_multicast = TRUE;
+            return TRUE;
+        }
+        case SD_OptionTypes_IPV4_SD_Endpoint:
+        {
+            if (SI_SD_CONST_IPV4_OPTION_LENGTH != length)
+            {
+                return FALSE;
+            }
+            SI_SD_WIRE_deserialize_IPv4EndpointOption(option, &(out_options->ipv4_sd_endpoint));
+            out_options->has_ipv4_sd_endpoint = TRUE;
+            return TRUE;
+        }
+        case SD_OptionTypes_IPV6_ENDPOINT:
+        {
+            if (SI_SD_CONST_IPV6_OPTION_LENGTH != length)
+            {
+                return FALSE;
+            }
+            if ((FALSE == out_options->has_ipv6_endpoint) || (SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP != out_options->ipv6_endpoint.l4_proto))
+            {
+                SI_SD_WIRE_deserialize_IPv6EndpointOption(option, &(out_options->ipv6_endpoint));
+                out_options->has_ipv6_endpoint = TRUE;
+            }
+            return TRUE;
+        }
+        case SD_OptionTypes_IPV6_MC:
+        {
+            if (SI_SD_CONST_IPV6_OPTION_LENGTH != length)
+            {
+                return FALSE;
+            }
+            SI_SD_WIRE_deserialize_IPv6EndpointOption(option, &(out_options->ipv6_multicast));
+            out_options->has_ipv6_multicast = TRUE;
+            return TRUE;
+        }
+        case SD_OptionTypes_IPV6_SD_Endpoint:
+        {
+            if (SI_SD_CONST_IPV6_OPTION_LENGTH != length)
+            {
+                return FALSE;
+            }
+            SI_SD_WIRE_deserialize_IPv6EndpointOption(option, &(out_options->ipv6_sd_endpoint));
+            out_options->has_ipv6_sd_endpoint = TRUE;
+            return TRUE;
+        }
+        case SD_OptionTypes_LOAD_BALANCING:
+        {
+            if (SI_SD_CONST_LOAD_BALANCING_OPTION_LENGTH != length)
+            {
+                return FALSE;
+            }
+            SI_SD_WIRE_deserialize_LoadBalancingOption(option, &(out_options->load_balancing));
+            out_options->has_load_balancing = TRUE;
+            return TRUE;
+        }
+        case SD_OptionTypes_CONFIGURATION:
+        {
+            // Length covers the Reserved byte too, strings follow it
+            out_options->configuration.data = &(option[SI_SD_CONST_OPTION_HEADER_SIZE + 1u]);
+            out_options->configuration.length = (uint16)(length - 1u);
+            return TRUE;
+        }
+        default:
+        {
+            return FALSE;
+        }
     }
-    return SI_SD_OptionRelatedAction_Save;
 }
 
-static void SI_SD_PARSER_fill_received_service_registry(void)
+/**
+ * Answers go to the SD endpoint given in an IPv4 SD Endpoint option, otherwise to the sender of the message
+ */
+static void SI_SD_PARSER_reply_address(const struct SI_SD_PARSER_Context* parser_context, const struct SI_SD_EntryOptions* entry_options,
+                                       uint32* out_ipv4_be, uint16* out_port_be)
 {
-    uint32 i = 0u;
-
-    // note: SI_SD_SERVICE_ENTRIES_MAX_NUMBER must equal to SI_SD_SERVICE_OPTIONS_MAX_NUMBER
-    for (i = 0u; i < SI_SD_SERVICE_ENTRIES_MAX_NUMBER; i++)
+    if (TRUE == entry_options->has_ipv4_sd_endpoint)
     {
-        if ((SI_SD_EntryRelatedAction_None != parsed_entries_action[i]) || (SI_SD_OptionRelatedAction_None != parsed_options_action[i]))
-        {
-            received_service_registry[i].entry = parsed_entries_pool[i];
-            received_service_registry[i].entry_action = parsed_entries_action[i];
-            received_service_registry[i].option = parsed_options_pool[i];
-            received_service_registry[i].option_action = parsed_options_action[i];
-            received_service_registry[i].used = TRUE;
-        }
-        else
-        {
-            received_service_registry[i].used = FALSE;
-        }
+        *out_ipv4_be = lwip_htonl(entry_options->ipv4_sd_endpoint.IPv4_address);
+        *out_port_be = lwip_htons(entry_options->ipv4_sd_endpoint.port_number);
+        return;
     }
+
+    *out_ipv4_be = parser_context->src_ipv4_be;
+    *out_port_be = parser_context->src_port_be;
 }
 
 /* END OF SI_SD_PARSER.C FILE */
@@ -77,6 +77,43 @@ boolean SI_SD_PAYLOAD_create_single_entry(enum SD_EntryTypes type,
 	return TRUE;
 }
 
+/**
+ * Eventgroup entries reference at most one option run (endpoint or multicast option).
+ */
+boolean SI_SD_PAYLOAD_create_eventgroup_entry(enum SD_EntryTypes type,
+                                              uint8 index_1st_option_run,
+                                              uint8 number_of_options1,
+                                              uint16 serviceID,
+                                              uint16 instanceID,
+                                              uint8 major_version,
+                                              uint32 ttl,
+                                              uint8 counter,
+                                              uint16 eventgroupID,
+                                              struct SI_SD_EventgroupEntry* out_entry)
+{
+    const boolean invalid_input = ((NULLPTR == out_entry) || (0x0Fu < number_of_options1) || (0x0Fu < counter) || (0x00FFFFFFu < ttl));
+    const boolean invalid_type = ((SD_EntryTypes_Subscribe != type) && (SD_EntryTypes_SubscribeAck != type));
+
+    if (invalid_input || invalid_type)
+    {
+        return FALSE;
+    }
+
+    out_entry->type = type;
+    out_entry->index_1st_option_run = index_1st_option_run;
+    out_entry->index_2nd_option_run = 0u;
+    out_entry->number_of_options1 = number_of_options1;
+    out_entry->number_of_options2 = 0u;
+    out_entry->serviceID = serviceID;
+    out_entry->instanceID = instanceID;
+    out_entry->major_version = major_version;
+    out_entry->ttl = ttl;
+    out_entry->counter = counter;
+    out_entry->eventgroupID = eventgroupID;
+
+    return TRUE;
+}
+
 boolean SI_SD_PAYLOAD_create_option(uint16 length,
                                     enum SD_OptionTypes_t type,
                                     boolean discardable_flag,
@@ -86,7 +123,7 @@ boolean SI_SD_PAYLOAD_create_option(uint16 length,
                                     struct SI_SD_IPv4EndpointOption *out_option)
 {
     const boolean invlaid_input = (NULLPTR == out_option);
-    const boolean invalid_type = (SD_OptionTypes_IPV4_ENDPOINT != type); // currently the only valid value
+    const boolean invalid_type = ((SD_OptionTypes_IPV4_ENDPOINT != type) && (SD_OptionTypes_IPV4_MC != type)); // same layout
 
     // ... add additional checks
 
@@ -0,0 +1,212 @@
+/**
+ * @file    SI_SD_peer.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_SD_peer.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_SD_peer.h"
+
+#include "SI_types.h"
+
+#include "SI_SD_config.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SD_Peer g_peers[SI_SD_CFG_MAX_PEERS];
+static uint32 g_message_counter = 0u;                  // number of processed messages, orders the peers by their last message
+static struct SI_SD_PEER_counters g_counters;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static struct SD_Peer* SI_SD_PEER_find(uint32 ipv4_be);
+static struct SD_Peer* SI_SD_PEER_alloc(uint32 ipv4_be);
+static boolean SI_SD_PEER_rebooted(const struct SD_PeerChannel* channel, uint16 session_id, boolean reboot_flag);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Forgets every peer
+ * @note Called by SI_SD_PROVIDER_init().
+ */
+void SI_SD_PEER_init(void)
+{
+    uint32 i = 0u;
+
+    SI_SD_CFG_PEER_LOCK();
+    for (i = 0u; i < SI_SD_CFG_MAX_PEERS; i++)
+    {
+        g_peers[i].used = FALSE;
+    }
+    g_message_counter = 0u;
+    SI_SD_CFG_PEER_UNLOCK();
+}
+
+/**
+ * Records the session of a message received from a peer.
+ *
+ * @param ipv4_be: source address of the message (network order)
+ * @param session_id: Session ID of the message
+ * @param reboot_flag: reboot flag of the message
+ * @param multicast: TRUE if the message was sent to the SD multicast group
+ *
+ * @returns TRUE if the peer rebooted since its previous message: drop what is known about it,
+ *          before the entries of the message are applied
+ */
+boolean SI_SD_PEER_update(uint32 ipv4_be, uint16 session_id, boolean reboot_flag, boolean multicast)
+{
+    struct SD_Peer* peer = NULLPTR;
+    struct SD_PeerChannel* channel = NULLPTR;
+    boolean rebooted = FALSE;
+
+    SI_SD_CFG_PEER_LOCK();
+    g_message_counter += 1u;
+
+    peer = SI_SD_PEER_find(ipv4_be);
+    if (NULLPTR == peer)
+    {
+        peer = SI_SD_PEER_alloc(ipv4_be);
+    }
+
+    channel = (TRUE == multicast) ? (&(peer->multicast)) : (&(peer->unicast));
+    rebooted = SI_SD_PEER_rebooted(channel, session_id, reboot_flag);
+    if (TRUE == rebooted)
+    {
+        // Sessions of the other channel belong to the previous life too
+        peer->multicast.seen = FALSE;
+        peer->unicast.seen = FALSE;
+        g_counters.reboots_detected += 1u;
+    }
+
+    channel->seen = TRUE;
+    channel->session_id = session_id;
+    channel->reboot_flag = reboot_flag;
+    peer->last_seen = g_message_counter;
+    SI_SD_CFG_PEER_UNLOCK();
+
+    return rebooted;
+}
+
+/**
+ * @param out_peer: copy of the peer
+ *
+ * @returns FALSE if the peer is not known
+ */
+boolean SI_SD_PEER_get(uint32 ipv4_be, struct SD_Peer* out_peer)
+{
+    struct SD_Peer* peer = NULLPTR;
+
+    if (NULLPTR == out_peer)
+    {
+        return FALSE;
+    }
+
+    SI_SD_CFG_PEER_LOCK();
+    peer = SI_SD_PEER_find(ipv4_be);
+    if (NULLPTR != peer)
+    {
+        *out_peer = *peer;
+    }
+    SI_SD_CFG_PEER_UNLOCK();
+
+    return (NULLPTR != peer);
+}
+
+void SI_SD_PEER_get_counters(struct SI_SD_PEER_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static struct SD_Peer* SI_SD_PEER_find(uint32 ipv4_be)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_SD_CFG_MAX_PEERS; i++)
+    {
+        if ((TRUE == g_peers[i].used) && (ipv4_be == g_peers[i].ipv4_be))
+        {
+            return &(g_peers[i]);
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * Takes a free element, or the peer silent for the longest time if the table is full
+ */
+static struct SD_Peer* SI_SD_PEER_alloc(uint32 ipv4_be)
+{
+    uint32 i = 0u;
+    struct SD_Peer* peer = &(g_peers[0u]);
+
+    for (i = 0u; i < SI_SD_CFG_MAX_PEERS; i++)
+    {
+        if (FALSE == g_peers[i].used)
+        {
+            peer = &(g_peers[i]);
+            break;
+        }
+
+        // Unsigned difference keeps the order when the message counter wraps
+        if ((g_message_counter - g_peers[i].last_seen) > (g_message_counter - peer->last_seen))
+        {
+            peer = &(g_peers[i]);
+        }
+    }
+
+    if (TRUE == peer->used)
+    {
+        g_counters.evicted += 1u;
+    }
+
+    peer->used = TRUE;
+    peer->ipv4_be = ipv4_be;
+    peer->multicast.seen = FALSE;
+    peer->unicast.seen = FALSE;
+    return peer;
+}
+
+/**
+ * Reboot detection: the reboot flag changed from 0 to 1, or it stayed 1 and the session ID did not increase.
+ * The first message of an unknown peer is not a reboot, there is nothing known about its previous life.
+ */
+static boolean SI_SD_PEER_rebooted(const struct SD_PeerChannel* channel, uint16 session_id, boolean reboot_flag)
+{
+    if ((FALSE == channel->seen) || (FALSE == reboot_flag))
+    {
+        return FALSE;
+    }
+
+    return ((FALSE == channel->reboot_flag) || (session_id <= channel->session_id));
+}
+
+/* END OF SI_SD_PEER.C FILE */
@@ -14,10 +14,14 @@
 #include "lwip/pbuf.h"
 #include "lwip/ip_addr.h"
 #include "lwip/udp.h"
+#include "lwip/ip.h"        // for ip_current_dest_addr
+#include "lwip/def.h"       // for lwip_htons
 #include "SI_types.h"
 #include "SI_SD_message.h"
 #include "SI_SD_service_manager.h"
 #include "SI_SD_parser.h"
+#include "SI_SD_peer.h"
+#include "SI_SD_subscription.h"
 
 /* **************************************************** */
 /*                       Defines                        */
@@ -43,12 +47,37 @@
 /*             Global function definitions              */
 /* **************************************************** */
 
+/**
+ * Rx handler of the SD socket, received messages are applied to the SD instance given to SI_SD_PROVIDER_init().
+ */
 boolean SI_SD_PROCESS_multicast(struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf, const ip_addr_t *src_addr, u16_t src_port)
+{
+    // Destination of the message being received: the SD multicast group or this node
+    const boolean multicast = (0u != ip_addr_ismulticast(ip_current_dest_addr()));
+
+    return SI_SD_PROCESS_receive(SI_SD_PROVIDER_get_context(), rx_udp_pcb, rx_pbuf, src_addr, src_port, multicast);
+}
+
+/**
+ * Processes a received SD message. Reentrant: SD workers of several interfaces may call it in parallel,
+ * each with its own SD instance (answers are sent through the interface of sd_context, delayed answers too).
+ * Cyclic offers and timekeeping run for the instance given to SI_SD_PROVIDER_init(), see SI_SD_PROVIDER_tick_ms().
+ * Shared registries are guarded by the SI_SD_CFG_*_LOCK hooks (see SI_SD_config.h).
+ *
+ * @param multicast: TRUE if the message was sent to the SD multicast group (session of the sender is tracked per channel)
+ *
+ * @returns TRUE if message is valid and its entries are applied
+ */
+boolean SI_SD_PROCESS_receive(struct SD_Context *sd_context, struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf,
+                              const ip_addr_t *src_addr, u16_t src_port, boolean multicast)
 {
     struct SD_MessageContext sd_request;
+    struct SI_SD_PARSER_Context parser_context;
+    boolean unicast = FALSE;
+    boolean reboot_flag = FALSE;
 
     // ---- 0)
-    if ((NULLPTR == rx_udp_pcb) || (NULLPTR == rx_pbuf) || (NULLPTR == src_addr))
+    if ((NULLPTR == sd_context) || (NULLPTR == rx_udp_pcb) || (NULLPTR == rx_pbuf) || (NULLPTR == src_addr))
     {
         return FALSE;
     }
@@ -60,15 +89,20 @@ boolean SI_SD_PROCESS_multicast(struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf
         return FALSE;
     }
 
-    if (FALSE == SI_SD_PARSER_parse_payload(&sd_request.payload))
+    // ---- 2) Sender rebooted: its offers and subscriptions belong to its previous life, they are dropped
+    //         before the entries of this message are applied
+    reboot_flag = (0u != (((sd_request.header.preamble >> SI_SD_CONST_PREAMBLE_FLAGS_OFFS) & SI_SD_CONST_PREAMBLE_REBOOT_FLAG_MASK)));
+    if (TRUE == SI_SD_PEER_update((uint32)src_addr->addr, sd_request.header.request_id.sessionID, reboot_flag, multicast))
     {
-        return FALSE;
+        SI_SD_PROVIDER_remove_peer((uint32)src_addr->addr);
+        SI_SD_SUBSCRIPTION_remove_peer((uint32)src_addr->addr);
     }
 
-    // ---- 2) Update remote service registry
-    SI_SD_PROVIDER_received_registry_resolver();
+    // ---- 3) Apply entries: registry update, Find answers (unicast if the requester supports it), subscriptions
+    unicast = (0u != (((sd_request.header.preamble >> SI_SD_CONST_PREAMBLE_FLAGS_OFFS) & SI_SD_CONST_PREAMBLE_UNICAST_FLAG_MASK)));
+    SI_SD_PARSER_init_context(&parser_context, sd_context, (uint32)src_addr->addr, lwip_htons(src_port), unicast);
 
-    return TRUE;
+    return SI_SD_PARSER_parse_payload(&parser_context, &sd_request.payload);
 }
 
 /* **************************************************** */
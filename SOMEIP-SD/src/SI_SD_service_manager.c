@@ -11,27 +11,71 @@
 
 #include "SI_SD_service_manager.h"
 
+#include <string.h>         // for memset
+
 #include "lwip/pbuf.h"
+#include "lwip/def.h"       // for lwip_htonl, lwip_htons
 
+#include "SI_config.h"
 #include "SI_dispatcher.h"
 #include "SI_header.h"
+#include "SI_timerwheel.h"
+#include "SI_hash.h"
 
 #include "SI_SD_payload.h"
+#include "SI_SD_message.h"
+#include "SI_SD_builder.h"
+#include "SI_SD_subscription.h"
+#include "SI_SD_offer.h"
+#include "SI_SD_peer.h"
+#include "SI_SD_watch.h"
+#include "SI_SD_snapshot.h"
 #include "ERH.h"
 
+#include <assert.h>
+
+static_assert(SI_HASH_IS_POWER_OF_TWO(SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE), "FATAL ERROR: SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE must be a power of two!");
+static_assert(SI_SD_CFG_MAX_REMOTE_SERVICES < SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE, "FATAL ERROR: SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE must be bigger than SI_SD_CFG_MAX_REMOTE_SERVICES!");
+static_assert(SI_SD_CFG_MAX_REMOTE_SERVICES < 0xFFFEu, "FATAL ERROR: SI_SD_CFG_MAX_REMOTE_SERVICES is too big for 16 bit registry indices!");
+
 /* **************************************************** */
 /*                       Defines                        */
 /* **************************************************** */
 
+/**
+ * Longest TTL armed at once [sec], the rest is armed when the timer fires
+ */
+#define SI_SD_PROVIDER_TTL_MAX_ARM_SEC      ((SI_TIMERWHEEL_MAX_TICKS / 1000u) * SI_CFG_TIMERWHEEL_RESOLUTION_MS)
+
+/**
+ * Registry index meaning "no element": end of the LRU and free lists, never used index slot
+ */
+#define SI_SD_PROVIDER_NIL                  (0xFFFFu)
+
+/**
+ * Index slot of a removed element, probe sequences continue through it
+ */
+#define SI_SD_PROVIDER_DELETED              (0xFFFEu)
+
 /* **************************************************** */
 /*               Static global variables                */
 /* **************************************************** */
 
+static struct SD_Context* g_sd_context = NULLPTR;   // context given to SI_SD_PROVIDER_init()
+static struct SI_TIMERWHEEL_wheel g_ttl_wheel;      // expiry of remote services
+static uint32 g_ttl_remainder_ms = 0u;              // elapsed time not accounted in whole seconds yet [ms] (subscription TTLs)
+
+// Hash index of the valid elements of remote_service_registry, key: Service ID, Instance ID, major version
+static uint16 g_index[SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE];
+static uint32 g_index_count = 0u;
+static uint16 g_lru_head = SI_SD_PROVIDER_NIL;      // most recently offered
+static uint16 g_lru_tail = SI_SD_PROVIDER_NIL;      // least recently offered, evicted first
+static uint16 g_free_head = SI_SD_PROVIDER_NIL;
+
 /* **************************************************** */
 /*                True global variables                 */
 /* **************************************************** */
 
-struct SD_received_Service received_service_registry[SI_SD_SERVICE_ENTRIES_MAX_NUMBER];
 struct SD_remote_Service remote_service_registry[SI_SD_CFG_MAX_REMOTE_SERVICES];
 
 /* **************************************************** */
@@ -42,11 +86,22 @@ struct SD_remote_Service remote_service_registry[SI_SD_CFG_MAX_REMOTE_SERVICES];
 /*             Local function declarations              */
 /* **************************************************** */
 
-static inline boolean SI_SD_PROVIDER_service_expired(struct SD_Context *sd_context, struct SD_remote_Service *service);
+static void SI_SD_PROVIDER_update_registry(const struct SI_SD_ServiceEntry* entry, const struct SI_SD_IPv4EndpointOption* option,
+                                           uint32 src_ipv4_be);
+static struct SD_remote_Service* SI_SD_PROVIDER_find_service(uint16 service_id, uint16 instance_id, uint8 major);
+static void SI_SD_PROVIDER_arm_ttl(struct SD_remote_Service *service, uint32 ttl_sec);
+static void SI_SD_PROVIDER_service_timeout(void* context);
 static inline boolean SI_SD_PROVIDER_service_match(struct SD_remote_Service *service,
                                                uint16 service_id, uint16 instance_id, uint8 major);
+static inline uint32 SI_SD_PROVIDER_home(uint16 service_id, uint16 instance_id, uint8 major);
+static void SI_SD_PROVIDER_link(struct SD_remote_Service *service);
+static void SI_SD_PROVIDER_unlink(struct SD_remote_Service *service);
+static void SI_SD_PROVIDER_release(struct SD_remote_Service *service);
+static void SI_SD_PROVIDER_lru_remove(uint16 index);
+static void SI_SD_PROVIDER_lru_push_front(uint16 index);
 static inline boolean SI_SD_PROVIDER_set_tx_handler(struct SD_Context *sd, const struct SD_TransportHandler_vtable *tx_handler);
 static inline uint16 SI_SD_PROVIDER_set_port(struct SD_Context *sd_context, const uint16 sd_port_be);
+static void SI_SD_PROVIDER_next_session(struct SD_Context *sd_context, boolean unicast, uint16* out_session_id, uint32* out_preamble);
 static struct SD_remote_Service* SI_SD_PROVIDER_alloc_free_service(uint16 service_id, uint16 instance_id, uint8 major);
 static struct SD_remote_Service* SI_SD_PROVIDER_alloc_used_service(uint16 service_id, uint16 instance_id, uint8 major);
 
@@ -79,12 +134,26 @@ boolean SI_SD_PROVIDER_init(struct SD_Context *sd_context, const uint32 local_ip
     }
 
     /* Clear service registry */
+    SI_TIMERWHEEL_init(&g_ttl_wheel);
+    memset(g_index, 0xFF, sizeof(g_index));
+    g_index_count = 0u;
+    g_lru_head = SI_SD_PROVIDER_NIL;
+    g_lru_tail = SI_SD_PROVIDER_NIL;
+    g_free_head = 0u;
     for (i = 0; i < (uint16)SI_SD_CFG_MAX_REMOTE_SERVICES; ++i)
     {
         remote_service_registry[i].valid = FALSE;
         remote_service_registry[i].ttl = 0u;
+        remote_service_registry[i].generation += 1u;
+        memset(&(remote_service_registry[i].expiry), 0, sizeof(struct SI_TIMERWHEEL_node));
+        remote_service_registry[i].expiry_overflow_sec = 0u;
+        remote_service_registry[i].lru_prev = SI_SD_PROVIDER_NIL;
+        remote_service_registry[i].lru_next = ((i + 1u) < SI_SD_CFG_MAX_REMOTE_SERVICES) ? ((uint16)(i + 1u)) : (SI_SD_PROVIDER_NIL);
     }
 
+    SI_SD_PEER_init();
+    SI_SD_WATCH_init();
+
     if (SI_SD_PROVIDER_set_port(sd_context, sd_port_be) != sd_port_be)
     {
         ERH_report_error(ERH_SD_PORT_FALLBACK, 0u, 0u, 0u, 0u, 0u, 0u);
@@ -103,169 +172,553 @@ boolean SI_SD_PROVIDER_init(struct SD_Context *sd_context, const uint32 local_ip
     sd_context->multicast_sessionID = 0u;
     sd_context->unicast_sessionID = 0u;
     sd_context->reboot_flag = TRUE;                     // advertise reboot until cleared
-    sd_context->ttl_timebase = 0u;
+    g_ttl_remainder_ms = 0u;
     sd_context->tx_user_ctx = tx_user_ctx;
     sd_context->unicast_supported = TRUE;
     sd_context->reboot_flag = TRUE;
 
+    g_sd_context = sd_context;
     return TRUE;
 }
 
-void SI_SD_PROVIDER_received_registry_resolver(void)
+/**
+ * Applies a received OfferService / StopOfferService entry to the remote service registry.
+ * Known services are refreshed (or removed by StopOffer), unknown offers are stored. If the registry is full,
+ * the least recently offered service is evicted.
+ *
+ * @param option: IPv4 Endpoint option referenced by the entry, NULLPTR if there is none.
+ *                Unknown services are stored only with an endpoint.
+ * @param src_ipv4_be: address of the SD node that sent the offer (network order)
+ */
+void SI_SD_PROVIDER_apply_offer(const struct SI_SD_ServiceEntry* entry, const struct SI_SD_IPv4EndpointOption* option,
+                                uint32 src_ipv4_be)
 {
-    uint16 i = 0u;
+    if ((NULLPTR == entry) || (SD_EntryTypes_Offer != entry->type))
+    {
+        return;
+    }
+
+    SI_SD_CFG_REMOTE_REGISTRY_LOCK();
+    SI_SD_PROVIDER_update_registry(entry, option, src_ipv4_be);
+    SI_SD_CFG_REMOTE_REGISTRY_UNLOCK();
+
+    SI_SD_WATCH_dispatch();
+}
+
+/**
+ * Removes every service offered by a rebooted SD node at once, instead of using its endpoints until the TTL expires.
+ *
+ * @param peer_ipv4_be: address of the SD node (network order)
+ */
+void SI_SD_PROVIDER_remove_peer(uint32 peer_ipv4_be)
+{
+    uint32 i = 0u;
     struct SD_remote_Service *remote_service = NULLPTR;
-    struct SD_remote_Service remote_service_to_be_saved;
 
-    /* If service is already in registry, update */
-    for (i = 0u; i < (uint16)SI_SD_SERVICE_ENTRIES_MAX_NUMBER; i++)
+    SI_SD_CFG_REMOTE_REGISTRY_LOCK();
+    for (i = 0u; (i < SI_SD_CFG_MAX_REMOTE_SERVICES) && (0u < g_index_count); i++)
     {
-        if ((TRUE == received_service_registry[i].used) && (SD_EntryTypes_Offer == received_service_registry[i].entry.type))
+        remote_service = &(remote_service_registry[i]);
+
+        if ((TRUE == remote_service->valid) && (peer_ipv4_be == remote_service->peer_ipv4_be))
         {
-            remote_service = SI_SD_PROVIDER_lookup_service(received_service_registry[i].entry.serviceID,
-                                                            received_service_registry[i].entry.instanceID,
-                                                            received_service_registry[i].entry.major_version);
-            if (NULLPTR != remote_service)
-            {
-                remote_service->ttl = received_service_registry[i].entry.ttl;
-                remote_service->valid = (0u == received_service_registry[i].entry.ttl) ? (FALSE) : (TRUE);
+            SI_SD_PROVIDER_release(remote_service);
+            remote_service->generation += 1u;
+        }
+    }
+    SI_SD_CFG_REMOTE_REGISTRY_UNLOCK();
 
-                remote_service->endpoint.ipv4_be = received_service_registry[i].option.IPv4_address;
-                remote_service->endpoint.port_be = received_service_registry[i].option.port_number;
+    SI_SD_WATCH_dispatch();
+}
 
-                received_service_registry[i].used = FALSE;
-            }
+/**
+ * Queues an availability notification of every valid service instance for a new watch (see SI_SD_WATCH_add())
+ */
+void SI_SD_PROVIDER_announce_services(const struct SI_SD_Watch* watch)
+{
+    uint32 i = 0u;
+
+    SI_SD_CFG_REMOTE_REGISTRY_LOCK();
+    for (i = 0u; i < SI_SD_CFG_MAX_REMOTE_SERVICES; i++)
+    {
+        if (TRUE == remote_service_registry[i].valid)
+        {
+            SI_SD_WATCH_enqueue(SI_SD_WATCH_Event_AVAILABLE, &(remote_service_registry[i]), watch);
         }
     }
-    remote_service = NULLPTR;
+    SI_SD_CFG_REMOTE_REGISTRY_UNLOCK();
+}
+
+/**
+ * Writes a snapshot of the remote service registry (see SI_SD_snapshot.h), most recently offered services first.
+ * If buffer is too small, the least recently offered services are left out.
+ * Services expiring within a second are not saved.
+ *
+ * @param now_sec: current time of a clock running over restarts (e.g. RTC) [sec]
+ *
+ * @returns length of the snapshot, 0u if buffer cannot hold even the header
+ */
+uint32 SI_SD_PROVIDER_save_snapshot(uint8* buffer, uint32 buffer_size, uint32 now_sec)
+{
+    uint16 index = SI_SD_PROVIDER_NIL;
+    uint32 records_num = 0u;
+    uint32 remaining_sec = 0u;
+    const struct SD_remote_Service *remote_service = NULLPTR;
+    struct SI_SD_SNAPSHOT_record record;
+
+    if ((NULLPTR == buffer) || (SI_SD_SNAPSHOT_HEADER_SIZE > buffer_size))
+    {
+        return 0u;
+    }
 
-    /* If service is unkown, save it */
-    for (i = 0u; i < (uint16)SI_SD_SERVICE_ENTRIES_MAX_NUMBER; i++)
+    SI_SD_CFG_REMOTE_REGISTRY_LOCK();
+    for (index = g_lru_head;
+         (SI_SD_PROVIDER_NIL != index) &&
+         (SI_SD_SNAPSHOT_RECORD_SIZE <= (buffer_size - SI_SD_SNAPSHOT_SIZE(records_num)));
+         index = remote_service->lru_next)
     {
-        if ((TRUE == received_service_registry[i].used) && (SD_EntryTypes_Offer == received_service_registry[i].entry.type))
+        remote_service = &(remote_service_registry[index]);
+
+        if (SI_SD_CONST_TTL_INFINITE == remote_service->ttl)
         {
-            remote_service_to_be_saved.instance_id = received_service_registry[i].entry.instanceID;
-            remote_service_to_be_saved.service_id = received_service_registry[i].entry.serviceID;
-            remote_service_to_be_saved.major = received_service_registry[i].entry.major_version;
-            remote_service_to_be_saved.minor = received_service_registry[i].entry.minor_version;
-            remote_service_to_be_saved.ttl = received_service_registry[i].entry.ttl;
-            remote_service_to_be_saved.valid = (0u == received_service_registry[i].entry.ttl) ? (FALSE) : (TRUE);
-            remote_service_to_be_saved.endpoint.ipv4_be = received_service_registry[i].option.IPv4_address;
-            remote_service_to_be_saved.endpoint.port_be = received_service_registry[i].option.port_number;
-
-            if (FALSE == SI_SD_PROVIDER_allocate_service__soft(&remote_service_to_be_saved, &remote_service))
+            record.expiry_sec = SI_SD_SNAPSHOT_EXPIRY_INFINITE;
+        }
+        else
+        {
+            remaining_sec = (SI_TIMERWHEEL_remaining_ms(&g_ttl_wheel, &(remote_service->expiry)) / 1000u) +
+                            remote_service->expiry_overflow_sec;
+            if ((0u == remaining_sec) || ((SI_SD_SNAPSHOT_EXPIRY_INFINITE - now_sec) <= remaining_sec))
             {
-                remote_service = SI_SD_PROVIDER_allocate_service__force(&remote_service_to_be_saved);
+                continue;
             }
+            record.expiry_sec = now_sec + remaining_sec;
+        }
 
-            if (NULLPTR != remote_service)
-            {
-                *remote_service = remote_service_to_be_saved;
+        record.service_id = remote_service->service_id;
+        record.instance_id = remote_service->instance_id;
+        record.major = remote_service->major;
+        record.minor = remote_service->minor;
+        record.endpoint = remote_service->endpoint;
+        record.peer_ipv4_be = remote_service->peer_ipv4_be;
+        SI_SD_SNAPSHOT_serialize_record(&record, &(buffer[SI_SD_SNAPSHOT_SIZE(records_num)]));
+        records_num += 1u;
+    }
+    SI_SD_CFG_REMOTE_REGISTRY_UNLOCK();
 
-                received_service_registry[i].used = FALSE;
-            }
-            else
-            {
-                ERH_report_error(ERH_UNREACHABLE_CODE, 0u, 0u, 0u, 0u, 0u, 0u);
-            }
+    SI_SD_SNAPSHOT_write_header(buffer, records_num);
+    return SI_SD_SNAPSHOT_SIZE(records_num);
+}
+
+/**
+ * Restores services of a snapshot (see SI_SD_PROVIDER_save_snapshot()) as if their offers were received again
+ * with the TTL still left. They are usable at once and revalidated by the following offers:
+ * refreshed, stopped or expired as usual. Expired records and services already in the registry are skipped.
+ * Call it after SI_SD_PROVIDER_init().
+ *
+ * @param now_sec: current time of the clock the snapshot was saved with [sec]
+ *
+ * @returns number of restored services, 0u if snapshot is invalid
+ */
+uint32 SI_SD_PROVIDER_load_snapshot(const uint8* buffer, uint32 length, uint32 now_sec)
+{
+    uint32 i = 0u;
+    uint32 records_num = 0u;
+    uint32 restored = 0u;
+    uint32 ttl = 0u;
+    struct SI_SD_SNAPSHOT_record record;
+    struct SI_SD_ServiceEntry entry;
+    struct SI_SD_IPv4EndpointOption option;
+
+    if (FALSE == SI_SD_SNAPSHOT_read_header(buffer, length, &records_num))
+    {
+        ERH_report_error(ERH_SD_SNAPSHOT_INVALID, length, 0u, 0u, 0u, 0u, 0u);
+        return 0u;
+    }
+
+    SI_SD_CFG_REMOTE_REGISTRY_LOCK();
+    // Least recently offered first, so the LRU order of the saved registry is restored
+    for (i = records_num; 0u < i; i--)
+    {
+        SI_SD_SNAPSHOT_deserialize_record(&(buffer[SI_SD_SNAPSHOT_SIZE(i - 1u)]), &record);
+
+        if (SI_SD_SNAPSHOT_EXPIRY_INFINITE == record.expiry_sec)
+        {
+            ttl = SI_SD_CONST_TTL_INFINITE;
+        }
+        else if (record.expiry_sec <= now_sec)
+        {
+            continue;
+        }
+        else
+        {
+            ttl = record.expiry_sec - now_sec;
+            ttl = (SI_SD_CONST_TTL_INFINITE <= ttl) ? (SI_SD_CONST_TTL_INFINITE - 1u) : (ttl);
         }
+
+        if ((NULLPTR != SI_SD_PROVIDER_find_service(record.service_id, record.instance_id, record.major)) ||
+            (FALSE == SI_SD_PAYLOAD_create_single_entry(SD_EntryTypes_Offer, 0u, 0u, 1u, 0u, record.service_id, record.instance_id,
+                                                        record.major, ttl, record.minor, &entry)) ||
+            (FALSE == SI_SD_PAYLOAD_create_option(SI_SD_CONST_IPV4_OPTION_LENGTH, SD_OptionTypes_IPV4_ENDPOINT, FALSE,
+                                                  lwip_ntohl(record.endpoint.ipv4_be), SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP,
+                                                  lwip_ntohs(record.endpoint.port_be), &option)))
+        {
+            continue;
+        }
+
+        SI_SD_PROVIDER_update_registry(&entry, &option, record.peer_ipv4_be);
+        restored += 1u;
     }
+    SI_SD_CFG_REMOTE_REGISTRY_UNLOCK();
+
+    SI_SD_WATCH_dispatch();
+    return restored;
 }
 
 /**
  * SOME/IP-SD handler
  * 
- * Searches a service with given parameters in remote service registry. Uses linear search.
+ * Searches a service with given parameters in remote service registry. Uses the hash index.
  * @param sd_context: struct SD_Context service_discovery_context, the "brain" of SOME/IP-SD.
  * @param service_id: Service ID of requested service instance
  * @param instance_id: Instance ID of requested service instance
  * @param major: Major version number of requested service instance
  * 
  * @returns pointer for remote service instance, NULLPTR if service was not found
+ *
+ * @note Element may be released or reused by a parallel SD worker once the registry lock is released,
+ *       check its generation (see SI_SD_binding.c) or use SI_SD_PROVIDER_resolve_service().
  */
 struct SD_remote_Service* SI_SD_PROVIDER_lookup_service(uint16 service_id,
                                                               uint16 instance_id,
                                                               uint8 major)
 {
-    uint16 i = 0u;
+    struct SD_remote_Service* remote_service = NULLPTR;
+
+    SI_SD_CFG_REMOTE_REGISTRY_LOCK();
+    remote_service = SI_SD_PROVIDER_find_service(service_id, instance_id, major);
+    SI_SD_CFG_REMOTE_REGISTRY_UNLOCK();
+
+    return remote_service;
+}
 
-    for (i = 0; i < SI_SD_CFG_MAX_REMOTE_SERVICES; ++i)
+/**
+ * Searches a service in remote service registry and copies its endpoint and generation atomically
+ * (under the registry lock), so the copy is consistent even if an SD worker updates the offer meanwhile.
+ *
+ * @param out_endpoint: endpoint of the service instance (network order)
+ * @param out_generation: generation of the offer, see struct SD_remote_Service
+ *
+ * @returns pointer for remote service instance, NULLPTR if service was not found (outputs are not written)
+ */
+struct SD_remote_Service* SI_SD_PROVIDER_resolve_service(uint16 service_id, uint16 instance_id, uint8 major,
+                                                         struct SD_Endpoint* out_endpoint, uint32* out_generation)
+{
+    struct SD_remote_Service* remote_service = NULLPTR;
+
+    if ((NULLPTR == out_endpoint) || (NULLPTR == out_generation))
     {
-        if (TRUE == SI_SD_PROVIDER_service_match(&(remote_service_registry[i]), service_id, instance_id, major))
-        {
-            return &remote_service_registry[i];
-        }
+        return NULLPTR;
     }
 
-    return NULLPTR;
+    SI_SD_CFG_REMOTE_REGISTRY_LOCK();
+    remote_service = SI_SD_PROVIDER_find_service(service_id, instance_id, major);
+    if (NULLPTR != remote_service)
+    {
+        *out_endpoint = remote_service->endpoint;
+        *out_generation = remote_service->generation;
+    }
+    SI_SD_CFG_REMOTE_REGISTRY_UNLOCK();
+
+    return remote_service;
 }
 
 /**
- * Timekeeping: increment ttl_timebase.
+ * Timekeeping: expires remote services whose TTL elapsed, runs the subscription timers
+ * and the offer state machines of local services.
+ * Registry, subscriptions and offers are shared by every SD instance, so their time runs only for the instance
+ * given to SI_SD_PROVIDER_init(): local services are offered through it. Calls with other instances are ignored,
+ * SD workers of further interfaces (see SI_SD_PROCESS_receive()) do not need a tick of their own.
  * @note Call this in every cycle!
+ *
+ * @param elapsed_time_ms: time elapsed since the previous call [ms]
+ */
+void SI_SD_PROVIDER_tick_ms(struct SD_Context *sd_context, const uint32 elapsed_time_ms)
+{
+    uint32 elapsed_time_sec = 0u;
+
+    if ((NULLPTR == sd_context) || (g_sd_context != sd_context))
+    {
+        return;
+    }
+
+    SI_SD_CFG_REMOTE_REGISTRY_LOCK();
+    SI_TIMERWHEEL_advance(&g_ttl_wheel, elapsed_time_ms);
+    SI_SD_CFG_REMOTE_REGISTRY_UNLOCK();
+    SI_SD_WATCH_dispatch();
+
+    g_ttl_remainder_ms += elapsed_time_ms;
+    elapsed_time_sec = (g_ttl_remainder_ms / 1000u);
+    g_ttl_remainder_ms -= (elapsed_time_sec * 1000u);
+
+    SI_SD_SUBSCRIPTION_tick(elapsed_time_sec);
+    SI_SD_OFFER_tick(sd_context, elapsed_time_ms);
+}
+
+/**
+ * Timekeeping with second resolution, see SI_SD_PROVIDER_tick_ms().
+ * @note Offer delays are shorter than a second, they are accurate only if SI_SD_PROVIDER_tick_ms() is called instead.
+ *
+ * @param elapsed_time_sec: time elapsed since the previous call [s]
  */
 void SI_SD_PROVIDER_tick(struct SD_Context *sd_context, const uint32 elapsed_time_sec)
 {
-    uint16 i = 0u;
+    SI_SD_PROVIDER_tick_ms(sd_context, elapsed_time_sec * 1000u);
+}
 
-    sd_context->ttl_timebase += elapsed_time_sec;
+/**
+ * @returns context given to SI_SD_PROVIDER_init(), NULLPTR if SD is not initialized
+ */
+struct SD_Context* SI_SD_PROVIDER_get_context(void)
+{
+    return g_sd_context;
+}
 
-    for (i = 0u; i < (uint16)SI_SD_CFG_MAX_REMOTE_SERVICES; i++)
+/**
+ * Completes the SD message built in payload and sends it through the transport handler of sd_context.
+ * @note Tx buffer is not released, call SI_SD_BUILDER_invalidate() afterwards.
+ *
+ * @param dst_ipv4_be: destination IP address (network order)
+ * @param dst_port_be: destination port number (network order)
+ * @param unicast: TRUE if message is sent to a single node (selects the session counter)
+ * @param payload: entries and options, see SI_SD_builder.h
+ *
+ * @returns TRUE if message is sent
+ */
+boolean SI_SD_PROVIDER_send(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be, boolean unicast,
+                            struct SI_SD_PayloadBuilder* payload)
+{
+    if ((NULLPTR == payload) || (FALSE == SI_SD_PROVIDER_serialize(payload)))
     {
-    	if (TRUE == remote_service_registry[i].valid)
-    	{
-    		remote_service_registry[i].ttl -= elapsed_time_sec;
-    	}
+        return FALSE;
     }
 
-    for (i = 0u; i < (uint16)SI_SD_CFG_MAX_REMOTE_SERVICES; i++)
+    return SI_SD_PROVIDER_send_serialized(sd_context, dst_ipv4_be, dst_port_be, unicast, payload->message.data, payload->message.length);
+}
+
+/**
+ * Completes the SD message built in payload without consuming a session ID.
+ * Session ID and flags are placeholders, they are filled by SI_SD_PROVIDER_send_serialized().
+ * The serialised message can be kept and sent any number of times.
+ *
+ * @returns TRUE if message is complete
+ */
+boolean SI_SD_PROVIDER_serialize(struct SI_SD_PayloadBuilder* payload)
+{
+    struct SD_Header header;
+
+    if ((NULLPTR == payload) || (FALSE == SI_SD_BUILDER_close(payload)))
     {
-        if (TRUE == SI_SD_PROVIDER_service_expired(sd_context, &(remote_service_registry[i])))
-        {
-            remote_service_registry[i].valid = FALSE; 
-        }
+        return FALSE;
     }
+
+    header.message_id.serviceID = SI_SD_CONST_SERVICE_ID;
+    header.message_id.methodID_or_eventID = SI_SD_CONST_METHOD_ID;
+    header.length = 0u;     // set by SI_SD_MESSAGE_finalize()
+    header.request_id.clientID = 0u;
+    header.request_id.sessionID = SD_Header_increment_sessionID(0u);
+    header.protocol_version = SI_SD_CONST_PROTO_VERSION;
+    header.interface_version = SI_SD_CONST_INTERFACE_VERSION;
+    header.message_type = SI_SD_CONST_MESSAGE_TYPE;
+    header.return_code = SI_SD_CONST_RETURN_CODE;
+    header.preamble = 0u;
+
+    return SI_SD_MESSAGE_finalize(&(payload->message), &header);
 }
 
-boolean SI_SD_PROVIDER_allocate_service__soft(struct SD_remote_Service* to_be_saved, struct SD_remote_Service **allocated_space)
+/**
+ * Patches the next session ID and the flags into a serialised SD message and sends it through the transport handler.
+ *
+ * @param datagram: complete SD message (see SI_SD_PROVIDER_serialize()), header is overwritten in place
+ * @param length: length of the complete SD message
+ *
+ * @returns TRUE if message is sent
+ */
+boolean SI_SD_PROVIDER_send_serialized(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be, boolean unicast,
+                                       uint8* datagram, uint32 length)
 {
-    if (NULLPTR == allocated_space)
+    uint16 session_id = 0u;
+    uint32 preamble = 0u;
+
+    if ((NULLPTR == sd_context) || (NULLPTR == sd_context->tx_handler.send) || (NULLPTR == datagram) ||
+        (SI_SD_CONST_HEADER_LENGTH > length))
     {
         return FALSE;
     }
 
-    *allocated_space = NULLPTR;
+    SI_SD_PROVIDER_next_session(sd_context, unicast, &session_id, &preamble);
+    SI_SD_WIRE_patch_header(datagram, session_id, preamble);
 
-    *allocated_space = SI_SD_PROVIDER_lookup_service(to_be_saved->service_id, to_be_saved->instance_id, to_be_saved->major);
-    if (NULLPTR != *allocated_space)
+    return sd_context->tx_handler.send(dst_ipv4_be, dst_port_be, datagram, length, sd_context->tx_user_ctx);
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+/**
+ * Applies a received offer to the remote service registry, see SI_SD_PROVIDER_apply_offer().
+ * @note Registry lock is held by the caller.
+ */
+static void SI_SD_PROVIDER_update_registry(const struct SI_SD_ServiceEntry* entry, const struct SI_SD_IPv4EndpointOption* option,
+                                           uint32 src_ipv4_be)
+{
+    struct SD_remote_Service *remote_service = NULLPTR;
+    const boolean has_endpoint = ((NULLPTR != option) && (SD_OptionTypes_IPV4_ENDPOINT == option->type));
+    struct SD_Endpoint endpoint = {0u, 0u};
+    boolean endpoint_changed = FALSE;
+
+    if (TRUE == has_endpoint)
     {
-        return TRUE;
+        // Option fields are decoded in host order, registry stores network order
+        endpoint.ipv4_be = lwip_htonl(option->IPv4_address);
+        endpoint.port_be = lwip_htons(option->port_number);
     }
 
-    *allocated_space = SI_SD_PROVIDER_alloc_free_service(to_be_saved->service_id, to_be_saved->instance_id, to_be_saved->major);
-    if (NULLPTR != *allocated_space)
+    remote_service = SI_SD_PROVIDER_find_service(entry->serviceID, entry->instanceID, entry->major_version);
+
+    /* If service is already in registry, update */
+    if (NULLPTR != remote_service)
     {
-        return TRUE;
+        endpoint_changed = ((TRUE == has_endpoint) &&
+                            ((remote_service->endpoint.ipv4_be != endpoint.ipv4_be) || (remote_service->endpoint.port_be != endpoint.port_be)));
+        if ((0u == entry->ttl) || (TRUE == endpoint_changed))
+        {
+            // Offer changed: cached endpoints of bindings are stale
+            remote_service->generation += 1u;
+        }
+
+        remote_service->ttl = entry->ttl;
+        if (0u == entry->ttl)
+        {
+            // StopOffer
+            SI_SD_PROVIDER_release(remote_service);
+            return;
+        }
+
+        SI_SD_PROVIDER_lru_remove((uint16)(remote_service - remote_service_registry));
+        SI_SD_PROVIDER_lru_push_front((uint16)(remote_service - remote_service_registry));
+        SI_SD_PROVIDER_arm_ttl(remote_service, entry->ttl);
+
+        if (TRUE == has_endpoint)
+        {
+            remote_service->endpoint = endpoint;
+        }
+        remote_service->peer_ipv4_be = src_ipv4_be;
+
+        if (TRUE == endpoint_changed)
+        {
+            SI_SD_WATCH_enqueue(SI_SD_WATCH_Event_ENDPOINT_CHANGED, remote_service, NULLPTR);
+        }
+        return;
+    }
+
+    /* If service is unkown, save it. StopOffer of an unknown service: nothing to remove */
+    if ((0u == entry->ttl) || (FALSE == has_endpoint))
+    {
+        return;
     }
-    return FALSE;
+
+    remote_service = SI_SD_PROVIDER_alloc_free_service(entry->serviceID, entry->instanceID, entry->major_version);
+    if (NULLPTR == remote_service)
+    {
+        remote_service = SI_SD_PROVIDER_alloc_used_service(entry->serviceID, entry->instanceID, entry->major_version);
+    }
+
+    if (NULLPTR == remote_service)
+    {
+        ERH_report_error(ERH_UNREACHABLE_CODE, 0u, 0u, 0u, 0u, 0u, 0u);
+        return;
+    }
+
+    // Element might be reused (evicted or expired), it describes a different offer from now on
+    remote_service->generation += 1u;
+    remote_service->minor = entry->minor_version;
+    remote_service->ttl = entry->ttl;
+    remote_service->endpoint = endpoint;
+    remote_service->peer_ipv4_be = src_ipv4_be;
+    SI_SD_PROVIDER_arm_ttl(remote_service, entry->ttl);
+    SI_SD_WATCH_enqueue(SI_SD_WATCH_Event_AVAILABLE, remote_service, NULLPTR);
 }
 
-struct SD_remote_Service* SI_SD_PROVIDER_allocate_service__force(struct SD_remote_Service* to_be_saved)
+/**
+ * @note Registry lock is held by the caller.
+ */
+static struct SD_remote_Service* SI_SD_PROVIDER_find_service(uint16 service_id, uint16 instance_id, uint8 major)
 {
-    struct SD_remote_Service* allocated_space = NULLPTR;
-    allocated_space = SI_SD_PROVIDER_alloc_used_service(to_be_saved->service_id, to_be_saved->instance_id, to_be_saved->major);
-    return allocated_space;
+    uint32 i = 0u;
+    const uint32 home = SI_SD_PROVIDER_home(service_id, instance_id, major);
+    uint16 slot = SI_SD_PROVIDER_NIL;
+
+    for (i = 0u; i < SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE; i++)
+    {
+        slot = g_index[(home + i) & (SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE - 1u)];
+
+        if (SI_SD_PROVIDER_NIL == slot)
+        {
+            // never used slot, end of probe sequence
+            return NULLPTR;
+        }
+
+        if ((SI_SD_PROVIDER_DELETED != slot) &&
+            (TRUE == SI_SD_PROVIDER_service_match(&(remote_service_registry[slot]), service_id, instance_id, major)))
+        {
+            return &remote_service_registry[slot];
+        }
+    }
+
+    return NULLPTR;
 }
 
-/* **************************************************** */
-/*             Local function definitions               */
-/* **************************************************** */
 
-static inline boolean SI_SD_PROVIDER_service_expired(struct SD_Context *sd_context, struct SD_remote_Service *service)
+/**
+ * Arms the expiry of service at ttl_sec from now. TTL 0 (StopOffer) and SI_SD_CONST_TTL_INFINITE disarm it.
+ */
+static void SI_SD_PROVIDER_arm_ttl(struct SD_remote_Service *service, uint32 ttl_sec)
 {
-    return ((TRUE == service->valid) &&
-            (0u != service->ttl) &&
-            (sd_context->ttl_timebase >= service->ttl));
+    uint32 armed_sec = ttl_sec;
+
+    service->expiry_overflow_sec = 0u;
+
+    if ((0u == ttl_sec) || (SI_SD_CONST_TTL_INFINITE == ttl_sec))
+    {
+        SI_TIMERWHEEL_cancel(&(service->expiry));
+        return;
+    }
+
+    if (SI_SD_PROVIDER_TTL_MAX_ARM_SEC < armed_sec)
+    {
+        armed_sec = SI_SD_PROVIDER_TTL_MAX_ARM_SEC;
+        service->expiry_overflow_sec = ttl_sec - armed_sec;
+    }
+
+    (void)SI_TIMERWHEEL_arm(&g_ttl_wheel, &(service->expiry), (armed_sec * 1000u), SI_SD_PROVIDER_service_timeout, service);
+}
+
+/**
+ * Timer wheel callback: deadline of the offer passed
+ */
+static void SI_SD_PROVIDER_service_timeout(void* context)
+{
+    struct SD_remote_Service *service = (struct SD_remote_Service*)context;
+
+    if (0u < service->expiry_overflow_sec)
+    {
+        SI_SD_PROVIDER_arm_ttl(service, service->expiry_overflow_sec);
+        return;
+    }
+
+    SI_SD_PROVIDER_release(service);
+    service->generation += 1u;
 }
 
 static inline boolean SI_SD_PROVIDER_service_match(struct SD_remote_Service *service,
@@ -277,6 +730,37 @@ static inline boolean SI_SD_PROVIDER_service_match(struct SD_remote_Service *ser
             (major == service->major));
 }
 
+/**
+ * Increments the session counter and computes the preamble of an outgoing SD message.
+ * Reboot flag is cleared once the session counter wrapped.
+ */
+static void SI_SD_PROVIDER_next_session(struct SD_Context *sd_context, boolean unicast, uint16* out_session_id, uint32* out_preamble)
+{
+    uint16* session_id = (TRUE == unicast) ? (&(sd_context->unicast_sessionID)) : (&(sd_context->multicast_sessionID));
+    uint32 flags = 0u;
+
+    SI_SD_CFG_SESSION_LOCK();
+    if (0xFFFFu == *session_id)
+    {
+        sd_context->reboot_flag = FALSE;
+    }
+    *session_id = SD_Header_increment_sessionID(*session_id);
+    *out_session_id = *session_id;
+
+    if (TRUE == sd_context->reboot_flag)
+    {
+        flags |= SI_SD_CONST_PREAMBLE_REBOOT_FLAG_MASK;
+    }
+    SI_SD_CFG_SESSION_UNLOCK();
+
+    if (TRUE == sd_context->unicast_supported)
+    {
+        flags |= SI_SD_CONST_PREAMBLE_UNICAST_FLAG_MASK;
+    }
+
+    *out_preamble = (flags << SI_SD_CONST_PREAMBLE_FLAGS_OFFS);
+}
+
 static inline boolean SI_SD_PROVIDER_set_tx_handler(struct SD_Context *sd, const struct SD_TransportHandler_vtable *tx_handler)
 {
     if (NULLPTR == tx_handler)
@@ -306,36 +790,183 @@ static inline uint16 SI_SD_PROVIDER_set_port(struct SD_Context *sd_context, cons
     return sd_port_be;
 }
 
+/**
+ * @returns free element linked into the index with the given key, NULLPTR if registry is full
+ */
 static struct SD_remote_Service* SI_SD_PROVIDER_alloc_free_service(uint16 service_id, uint16 instance_id, uint8 major)
 {
-    uint16 i = 0u;
+    struct SD_remote_Service* service = NULLPTR;
 
-    for (i = 0; i < (uint16)SI_SD_CFG_MAX_REMOTE_SERVICES; i++)
+    if (SI_SD_PROVIDER_NIL == g_free_head)
     {
-        if (FALSE == remote_service_registry[i].valid)
+        return NULLPTR;
+    }
+
+    service = &(remote_service_registry[g_free_head]);
+    g_free_head = service->lru_next;
+
+    service->service_id = service_id;
+    service->instance_id = instance_id;
+    service->major = major;
+    SI_SD_PROVIDER_link(service);
+    return service;
+}
+
+/**
+ * Evicts the least recently offered service and relinks its element with the given key
+ */
+static struct SD_remote_Service* SI_SD_PROVIDER_alloc_used_service(uint16 service_id, uint16 instance_id, uint8 major)
+{
+    struct SD_remote_Service* service = NULLPTR;
+
+    if (SI_SD_PROVIDER_NIL == g_lru_tail)
+    {
+        return NULLPTR;
+    }
+
+    service = &(remote_service_registry[g_lru_tail]);
+    SI_SD_PROVIDER_unlink(service);
+
+    service->service_id = service_id;
+    service->instance_id = instance_id;
+    service->major = major;
+    SI_SD_PROVIDER_link(service);
+    return service;
+}
+
+static inline uint32 SI_SD_PROVIDER_home(uint16 service_id, uint16 instance_id, uint8 major)
+{
+    const uint32 hash = SI_HASH_combine(SI_HASH_u32(((uint32)service_id << 16u) | (uint32)instance_id), (uint32)major);
+    return (hash & (SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE - 1u));
+}
+
+/**
+ * Inserts the element into the hash index and to the front of the LRU list, element becomes valid
+ */
+static void SI_SD_PROVIDER_link(struct SD_remote_Service *service)
+{
+    uint32 i = 0u;
+    uint32 position = 0u;
+    const uint32 home = SI_SD_PROVIDER_home(service->service_id, service->instance_id, service->major);
+    const uint16 index = (uint16)(service - remote_service_registry);
+
+    for (i = 0u; i < SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE; i++)
+    {
+        position = (home + i) & (SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE - 1u);
+
+        if ((SI_SD_PROVIDER_NIL == g_index[position]) || (SI_SD_PROVIDER_DELETED == g_index[position]))
         {
-            return (&(remote_service_registry[i]));
+            g_index[position] = index;
+            g_index_count += 1u;
+            service->valid = TRUE;
+            SI_SD_PROVIDER_lru_push_front(index);
+            return;
         }
     }
-    return NULLPTR;
+
+    // Index is bigger than the registry, there is always a free slot
+    ERH_report_error(ERH_UNREACHABLE_CODE, 0u, 0u, 0u, 0u, 0u, 0u);
 }
 
-static struct SD_remote_Service* SI_SD_PROVIDER_alloc_used_service(uint16 service_id, uint16 instance_id, uint8 major)
+/**
+ * Removes the element from the hash index and the LRU list, disarms its expiry. Element becomes invalid.
+ */
+static void SI_SD_PROVIDER_unlink(struct SD_remote_Service *service)
 {
-    uint16 i = 0u;
-    uint16 evict = 0u;
-    uint32 best = remote_service_registry[0].ttl;
+    uint32 i = 0u;
+    uint32 position = 0u;
+    const uint32 home = SI_SD_PROVIDER_home(service->service_id, service->instance_id, service->major);
+    const uint16 index = (uint16)(service - remote_service_registry);
 
-    // Evict the one with nearest expiry
-    for (i = 1u; i < (uint16)SI_SD_CFG_MAX_REMOTE_SERVICES; i++) 
+    if (FALSE == service->valid)
     {
-        if (remote_service_registry[i].ttl < best) 
+        return;
+    }
+
+    // Every removal of an offer passes here: StopOffer, expiry, reboot of the offering node, eviction
+    SI_SD_WATCH_enqueue(SI_SD_WATCH_Event_UNAVAILABLE, service, NULLPTR);
+
+    for (i = 0u; i < SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE; i++)
+    {
+        position = (home + i) & (SI_SD_CFG_REMOTE_SERVICE_INDEX_SIZE - 1u);
+
+        if (index == g_index[position])
         {
-            best = remote_service_registry[i].ttl;
-            evict = i;
+            g_index[position] = SI_SD_PROVIDER_DELETED;
+            g_index_count -= 1u;
+            break;
         }
     }
-    return (&(remote_service_registry[evict]));
+
+    if (0u == g_index_count)
+    {
+        // No service: deleted markers can be dropped, probe sequences become short again
+        memset(g_index, 0xFF, sizeof(g_index));
+    }
+
+    SI_SD_PROVIDER_lru_remove(index);
+    SI_TIMERWHEEL_cancel(&(service->expiry));
+    service->expiry_overflow_sec = 0u;
+    service->valid = FALSE;
+}
+
+/**
+ * Unlinks the element and returns it to the free list
+ */
+static void SI_SD_PROVIDER_release(struct SD_remote_Service *service)
+{
+    if (FALSE == service->valid)
+    {
+        return;
+    }
+
+    SI_SD_PROVIDER_unlink(service);
+    service->lru_next = g_free_head;
+    g_free_head = (uint16)(service - remote_service_registry);
+}
+
+static void SI_SD_PROVIDER_lru_remove(uint16 index)
+{
+    struct SD_remote_Service *service = &(remote_service_registry[index]);
+
+    if (SI_SD_PROVIDER_NIL != service->lru_prev)
+    {
+        remote_service_registry[service->lru_prev].lru_next = service->lru_next;
+    }
+    else
+    {
+        g_lru_head = service->lru_next;
+    }
+
+    if (SI_SD_PROVIDER_NIL != service->lru_next)
+    {
+        remote_service_registry[service->lru_next].lru_prev = service->lru_prev;
+    }
+    else
+    {
+        g_lru_tail = service->lru_prev;
+    }
+
+    service->lru_prev = SI_SD_PROVIDER_NIL;
+    service->lru_next = SI_SD_PROVIDER_NIL;
+}
+
+static void SI_SD_PROVIDER_lru_push_front(uint16 index)
+{
+    struct SD_remote_Service *service = &(remote_service_registry[index]);
+
+    service->lru_prev = SI_SD_PROVIDER_NIL;
+    service->lru_next = g_lru_head;
+
+    if (SI_SD_PROVIDER_NIL != g_lru_head)
+    {
+        remote_service_registry[g_lru_head].lru_prev = index;
+    }
+    else
+    {
+        g_lru_tail = index;
+    }
+    g_lru_head = index;
 }
 
 /* END OF SI_SD_HANDLER.C FILE */
@@ -0,0 +1,142 @@
+/**
+ * @file    SI_SD_snapshot.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_SD_snapshot.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_SD_snapshot.h"
+
+#include "lwip/def.h"       // for lwip_htonl, lwip_ntohl, lwip_htons, lwip_ntohs
+#include "SI_types.h"
+#include "SI_endian.h"
+#include "SI_hash.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static uint32 SI_SD_SNAPSHOT_checksum(const uint8* records, uint32 length);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Completes the snapshot: writes the header in front of the records already serialised behind it.
+ *
+ * @param out_buffer: beginning of the snapshot, records_num records follow the header
+ */
+void SI_SD_SNAPSHOT_write_header(uint8* out_buffer, uint32 records_num)
+{
+    u32_to_u8array(&(out_buffer[0u]), SI_SD_SNAPSHOT_MAGIC);
+    u16_to_u8array(&(out_buffer[4u]), SI_SD_SNAPSHOT_VERSION);
+    u16_to_u8array(&(out_buffer[6u]), SI_SD_SNAPSHOT_RECORD_SIZE);
+    u32_to_u8array(&(out_buffer[8u]), records_num);
+    u32_to_u8array(&(out_buffer[12u]), SI_SD_SNAPSHOT_checksum(&(out_buffer[SI_SD_SNAPSHOT_HEADER_SIZE]),
+                                                               (records_num * SI_SD_SNAPSHOT_RECORD_SIZE)));
+}
+
+/**
+ * Validates a snapshot: format, version, length and checksum
+ *
+ * @returns FALSE if the snapshot cannot be used
+ */
+boolean SI_SD_SNAPSHOT_read_header(const uint8* buffer, uint32 length, uint32* out_records_num)
+{
+    uint32 records_num = 0u;
+
+    if ((NULLPTR == buffer) || (NULLPTR == out_records_num) || (SI_SD_SNAPSHOT_HEADER_SIZE > length))
+    {
+        return FALSE;
+    }
+
+    if ((SI_SD_SNAPSHOT_MAGIC != u8array_to_u32(&(buffer[0u]))) ||
+        (SI_SD_SNAPSHOT_VERSION != u8array_to_u16(&(buffer[4u]))) ||
+        (SI_SD_SNAPSHOT_RECORD_SIZE != u8array_to_u16(&(buffer[6u]))))
+    {
+        return FALSE;
+    }
+
+    // IMPORTANT: length is checked by division in order to prevent issues due to unsigned integer overflow
+    records_num = u8array_to_u32(&(buffer[8u]));
+    if (((length - SI_SD_SNAPSHOT_HEADER_SIZE) / SI_SD_SNAPSHOT_RECORD_SIZE) < records_num)
+    {
+        return FALSE;
+    }
+
+    if (u8array_to_u32(&(buffer[12u])) !=
+        SI_SD_SNAPSHOT_checksum(&(buffer[SI_SD_SNAPSHOT_HEADER_SIZE]), (records_num * SI_SD_SNAPSHOT_RECORD_SIZE)))
+    {
+        return FALSE;
+    }
+
+    *out_records_num = records_num;
+    return TRUE;
+}
+
+void SI_SD_SNAPSHOT_serialize_record(const struct SI_SD_SNAPSHOT_record* in_record, uint8* out_record)
+{
+    u16_to_u8array(&(out_record[0u]), in_record->service_id);
+    u16_to_u8array(&(out_record[2u]), in_record->instance_id);
+    out_record[4u] = in_record->major;
+    out_record[5u] = 0u;
+    out_record[6u] = 0u;
+    out_record[7u] = 0u;
+    u32_to_u8array(&(out_record[8u]), in_record->minor);
+    u32_to_u8array(&(out_record[12u]), lwip_ntohl(in_record->endpoint.ipv4_be));
+    u16_to_u8array(&(out_record[16u]), lwip_ntohs(in_record->endpoint.port_be));
+    u16_to_u8array(&(out_record[18u]), 0u);
+    u32_to_u8array(&(out_record[20u]), lwip_ntohl(in_record->peer_ipv4_be));
+    u32_to_u8array(&(out_record[24u]), in_record->expiry_sec);
+}
+
+void SI_SD_SNAPSHOT_deserialize_record(const uint8* in_record, struct SI_SD_SNAPSHOT_record* out_record)
+{
+    out_record->service_id = u8array_to_u16(&(in_record[0u]));
+    out_record->instance_id = u8array_to_u16(&(in_record[2u]));
+    out_record->major = in_record[4u];
+    out_record->minor = u8array_to_u32(&(in_record[8u]));
+    out_record->endpoint.ipv4_be = lwip_htonl(u8array_to_u32(&(in_record[12u])));
+    out_record->endpoint.port_be = lwip_htons(u8array_to_u16(&(in_record[16u])));
+    out_record->peer_ipv4_be = lwip_htonl(u8array_to_u32(&(in_record[20u])));
+    out_record->expiry_sec = u8array_to_u32(&(in_record[24u]));
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static uint32 SI_SD_SNAPSHOT_checksum(const uint8* records, uint32 length)
+{
+    uint32 i = 0u;
+    uint32 hash = SI_SD_SNAPSHOT_MAGIC;
+
+    for (i = 0u; i < length; i++)
+    {
+        hash = SI_HASH_combine(hash, records[i]);
+    }
+    return hash;
+}
+
+/* END OF SI_SD_SNAPSHOT.C FILE */
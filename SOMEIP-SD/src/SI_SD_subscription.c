@@ -0,0 +1,511 @@
+/**
+ * @file    SI_SD_subscription.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_SD_subscription.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_SD_subscription.h"
+
+#include <assert.h>
+#include <string.h>         // for memset
+
+#include "lwip/def.h"       // for lwip_htonl, lwip_ntohl
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_hash.h"
+#include "SI_event.h"
+
+#include "SI_SD_const.h"
+#include "SI_SD_config.h"
+#include "SI_SD_payload.h"
+#include "SI_SD_builder.h"
+#include "SI_SD_service_manager.h"
+
+static_assert(SI_HASH_IS_POWER_OF_TWO(SI_SD_CFG_MAX_SUBSCRIPTIONS), "FATAL ERROR: SI_SD_CFG_MAX_SUBSCRIPTIONS must be a power of two!");
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SD_Subscription g_subscriptions[SI_SD_CFG_MAX_SUBSCRIPTIONS];
+static uint32 g_subscription_count = 0u;
+static struct SI_SD_SUBSCRIPTION_counters g_counters;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static inline uint32 SI_SD_SUBSCRIPTION_home(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4_be, uint16 port);
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+static struct SD_Subscription* SI_SD_SUBSCRIPTION_insert(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4_be, uint16 port);
+#endif
+static void SI_SD_SUBSCRIPTION_release(struct SD_Subscription* subscription);
+static void SI_SD_SUBSCRIPTION_remove(struct SD_Subscription* subscription);
+static boolean SI_SD_SUBSCRIPTION_get_endpoint(const struct SI_SD_IPv4EndpointOption* option, uint32* out_ipv4_be, uint16* out_port);
+static boolean SI_SD_SUBSCRIPTION_accept(const struct SI_SD_EventgroupEntry* entry, uint32 ipv4_be, uint16 port, uint32 peer_ipv4_be,
+                                         boolean* out_new);
+static boolean SI_SD_SUBSCRIPTION_handle_subscribe(struct SD_Context *sd_context, const struct SI_SD_EventgroupEntry* entry,
+                                                   const struct SI_SD_IPv4EndpointOption* option, uint32 src_ipv4_be, uint16 src_port_be,
+                                                   uint32 peer_ipv4_be, uint32* out_ipv4_be, uint16* out_port);
+static boolean SI_SD_SUBSCRIPTION_send(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be,
+                                       const struct SI_SD_EventgroupEntry* entry, const struct SI_SD_IPv4EndpointOption* option);
+static boolean SI_SD_SUBSCRIPTION_send_ack(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be,
+                                           const struct SI_SD_EventgroupEntry* subscribe, boolean accepted);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Processes a received Eventgroup Entry (see SI_SD_PARSER_parse_payload()).
+ * Subscribe entries are answered with SubscribeAck / SubscribeNack sent back to the sender.
+ * A new subscriber gets the initial values of fields after the SubscribeAck (see SI_EVENT_announce_subscriber()).
+ *
+ * @param option: IPv4 Endpoint option referenced by the entry, NULLPTR if there is none
+ * @param src_ipv4_be: SD address of the sender, acknowledgements are sent to it (network order)
+ * @param src_port_be: SD port of the sender (network order)
+ * @param peer_ipv4_be: source address of the SD message (network order), see SI_SD_SUBSCRIPTION_remove_peer()
+ */
+void SI_SD_SUBSCRIPTION_apply(struct SD_Context *sd_context, const struct SI_SD_EventgroupEntry* entry,
+                              const struct SI_SD_IPv4EndpointOption* option, uint32 src_ipv4_be, uint16 src_port_be,
+                              uint32 peer_ipv4_be)
+{
+    boolean new_subscriber = FALSE;
+    uint32 ipv4_be = 0u;
+    uint16 port = 0u;
+
+    if (NULLPTR == entry)
+    {
+        return;
+    }
+
+    SI_SD_CFG_SUBSCRIPTION_LOCK();
+    if (SD_EntryTypes_Subscribe == entry->type)
+    {
+        new_subscriber = SI_SD_SUBSCRIPTION_handle_subscribe(sd_context, entry, option, src_ipv4_be, src_port_be, peer_ipv4_be,
+                                                             &ipv4_be, &port);
+    }
+    else if (SD_EntryTypes_SubscribeAck == entry->type)
+    {
+        if (0u == entry->ttl)
+        {
+            g_counters.nacks_received += 1u;
+        }
+        else
+        {
+            g_counters.acks_received += 1u;
+        }
+    }
+    SI_SD_CFG_SUBSCRIPTION_UNLOCK();
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+    // Acknowledged: initial values are sent outside of the subscription lock
+    if (TRUE == new_subscriber)
+    {
+        (void)SI_EVENT_announce_subscriber(entry->serviceID, entry->instanceID, entry->eventgroupID, ipv4_be, port);
+    }
+#endif
+    (void)new_subscriber;
+}
+
+/**
+ * @param ipv4_be: address of the subscriber (network order)
+ * @param port: port of the subscriber (host order)
+ *
+ * @returns subscription with the given key, NULLPTR if there is none
+ *
+ * @note Not guarded, SD workers may modify the table meanwhile: take SI_SD_CFG_SUBSCRIPTION_LOCK() around the call
+ *       and the use of the result if received SD messages are processed in parallel.
+ */
+struct SD_Subscription* SI_SD_SUBSCRIPTION_find(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4_be, uint16 port)
+{
+    uint32 i = 0u;
+    const uint32 index = SI_SD_SUBSCRIPTION_home(service_id, instance_id, eventgroup_id, ipv4_be, port);
+    struct SD_Subscription* subscription = NULLPTR;
+
+    for (i = 0u; i < SI_SD_CFG_MAX_SUBSCRIPTIONS; i++)
+    {
+        subscription = &(g_subscriptions[(index + i) & (SI_SD_CFG_MAX_SUBSCRIPTIONS - 1u)]);
+
+        if ((FALSE == subscription->valid) && (FALSE == subscription->deleted))
+        {
+            // never used slot, end of probe sequence
+            return NULLPTR;
+        }
+
+        if ((TRUE == subscription->valid) &&
+            (service_id == subscription->service_id) && (instance_id == subscription->instance_id) &&
+            (eventgroup_id == subscription->eventgroup_id) && (ipv4_be == subscription->ipv4_be) && (port == subscription->port))
+        {
+            return subscription;
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * Subscribes this node to an eventgroup of a remote service instance (client side).
+ *
+ * @param dst_ipv4_be: SD address of the remote node (network order)
+ * @param dst_port_be: SD port of the remote node (network order)
+ * @param ttl: [sec] lifetime of the subscription, 0u sends StopSubscribe
+ * @param local_ipv4_be: address the events are expected on (network order)
+ * @param local_port: port the events are expected on (host order)
+ *
+ * @returns TRUE if Subscribe entry is sent
+ */
+boolean SI_SD_SUBSCRIPTION_subscribe(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be,
+                                     uint16 service_id, uint16 instance_id, uint8 major, uint16 eventgroup_id,
+                                     uint32 ttl, uint32 local_ipv4_be, uint16 local_port)
+{
+    struct SI_SD_EventgroupEntry entry;
+    struct SI_SD_IPv4EndpointOption option;
+
+    if ((FALSE == SI_SD_PAYLOAD_create_eventgroup_entry(SD_EntryTypes_Subscribe, 0u, 1u, service_id, instance_id,
+                                                        major, ttl, 0u, eventgroup_id, &entry)) ||
+        (FALSE == SI_SD_PAYLOAD_create_option(SI_SD_CONST_IPV4_OPTION_LENGTH, SD_OptionTypes_IPV4_ENDPOINT, FALSE,
+                                              lwip_ntohl(local_ipv4_be), SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP, local_port, &option)))
+    {
+        return FALSE;
+    }
+
+    return SI_SD_SUBSCRIPTION_send(sd_context, dst_ipv4_be, dst_port_be, &entry, &option);
+}
+
+/**
+ * Timekeeping: removes subscriptions whose TTL elapsed.
+ * @note Called by SI_SD_PROVIDER_tick_ms().
+ */
+void SI_SD_SUBSCRIPTION_tick(const uint32 elapsed_time_sec)
+{
+    uint32 i = 0u;
+    struct SD_Subscription* subscription = NULLPTR;
+
+    SI_SD_CFG_SUBSCRIPTION_LOCK();
+    for (i = 0u; (i < SI_SD_CFG_MAX_SUBSCRIPTIONS) && (0u < g_subscription_count); i++)
+    {
+        subscription = &(g_subscriptions[i]);
+
+        if ((FALSE == subscription->valid) || (SI_SD_SUBSCRIPTION_TTL_INFINITE == subscription->ttl))
+        {
+            continue;
+        }
+
+        if (subscription->ttl <= elapsed_time_sec)
+        {
+            SI_SD_SUBSCRIPTION_remove(subscription);
+            g_counters.expired += 1u;
+        }
+        else
+        {
+            subscription->ttl -= elapsed_time_sec;
+        }
+    }
+    SI_SD_CFG_SUBSCRIPTION_UNLOCK();
+}
+
+/**
+ * Removes every subscription of a rebooted node at once, events are not sent to it until it subscribes again.
+ *
+ * @param peer_ipv4_be: address of the node (network order), compared to the SD address the subscriptions came from
+ */
+void SI_SD_SUBSCRIPTION_remove_peer(uint32 peer_ipv4_be)
+{
+    uint32 i = 0u;
+    struct SD_Subscription* subscription = NULLPTR;
+
+    SI_SD_CFG_SUBSCRIPTION_LOCK();
+    for (i = 0u; (i < SI_SD_CFG_MAX_SUBSCRIPTIONS) && (0u < g_subscription_count); i++)
+    {
+        subscription = &(g_subscriptions[i]);
+
+        if ((TRUE == subscription->valid) && (peer_ipv4_be == subscription->peer_ipv4_be))
+        {
+            SI_SD_SUBSCRIPTION_remove(subscription);
+            g_counters.peer_rebooted += 1u;
+        }
+    }
+    SI_SD_CFG_SUBSCRIPTION_UNLOCK();
+}
+
+uint32 SI_SD_SUBSCRIPTION_get_count(void)
+{
+    return g_subscription_count;
+}
+
+void SI_SD_SUBSCRIPTION_get_counters(struct SI_SD_SUBSCRIPTION_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static inline uint32 SI_SD_SUBSCRIPTION_home(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4_be, uint16 port)
+{
+    const uint32 hash = SI_HASH_combine(SI_HASH_combine(SI_HASH_u32(((uint32)service_id << 16u) | (uint32)instance_id),
+                                                        ((uint32)eventgroup_id << 16u) | (uint32)port),
+                                        ipv4_be);
+    return (hash & (SI_SD_CFG_MAX_SUBSCRIPTIONS - 1u));
+}
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+/**
+ * @returns Reserved element, NULLPTR if table is full
+ */
+static struct SD_Subscription* SI_SD_SUBSCRIPTION_insert(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4_be, uint16 port)
+{
+    uint32 i = 0u;
+    const uint32 index = SI_SD_SUBSCRIPTION_home(service_id, instance_id, eventgroup_id, ipv4_be, port);
+    struct SD_Subscription* subscription = NULLPTR;
+
+    if (SI_SD_CFG_MAX_SUBSCRIPTIONS <= g_subscription_count)
+    {
+        return NULLPTR;
+    }
+
+    for (i = 0u; i < SI_SD_CFG_MAX_SUBSCRIPTIONS; i++)
+    {
+        subscription = &(g_subscriptions[(index + i) & (SI_SD_CFG_MAX_SUBSCRIPTIONS - 1u)]);
+
+        if (FALSE == subscription->valid)
+        {
+            subscription->valid = TRUE;
+            subscription->deleted = FALSE;
+            subscription->service_id = service_id;
+            subscription->instance_id = instance_id;
+            subscription->eventgroup_id = eventgroup_id;
+            subscription->ipv4_be = ipv4_be;
+            subscription->port = port;
+            subscription->peer_ipv4_be = 0u;
+            subscription->ttl = 0u;
+            g_subscription_count += 1u;
+            return subscription;
+        }
+    }
+    return NULLPTR;
+}
+#endif
+
+static void SI_SD_SUBSCRIPTION_release(struct SD_Subscription* subscription)
+{
+    subscription->valid = FALSE;
+    subscription->deleted = TRUE;
+    g_subscription_count -= 1u;
+
+    if (0u == g_subscription_count)
+    {
+        // No subscription: deleted markers can be dropped, probe sequences become short again
+        memset(g_subscriptions, 0, sizeof(g_subscriptions));
+    }
+}
+
+/**
+ * Removes the subscriber from the event publisher, then releases the subscription
+ */
+static void SI_SD_SUBSCRIPTION_remove(struct SD_Subscription* subscription)
+{
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+    (void)SI_EVENT_unsubscribe(subscription->service_id, subscription->instance_id, subscription->eventgroup_id,
+                               subscription->ipv4_be, subscription->port);
+#endif
+    SI_SD_SUBSCRIPTION_release(subscription);
+}
+
+/**
+ * Subscriber endpoint is given by the IPv4 Endpoint option of the entry (only UDP is supported)
+ */
+static boolean SI_SD_SUBSCRIPTION_get_endpoint(const struct SI_SD_IPv4EndpointOption* option, uint32* out_ipv4_be, uint16* out_port)
+{
+    if ((NULLPTR == option) ||
+        (SD_OptionTypes_IPV4_ENDPOINT != option->type) ||
+        (SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP != option->l4_proto))
+    {
+        return FALSE;
+    }
+
+    *out_ipv4_be = lwip_htonl(option->IPv4_address);
+    *out_port = option->port_number;
+    return TRUE;
+}
+
+/**
+ * Creates or renews the subscription of a local eventgroup.
+ *
+ * @param peer_ipv4_be: SD node the Subscribe entry came from (network order)
+ * @param out_new: TRUE if subscriber is new (not a renewal)
+ *
+ * @returns TRUE if subscription is stored
+ */
+static boolean SI_SD_SUBSCRIPTION_accept(const struct SI_SD_EventgroupEntry* entry, uint32 ipv4_be, uint16 port, uint32 peer_ipv4_be,
+                                         boolean* out_new)
+{
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+    struct SD_Subscription* subscription = NULLPTR;
+
+    *out_new = FALSE;
+
+    if (NULLPTR == SI_EVENT_find_eventgroup(entry->serviceID, entry->instanceID, entry->eventgroupID))
+    {
+        return FALSE;
+    }
+
+    subscription = SI_SD_SUBSCRIPTION_find(entry->serviceID, entry->instanceID, entry->eventgroupID, ipv4_be, port);
+    if (NULLPTR != subscription)
+    {
+        subscription->peer_ipv4_be = peer_ipv4_be;
+        subscription->ttl = entry->ttl;
+        g_counters.renewed += 1u;
+        return TRUE;
+    }
+
+    subscription = SI_SD_SUBSCRIPTION_insert(entry->serviceID, entry->instanceID, entry->eventgroupID, ipv4_be, port);
+    if (NULLPTR == subscription)
+    {
+        return FALSE;
+    }
+
+    if (FALSE == SI_EVENT_subscribe(entry->serviceID, entry->instanceID, entry->eventgroupID, ipv4_be, port))
+    {
+        SI_SD_SUBSCRIPTION_release(subscription);
+        return FALSE;
+    }
+
+    subscription->peer_ipv4_be = peer_ipv4_be;
+    subscription->ttl = entry->ttl;
+    g_counters.subscribed += 1u;
+    *out_new = TRUE;
+    return TRUE;
+#else
+    (void)entry;
+    (void)ipv4_be;
+    (void)port;
+    (void)peer_ipv4_be;
+    *out_new = FALSE;
+    return FALSE;   // no local eventgroups
+#endif
+}
+
+/**
+ * Subscribe: stored and acknowledged, or rejected with SubscribeNack.
+ * StopSubscribe: subscription is removed, it is not answered.
+ *
+ * @param out_ipv4_be, out_port: event endpoint of the subscriber
+ *
+ * @returns TRUE if a new subscriber is acknowledged
+ */
+static boolean SI_SD_SUBSCRIPTION_handle_subscribe(struct SD_Context *sd_context, const struct SI_SD_EventgroupEntry* entry,
+                                                   const struct SI_SD_IPv4EndpointOption* option, uint32 src_ipv4_be, uint16 src_port_be,
+                                                   uint32 peer_ipv4_be, uint32* out_ipv4_be, uint16* out_port)
+{
+    uint32 ipv4_be = 0u;
+    uint16 port = 0u;
+    boolean new_subscriber = FALSE;
+    struct SD_Subscription* subscription = NULLPTR;
+    const boolean has_endpoint = SI_SD_SUBSCRIPTION_get_endpoint(option, &ipv4_be, &port);
+
+    if (0u == entry->ttl)
+    {
+        subscription = (TRUE == has_endpoint) ?
+                       (SI_SD_SUBSCRIPTION_find(entry->serviceID, entry->instanceID, entry->eventgroupID, ipv4_be, port)) :
+                       (NULLPTR);
+        if (NULLPTR != subscription)
+        {
+            SI_SD_SUBSCRIPTION_remove(subscription);
+            g_counters.stopped += 1u;
+        }
+        return FALSE;
+    }
+
+    if ((TRUE == has_endpoint) && (TRUE == SI_SD_SUBSCRIPTION_accept(entry, ipv4_be, port, peer_ipv4_be, &new_subscriber)))
+    {
+        (void)SI_SD_SUBSCRIPTION_send_ack(sd_context, src_ipv4_be, src_port_be, entry, TRUE);
+        *out_ipv4_be = ipv4_be;
+        *out_port = port;
+        return new_subscriber;
+    }
+
+    g_counters.nacked += 1u;
+    (void)SI_SD_SUBSCRIPTION_send_ack(sd_context, src_ipv4_be, src_port_be, entry, FALSE);
+    return FALSE;
+}
+
+/**
+ * Sends a single Eventgroup Entry with an optional option unicast.
+ */
+static boolean SI_SD_SUBSCRIPTION_send(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be,
+                                       const struct SI_SD_EventgroupEntry* entry, const struct SI_SD_IPv4EndpointOption* option)
+{
+    boolean retval = FALSE;
+    struct SI_SD_PayloadBuilder payload;
+
+    if (FALSE == SI_SD_BUILDER_init(&payload))
+    {
+        return FALSE;
+    }
+
+    if (TRUE == SI_SD_BUILDER_add_eventgroup_entry(&payload, entry, option))
+    {
+        retval = SI_SD_PROVIDER_send(sd_context, dst_ipv4_be, dst_port_be, TRUE, &payload);
+    }
+
+    (void)SI_SD_BUILDER_invalidate(&payload);
+    return retval;
+}
+
+/**
+ * SubscribeAck carries the TTL of the Subscribe entry and the multicast option of the eventgroup (if configured).
+ * SubscribeNack is a SubscribeAck with TTL 0.
+ */
+static boolean SI_SD_SUBSCRIPTION_send_ack(struct SD_Context *sd_context, uint32 dst_ipv4_be, uint16 dst_port_be,
+                                           const struct SI_SD_EventgroupEntry* subscribe, boolean accepted)
+{
+    struct SI_SD_EventgroupEntry ack;
+    struct SI_SD_IPv4EndpointOption option;
+    boolean has_option = FALSE;
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+    uint32 multicast_ipv4 = 0u;
+    uint16 multicast_port = 0u;
+
+    if ((TRUE == accepted) &&
+        (TRUE == SI_EVENT_get_multicast(SI_EVENT_find_eventgroup(subscribe->serviceID, subscribe->instanceID, subscribe->eventgroupID),
+                                        &multicast_ipv4, &multicast_port)))
+    {
+        has_option = SI_SD_PAYLOAD_create_option(SI_SD_CONST_IPV4_OPTION_LENGTH, SD_OptionTypes_IPV4_MC, FALSE,
+                                                 lwip_ntohl(multicast_ipv4), SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP, multicast_port, &option);
+    }
+#endif
+
+    if (FALSE == SI_SD_PAYLOAD_create_eventgroup_entry(SD_EntryTypes_SubscribeAck, 0u, ((TRUE == has_option) ? (1u) : (0u)),
+                                                       subscribe->serviceID, subscribe->instanceID, subscribe->major_version,
+                                                       ((TRUE == accepted) ? (subscribe->ttl) : (0u)),
+                                                       subscribe->counter, subscribe->eventgroupID, &ack))
+    {
+        return FALSE;
+    }
+
+    return SI_SD_SUBSCRIPTION_send(sd_context, dst_ipv4_be, dst_port_be, &ack, ((TRUE == has_option) ? (&option) : (NULLPTR)));
+}
+
+/* END OF SI_SD_SUBSCRIPTION.C FILE */
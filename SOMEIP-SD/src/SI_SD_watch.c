@@ -0,0 +1,301 @@
+/**
+ * @file    SI_SD_watch.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_SD_watch.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_SD_watch.h"
+
+#include "SI_types.h"
+
+#include "SI_SD_config.h"
+#include "SI_SD_const.h"
+#include "SI_SD_service_manager.h"
+#include "ERH.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+/**
+ * Registry change waiting for the callbacks
+ * @note target: the only watch to be notified (see SI_SD_WATCH_add()), NULLPTR: every matching watch
+ */
+struct SI_SD_WATCH_pending_event
+{
+    enum SI_SD_WATCH_Event_t event;
+    struct SI_SD_WATCH_ServiceInfo info;
+    const struct SI_SD_Watch* target;
+};
+
+static struct SI_SD_Watch g_watches[SI_SD_CFG_MAX_WATCHES];
+
+// Ring buffer of registry changes, guarded by the registry lock (changes are queued while it is held)
+static struct SI_SD_WATCH_pending_event g_queue[SI_SD_CFG_WATCH_QUEUE_SIZE];
+static uint32 g_queue_head = 0u;       // next event to dispatch
+static uint32 g_queue_count = 0u;
+
+static struct SI_SD_WATCH_counters g_counters;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static boolean SI_SD_WATCH_matches(const struct SI_SD_Watch* watch, const struct SI_SD_WATCH_ServiceInfo* info);
+static boolean SI_SD_WATCH_pop(struct SI_SD_WATCH_pending_event* out_event);
+static struct SI_SD_WATCH_pending_event* SI_SD_WATCH_find_last(const struct SD_remote_Service* service);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Registers a watch. Callback is called at once for every matching instance that is already available.
+ * @note Register watches after SI_SD_PROVIDER_init(), it removes every watch.
+ *
+ * @param instance_id: SI_SD_CONST_ANY_INSTANCE_ID watches every instance
+ * @param major: SI_SD_CONST_ANY_MAJOR_VERSION watches every major version
+ *
+ * @returns handle of the watch, NULLPTR if callback is invalid or there is no free element
+ */
+struct SI_SD_Watch* SI_SD_WATCH_add(uint16 service_id, uint16 instance_id, uint8 major,
+                                    SI_SD_WATCH_Callback_fptr callback, void* user_data)
+{
+    uint32 i = 0u;
+    struct SI_SD_Watch* watch = NULLPTR;
+
+    if (NULLPTR == callback)
+    {
+        return NULLPTR;
+    }
+
+    SI_SD_CFG_WATCH_LOCK();
+    for (i = 0u; i < SI_SD_CFG_MAX_WATCHES; i++)
+    {
+        if (FALSE == g_watches[i].used)
+        {
+            watch = &(g_watches[i]);
+            watch->used = TRUE;
+            watch->service_id = service_id;
+            watch->instance_id = instance_id;
+            watch->major = major;
+            watch->callback = callback;
+            watch->user_data = user_data;
+            break;
+        }
+    }
+    SI_SD_CFG_WATCH_UNLOCK();
+
+    if (NULLPTR != watch)
+    {
+        SI_SD_PROVIDER_announce_services(watch);
+        SI_SD_WATCH_dispatch();
+    }
+    return watch;
+}
+
+/**
+ * Unregisters a watch, its callback is not called afterwards
+ * (unless it is running on an other task at the moment).
+ *
+ * @returns FALSE if watch is not registered
+ */
+boolean SI_SD_WATCH_remove(struct SI_SD_Watch* watch)
+{
+    boolean removed = FALSE;
+
+    if (NULLPTR == watch)
+    {
+        return FALSE;
+    }
+
+    SI_SD_CFG_WATCH_LOCK();
+    removed = watch->used;
+    watch->used = FALSE;
+    SI_SD_CFG_WATCH_UNLOCK();
+
+    return removed;
+}
+
+void SI_SD_WATCH_get_counters(struct SI_SD_WATCH_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/**
+ * Removes every watch and drops the pending events
+ * @note Called by SI_SD_PROVIDER_init().
+ */
+void SI_SD_WATCH_init(void)
+{
+    uint32 i = 0u;
+
+    SI_SD_CFG_WATCH_LOCK();
+    for (i = 0u; i < SI_SD_CFG_MAX_WATCHES; i++)
+    {
+        g_watches[i].used = FALSE;
+    }
+    SI_SD_CFG_WATCH_UNLOCK();
+
+    g_queue_head = 0u;
+    g_queue_count = 0u;
+}
+
+/**
+ * Queues a change of the remote service registry. A change of an instance that is still queued for the same watches
+ * is merged into the queued one, watches are told the latest state only.
+ * @note Registry lock is held by the caller. Events are lost (and reported to ERH) if the queue is full.
+ *
+ * @param service: registry element, its identifiers and endpoint are copied
+ * @param target: watch to be notified, NULLPTR: every matching watch
+ */
+void SI_SD_WATCH_enqueue(enum SI_SD_WATCH_Event_t event, const struct SD_remote_Service* service, const struct SI_SD_Watch* target)
+{
+    struct SI_SD_WATCH_pending_event* pending = SI_SD_WATCH_find_last(service);
+
+    if ((NULLPTR != pending) && (target == pending->target))
+    {
+        // Watches have not seen the queued AVAILABLE yet: it is kept, with the new endpoint
+        if ((SI_SD_WATCH_Event_AVAILABLE != pending->event) || (SI_SD_WATCH_Event_ENDPOINT_CHANGED != event))
+        {
+            pending->event = event;
+        }
+        pending->info.minor = service->minor;
+        pending->info.endpoint = service->endpoint;
+        g_counters.events_collapsed += 1u;
+        return;
+    }
+
+    if (SI_SD_CFG_WATCH_QUEUE_SIZE <= g_queue_count)
+    {
+        g_counters.events_dropped += 1u;
+        ERH_report_error(ERH_SD_WATCH_EVENT_LOST, (uint32)event, service->service_id, service->instance_id, service->major, 0u, 0u);
+        return;
+    }
+
+    pending = &(g_queue[(g_queue_head + g_queue_count) % SI_SD_CFG_WATCH_QUEUE_SIZE]);
+    pending->event = event;
+    pending->info.service_id = service->service_id;
+    pending->info.instance_id = service->instance_id;
+    pending->info.major = service->major;
+    pending->info.minor = service->minor;
+    pending->info.endpoint = service->endpoint;
+    pending->target = target;
+
+    g_queue_count += 1u;
+    g_counters.events_queued += 1u;
+}
+
+/**
+ * Calls the callbacks of the queued registry changes. No lock is held while a callback runs.
+ * @note Called after the registry lock is released.
+ */
+void SI_SD_WATCH_dispatch(void)
+{
+    uint32 i = 0u;
+    struct SI_SD_WATCH_pending_event pending;
+    SI_SD_WATCH_Callback_fptr callback = NULLPTR;
+    void* user_data = NULLPTR;
+
+    while (TRUE == SI_SD_WATCH_pop(&pending))
+    {
+        for (i = 0u; i < SI_SD_CFG_MAX_WATCHES; i++)
+        {
+            callback = NULLPTR;
+
+            SI_SD_CFG_WATCH_LOCK();
+            if ((TRUE == g_watches[i].used) &&
+                ((NULLPTR == pending.target) || (&(g_watches[i]) == pending.target)) &&
+                (TRUE == SI_SD_WATCH_matches(&(g_watches[i]), &(pending.info))))
+            {
+                callback = g_watches[i].callback;
+                user_data = g_watches[i].user_data;
+            }
+            SI_SD_CFG_WATCH_UNLOCK();
+
+            if (NULLPTR != callback)
+            {
+                g_counters.callbacks_called += 1u;
+                callback(pending.event, &(pending.info), user_data);
+            }
+        }
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static boolean SI_SD_WATCH_matches(const struct SI_SD_Watch* watch, const struct SI_SD_WATCH_ServiceInfo* info)
+{
+    return ((watch->service_id == info->service_id) &&
+            ((SI_SD_CONST_ANY_INSTANCE_ID == watch->instance_id) || (watch->instance_id == info->instance_id)) &&
+            ((SI_SD_CONST_ANY_MAJOR_VERSION == watch->major) || (watch->major == info->major)));
+}
+
+/**
+ * Only the latest queued change of an instance may be merged, so changes of the instance
+ * reach every watch in order.
+ * @note Registry lock is held by the caller.
+ *
+ * @returns latest queued change of the instance, NULLPTR if there is none
+ */
+static struct SI_SD_WATCH_pending_event* SI_SD_WATCH_find_last(const struct SD_remote_Service* service)
+{
+    uint32 i = 0u;
+    struct SI_SD_WATCH_pending_event* pending = NULLPTR;
+
+    for (i = g_queue_count; 0u < i; i--)
+    {
+        pending = &(g_queue[(g_queue_head + i - 1u) % SI_SD_CFG_WATCH_QUEUE_SIZE]);
+
+        if ((service->service_id == pending->info.service_id) && (service->instance_id == pending->info.instance_id) &&
+            (service->major == pending->info.major))
+        {
+            return pending;
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * Takes the oldest queued event under the registry lock
+ */
+static boolean SI_SD_WATCH_pop(struct SI_SD_WATCH_pending_event* out_event)
+{
+    boolean popped = FALSE;
+
+    SI_SD_CFG_REMOTE_REGISTRY_LOCK();
+    if (0u < g_queue_count)
+    {
+        *out_event = g_queue[g_queue_head];
+        g_queue_head = (g_queue_head + 1u) % SI_SD_CFG_WATCH_QUEUE_SIZE;
+        g_queue_count -= 1u;
+        popped = TRUE;
+    }
+    SI_SD_CFG_REMOTE_REGISTRY_UNLOCK();
+
+    return popped;
+}
+
+/* END OF SI_SD_WATCH.C FILE */
@@ -54,43 +54,53 @@
 void SI_SD_WIRE_serialize_header(const struct SD_Header* in_header, uint8* out_header)
 {
     // struct SI_MessageID: [service:16 | method:16]
-    be_put_u16(POINTER_OFFSET_BY_BYTES(out_header, 0u), in_header->message_id.serviceID);
-    be_put_u16(POINTER_OFFSET_BY_BYTES(out_header, 2u), in_header->message_id.methodID_or_eventID);
+    u16_to_u8array(POINTER_OFFSET_BY_BYTES(out_header, 0u), in_header->message_id.serviceID);
+    u16_to_u8array(POINTER_OFFSET_BY_BYTES(out_header, 2u), in_header->message_id.methodID_or_eventID);
 
     // Length: 32 bit
-    be_put_u32(POINTER_OFFSET_BY_BYTES(out_header, 4u), in_header->length);
+    u32_to_u8array(POINTER_OFFSET_BY_BYTES(out_header, 4u), in_header->length);
 
     // struct SI_RequestID: [client_id:16 | session_id:16]
-    be_put_u16(POINTER_OFFSET_BY_BYTES(out_header, 8u), in_header->request_id.clientID);
-    be_put_u16(POINTER_OFFSET_BY_BYTES(out_header, 10u), in_header->request_id.sessionID);
+    u16_to_u8array(POINTER_OFFSET_BY_BYTES(out_header, 8u), in_header->request_id.clientID);
+    u16_to_u8array(POINTER_OFFSET_BY_BYTES(out_header, 10u), in_header->request_id.sessionID);
 
     out_header[12] = in_header->protocol_version;
     out_header[13] = in_header->interface_version;
     out_header[14] = in_header->message_type;
     out_header[15] = in_header->return_code;
 
-    be_put_u32(POINTER_OFFSET_BY_BYTES(out_header, 16u), in_header->preamble);
+    u32_to_u8array(POINTER_OFFSET_BY_BYTES(out_header, 16u), in_header->preamble);
+}
+
+/**
+ * Overwrites the fields that change between two sends of the same SD message: Session ID and preamble (flags).
+ * Every other field of the serialised header is left untouched.
+ */
+void SI_SD_WIRE_patch_header(uint8* header, uint16 session_id, uint32 preamble)
+{
+    u16_to_u8array(POINTER_OFFSET_BY_BYTES(header, 10u), session_id);
+    u32_to_u8array(POINTER_OFFSET_BY_BYTES(header, 16u), preamble);
 }
 
 void SI_SD_WIRE_deserialize_header(const uint8* in_header, struct SD_Header* out_header)
 {
     // struct SI_MessageID: [service:16 | method:16]
-    out_header->message_id.serviceID = be_get_u16(POINTER_OFFSET_BY_BYTES(in_header, 0u));
-    out_header->message_id.methodID_or_eventID = be_get_u16(POINTER_OFFSET_BY_BYTES(in_header, 2u));
+    out_header->message_id.serviceID = u8array_to_u16(POINTER_OFFSET_BY_BYTES(in_header, 0u));
+    out_header->message_id.methodID_or_eventID = u8array_to_u16(POINTER_OFFSET_BY_BYTES(in_header, 2u));
 
     // Length: 32 bit
-    out_header->length = be_get_u32(POINTER_OFFSET_BY_BYTES(in_header, 4u));
+    out_header->length = u8array_to_u32(POINTER_OFFSET_BY_BYTES(in_header, 4u));
 
     // struct SI_RequestID: [client_id:16 | session_id:16]
-    out_header->request_id.clientID = be_get_u16(POINTER_OFFSET_BY_BYTES(in_header, 8u));
-    out_header->request_id.sessionID = be_get_u16(POINTER_OFFSET_BY_BYTES(in_header, 10u));
+    out_header->request_id.clientID = u8array_to_u16(POINTER_OFFSET_BY_BYTES(in_header, 8u));
+    out_header->request_id.sessionID = u8array_to_u16(POINTER_OFFSET_BY_BYTES(in_header, 10u));
 
     out_header->protocol_version = in_header[12];
     out_header->interface_version = in_header[13];
     out_header->message_type = in_header[14];
     out_header->return_code = in_header[15];
 
-    out_header->preamble = be_get_u32(POINTER_OFFSET_BY_BYTES(in_header, 16u));
+    out_header->preamble = u8array_to_u32(POINTER_OFFSET_BY_BYTES(in_header, 16u));
 }
 
 void SI_SD_WIRE_deserialize_ServiceEntry(uint8 *in_entry, struct SI_SD_ServiceEntry *out_entry)
@@ -100,21 +110,113 @@ void SI_SD_WIRE_deserialize_ServiceEntry(uint8 *in_entry, struct SI_SD_ServiceEn
     out_entry->index_2nd_option_run = in_entry[2u];
     out_entry->number_of_options1 = ((in_entry[3u] & UPPER_NIBBLE_MASK) >> UPPER_NIBBLE_OFFSET);
     out_entry->number_of_options2 = ((in_entry[3u] & LOWER_NIBBLE_MASK) >> LOWER_NIBBLE_OFFSET);
-    out_entry->serviceID = be_get_u16(&(in_entry[4u]));
-    out_entry->instanceID = be_get_u16(&(in_entry[6u]));
+    out_entry->serviceID = u8array_to_u16(&(in_entry[4u]));
+    out_entry->instanceID = u8array_to_u16(&(in_entry[6u]));
     out_entry->major_version = in_entry[8u];
-    out_entry->ttl = be_get_u24(&(in_entry[9u]));
-    out_entry->minor_version = be_get_u32(&(in_entry[12u]));
+    out_entry->ttl = u8array_to_u24(&(in_entry[9u]));
+    out_entry->minor_version = u8array_to_u32(&(in_entry[12u]));
+}
+
+void SI_SD_WIRE_serialize_ServiceEntry(const struct SI_SD_ServiceEntry *in_entry, uint8 *out_entry)
+{
+    out_entry[0u] = (uint8)in_entry->type;
+    out_entry[1u] = in_entry->index_1st_option_run;
+    out_entry[2u] = in_entry->index_2nd_option_run;
+    out_entry[3u] = (uint8)(((in_entry->number_of_options1 << UPPER_NIBBLE_OFFSET) & UPPER_NIBBLE_MASK) |
+                            ((in_entry->number_of_options2 << LOWER_NIBBLE_OFFSET) & LOWER_NIBBLE_MASK));
+    u16_to_u8array(&(out_entry[4u]), in_entry->serviceID);
+    u16_to_u8array(&(out_entry[6u]), in_entry->instanceID);
+    out_entry[8u] = in_entry->major_version;
+    u24_to_u8array(&(out_entry[9u]), in_entry->ttl);
+    u32_to_u8array(&(out_entry[12u]), in_entry->minor_version);
+}
+
+/**
+ * Decodes the fields every option starts with: Length, Type and the discardable flag
+ */
+void SI_SD_WIRE_deserialize_option_header(uint8 *in_option, uint16 *out_length, uint8 *out_type, boolean *out_discardable)
+{
+    *out_length = u8array_to_u16(&(in_option[0u]));
+    *out_type = in_option[2u];
+    *out_discardable = ((in_option[3u] & DISCARDABLE_FLAG_MASK) >> DISCARDABLE_FLAG_OFFSET);
 }
 
 void SI_SD_WIRE_deserialize_IPv4EndpointOption(uint8 *in_option, struct SI_SD_IPv4EndpointOption *out_option)
 {
-    out_option->length = be_get_u16(&(in_option[0u]));
+    out_option->length = u8array_to_u16(&(in_option[0u]));
     out_option->type = in_option[2u];
     out_option->discardable_flag = ((in_option[3u] & DISCARDABLE_FLAG_MASK) >> DISCARDABLE_FLAG_OFFSET);
-    out_option->IPv4_address = be_get_u32(&(in_option[4u]));
+    out_option->IPv4_address = u8array_to_u32(&(in_option[4u]));
     out_option->l4_proto = in_option[9u];
-    out_option->port_number = in_option[10u];
+    out_option->port_number = u8array_to_u16(&(in_option[10u]));
+}
+
+void SI_SD_WIRE_deserialize_IPv6EndpointOption(uint8 *in_option, struct SI_SD_IPv6EndpointOption *out_option)
+{
+    uint32 i = 0u;
+
+    out_option->length = u8array_to_u16(&(in_option[0u]));
+    out_option->type = in_option[2u];
+    out_option->discardable_flag = ((in_option[3u] & DISCARDABLE_FLAG_MASK) >> DISCARDABLE_FLAG_OFFSET);
+    for (i = 0u; i < SI_SD_CONST_IPV6_ADDRESS_SIZE; i++)
+    {
+        out_option->IPv6_address[i] = in_option[4u + i];
+    }
+    // in_option[20u]: reserved
+    out_option->l4_proto = in_option[21u];
+    out_option->port_number = u8array_to_u16(&(in_option[22u]));
+}
+
+void SI_SD_WIRE_deserialize_LoadBalancingOption(uint8 *in_option, struct SI_SD_LoadBalancingOption *out_option)
+{
+    out_option->priority = u8array_to_u16(&(in_option[4u]));
+    out_option->weight = u8array_to_u16(&(in_option[6u]));
+}
+
+void SI_SD_WIRE_deserialize_EventgroupEntry(uint8 *in_entry, struct SI_SD_EventgroupEntry *out_entry)
+{
+    out_entry->type = in_entry[0u];
+    out_entry->index_1st_option_run = in_entry[1u];
+    out_entry->index_2nd_option_run = in_entry[2u];
+    out_entry->number_of_options1 = ((in_entry[3u] & UPPER_NIBBLE_MASK) >> UPPER_NIBBLE_OFFSET);
+    out_entry->number_of_options2 = ((in_entry[3u] & LOWER_NIBBLE_MASK) >> LOWER_NIBBLE_OFFSET);
+    out_entry->serviceID = u8array_to_u16(&(in_entry[4u]));
+    out_entry->instanceID = u8array_to_u16(&(in_entry[6u]));
+    out_entry->major_version = in_entry[8u];
+    out_entry->ttl = u8array_to_u24(&(in_entry[9u]));
+    // in_entry[12u]: reserved, in_entry[13u]: reserved (upper nibble) | counter (lower nibble)
+    out_entry->counter = ((in_entry[13u] & LOWER_NIBBLE_MASK) >> LOWER_NIBBLE_OFFSET);
+    out_entry->eventgroupID = u8array_to_u16(&(in_entry[14u]));
+}
+
+void SI_SD_WIRE_serialize_EventgroupEntry(const struct SI_SD_EventgroupEntry *in_entry, uint8 *out_entry)
+{
+    out_entry[0u] = (uint8)in_entry->type;
+    out_entry[1u] = in_entry->index_1st_option_run;
+    out_entry[2u] = in_entry->index_2nd_option_run;
+    out_entry[3u] = (uint8)(((in_entry->number_of_options1 << UPPER_NIBBLE_OFFSET) & UPPER_NIBBLE_MASK) |
+                            ((in_entry->number_of_options2 << LOWER_NIBBLE_OFFSET) & LOWER_NIBBLE_MASK));
+    u16_to_u8array(&(out_entry[4u]), in_entry->serviceID);
+    u16_to_u8array(&(out_entry[6u]), in_entry->instanceID);
+    out_entry[8u] = in_entry->major_version;
+    u24_to_u8array(&(out_entry[9u]), in_entry->ttl);
+    out_entry[12u] = 0u;
+    out_entry[13u] = (uint8)((in_entry->counter << LOWER_NIBBLE_OFFSET) & LOWER_NIBBLE_MASK);
+    u16_to_u8array(&(out_entry[14u]), in_entry->eventgroupID);
+}
+
+/**
+ * IPv4 Endpoint and IPv4 Multicast options share the same layout
+ */
+void SI_SD_WIRE_serialize_IPv4EndpointOption(const struct SI_SD_IPv4EndpointOption *in_option, uint8 *out_option)
+{
+    u16_to_u8array(&(out_option[0u]), in_option->length);
+    out_option[2u] = (uint8)in_option->type;
+    out_option[3u] = (uint8)((TRUE == in_option->discardable_flag) ? (DISCARDABLE_FLAG_MASK) : (0u));
+    u32_to_u8array(&(out_option[4u]), in_option->IPv4_address);
+    out_option[8u] = 0u;
+    out_option[9u] = in_option->l4_proto;
+    u16_to_u8array(&(out_option[10u]), in_option->port_number);
 }
 
 /* **************************************************** */
@@ -0,0 +1,120 @@
+// Include guard starts here
+#ifndef SI_CLIENT_H_
+#define SI_CLIENT_H_
+
+/**
+ * @file    SI_client.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Client side of SOME/IP: sends requests to remote services and correlates the responses.
+ *           Session IDs are allocated per Client ID, outstanding requests are kept in a hashed pending table,
+ *           so any number of requests (up to the table size) can be in flight at once.
+ *           Maintains inner buffers, does not allocate heap dynamically."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "lwip/udp.h"
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+#include "SI_servman.h"
+#include "SI_timerwheel.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+
+/**
+ * Completion callback of a request.
+ * @param response: received RESPONSE or ERROR message, NULLPTR if request is completed without response
+ * @param return_code: Return Code of the response, SI_ReturnCode_TIMEOUT if no response arrived
+ * @param user_data: pointer given at request
+ */
+typedef void (*SI_CLIENT_ResponseCallback_fptr)(const struct SI_MessageContext* response,
+                                                enum SI_ReturnCode_t return_code,
+                                                void* user_data);
+
+/**
+ * Addressing and timeout policy of a remote method call. Keep one instance per remote method.
+ * @note The request is retransmitted with the same Session ID max_retries times, timeout_ms after every transmission.
+ *       Server recognises the retransmission (see SI_respcache.h), the method is not invoked twice.
+ */
+struct SI_CLIENT_RequestParams
+{
+    struct udp_pcb* pcb;        // local pcb, request is sent through it
+    uint32 dst_ipv4;            // address of the server (network order)
+    uint16 dst_port;            // host order
+    uint16 service_id;
+    uint16 method_id;
+    uint16 client_id;
+    uint8 interface_version;
+    uint32 timeout_ms;          // 0u means SI_CFG_CLIENT_DEFAULT_TIMEOUT_MS
+    uint8 max_retries;
+};
+
+/**
+ * An outstanding request. Key: Service ID, Method ID, Client ID (params) and Session ID.
+ * @note deleted: slot was used, lookup has to continue probing after it
+ */
+struct SI_CLIENT_pendingElement
+{
+    boolean valid;
+    boolean deleted;
+    struct SI_CLIENT_RequestParams params;  // response is accepted only from params.dst_ipv4
+    uint16 session_id;
+    SI_CLIENT_ResponseCallback_fptr callback;
+    void* user_data;
+    struct SI_TIMERWHEEL_node timer;
+    uint8 retries_left;
+    uint32 payload_length;
+    uint8 payload[SI_CFG_CLIENT_RETRY_PAYLOAD_SIZE];    // request copy for retransmission
+};
+
+/**
+ * Session ID counter of a Client ID
+ */
+struct SI_CLIENT_session
+{
+    boolean used;
+    uint16 client_id;
+    uint16 session_id;          // last used Session ID
+};
+
+struct SI_CLIENT_counters
+{
+    uint32 sent;                // number of sent requests
+    uint32 completed;           // number of requests completed by a response
+    uint32 unmatched;           // number of received responses without outstanding request
+    uint32 retransmitted;       // number of retransmissions
+    uint32 timed_out;           // number of requests completed with SI_ReturnCode_TIMEOUT
+};
+
+#endif
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+
+boolean SI_CLIENT_request(const struct SI_CLIENT_RequestParams* params, const uint8* payload, uint32 payload_length,
+                          SI_CLIENT_ResponseCallback_fptr callback, void* user_data, uint16* out_session_id);
+boolean SI_CLIENT_handle_response(const struct SI_MessageContext* response, uint32 src_ipv4);
+boolean SI_CLIENT_cancel(uint16 service_id, uint16 method_id, uint16 client_id, uint16 session_id);
+uint32 SI_CLIENT_get_pending_count(void);
+void SI_CLIENT_get_counters(struct SI_CLIENT_counters* out_counters);
+void SI_CLIENT_tick(uint32 elapsed_time_ms);
+
+#endif
+
+// Include guard stops here
+#endif // SI_CLIENT_H_
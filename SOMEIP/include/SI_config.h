@@ -40,19 +40,72 @@
  */
 #define SI_CFG_MAX_METHODS                      (SI_CFG_MAX_SERVICES)
 
+/**
+ * Size of the event handler index (received notifications). Must be a power of two.
+ * Keep it at least twice the number of registered event handlers for short lookups.
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_EVENT_HANDLER_INDEX_SIZE         (16u)
+
 /**
  * TRUE: Event and eventgroup handling is enabled.
  * FALSE: Event and eventgroup handling is disabled.
  */
-#define SI_CFG_ENABLE_EVENTS                    (FALSE)
+#define SI_CFG_ENABLE_EVENTS                    (TRUE)
 
 #if (TRUE == SI_CFG_ENABLE_EVENTS)
 
 /**
  * Maximum number of eventgroups that an endpoint can handle.
+ * @note maximum value: 32
  */
 #define SI_CFG_MAX_EVENT_GROUPS                 (8u)
 
+/**
+ * Maximum number of events that an endpoint can publish.
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_MAX_EVENTS                       (16u)
+
+/**
+ * Maximum number of subscribers of a single eventgroup.
+ * Setting this value to higher numbers will cause more memory usage (SI_CFG_MAX_EVENT_GROUPS times).
+ */
+#define SI_CFG_MAX_EVENTGROUP_SUBSCRIBERS       (24u)
+
+/**
+ * Maximum number of subscribe hooks (see SI_EVENT_add_subscribe_hook()). Fields use one of them.
+ */
+#define SI_CFG_MAX_SUBSCRIBE_HOOKS              (4u)
+
+/**
+ * Number of events with scheduled transmission (cyclic, minimum interval, debounce).
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_EVENTSCHED_ELEMENT_NUM           (8u)
+
+/**
+ * Size of the latest value buffer of a scheduled event. Longer values can not be scheduled.
+ * Setting this value to higher numbers will cause more memory usage (SI_CFG_EVENTSCHED_ELEMENT_NUM times).
+ */
+#define SI_CFG_EVENTSCHED_PAYLOAD_SIZE          (64u)
+
+/**
+ * Time between the retries of a failed notification (e.g. Tx pool exhausted) of an ON_CHANGE or debounced event.
+ */
+#define SI_CFG_EVENTSCHED_RETRY_MS              (10u)
+
+/**
+ * Maximum number of fields (getter / setter / notifier) that an endpoint can handle.
+ */
+#define SI_CFG_MAX_FIELDS                       (8u)
+
+/**
+ * Size of the stored value of a field. Longer values can not be written.
+ * Setting this value to higher numbers will cause more memory usage (SI_CFG_MAX_FIELDS times).
+ */
+#define SI_CFG_FIELD_VALUE_SIZE                 (64u)
+
 #endif
 
 /**
@@ -73,6 +126,149 @@
  */
 #define SI_CFG_MSG_TXPOOL_ELEMENT_NUM           (8u)
 
+/**
+ * TRUE: If Tx pool is exhausted, requests are deferred and answered as soon as a Tx buffer is released.
+ * FALSE: If Tx pool is exhausted, requests are dropped.
+ */
+#define SI_CFG_ENABLE_TX_BACKPRESSURE           (TRUE)
+
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+
+/**
+ * Number of requests that can be deferred at the same time.
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_TXQUEUE_ELEMENT_NUM              (4u)
+
+/**
+ * Maximum payload size of a deferrable request. Requests with bigger payload are dropped if Tx pool is exhausted.
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_TXQUEUE_PAYLOAD_SIZE             (128u)
+
+/**
+ * Deadline [ms] of a deferred request. If no Tx buffer is released in time, request is dropped.
+ */
+#define SI_CFG_TXQUEUE_DEADLINE_MS              (50u)
+
+#endif
+
+/**
+ * TRUE: Sent responses are kept for a short time. Retransmitted requests (same Client ID and Session ID)
+ *       are answered with the stored response, the method handler is not invoked again.
+ * FALSE: Every received request invokes the method handler.
+ */
+#define SI_CFG_ENABLE_RESPONSE_CACHE            (TRUE)
+
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+
+/**
+ * Number of responses that can be stored at the same time.
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_RESPCACHE_ELEMENT_NUM            (8u)
+
+/**
+ * Size of a single stored response (header included). Bigger responses are not cached.
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_RESPCACHE_BLOCK_SIZE             (256u)
+
+/**
+ * Time window [ms] while a stored response is replayed for duplicated requests.
+ */
+#define SI_CFG_RESPCACHE_WINDOW_MS              (1000u)
+
+/**
+ * Number of memoized responses of cacheable methods (e.g. field getters) that can be stored at the same time.
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM       (4u)
+
+#if (FALSE == SI_CFG_ENABLE_SESSION_HANDLING)
+#error "Response cache requires session handling, duplicated requests can not be recognized without Session ID!"
+#endif
+
+#endif
+
+/**
+ * TRUE: Requests are admitted by a token-bucket limiter per requester (source address).
+ *       Retransmissions and memoized getters served from the response cache are not limited.
+ * FALSE: Every received request is processed.
+ * @note Rate and burst have to cover the fastest legitimate polling of every client behind the same address.
+ */
+#define SI_CFG_ENABLE_RATE_LIMIT                (FALSE)
+
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+
+/**
+ * Number of requesters tracked at the same time. Least recently seen requester is replaced if table is full.
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_RATELIMIT_CLIENT_NUM             (8u)
+
+/**
+ * Sustained number of requests per second admitted for a single requester.
+ */
+#define SI_CFG_RATELIMIT_RATE_PER_SEC           (100u)
+
+/**
+ * Number of requests a single requester can send in a burst.
+ */
+#define SI_CFG_RATELIMIT_BURST                  (20u)
+
+/**
+ * TRUE: Rejected REQUEST is answered with ERROR message, Return Code NOT_READY.
+ * FALSE: Rejected request is silently dropped.
+ */
+#define SI_CFG_RATELIMIT_REJECT_WITH_NOT_READY  (TRUE)
+
+/**
+ * NOT_READY is sent only while at least this many Tx buffers are free, otherwise the rejected request is dropped.
+ * Keeps the Tx pool for admitted requests during a flood.
+ */
+#define SI_CFG_RATELIMIT_NOT_READY_MIN_FREE_TX  (SI_CFG_MSG_TXPOOL_ELEMENT_NUM / 2u)
+
+#endif
+
+/**
+ * Resolution of the timer wheel [ms]. Timeouts are rounded up to this value.
+ * Should be equal to the period of SI_PROCESS_tick().
+ */
+#define SI_CFG_TIMERWHEEL_RESOLUTION_MS         (10u)
+
+/**
+ * TRUE: Client side is enabled, remote methods can be called and their responses are correlated.
+ * FALSE: Endpoint acts as a server only, received RESPONSE and ERROR messages are dispatched to method handlers.
+ */
+#define SI_CFG_ENABLE_CLIENT                    (TRUE)
+
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+
+/**
+ * Size of the pending request table, maximum number of outstanding requests. Must be a power of two.
+ * Setting this value to higher numbers will cause more memory usage.
+ */
+#define SI_CFG_CLIENT_PENDING_NUM               (16u)
+
+/**
+ * Number of Client IDs used on this endpoint, every Client ID has its own Session ID counter.
+ */
+#define SI_CFG_CLIENT_ID_NUM                    (4u)
+
+/**
+ * Response timeout [ms] of requests which do not specify their own timeout.
+ */
+#define SI_CFG_CLIENT_DEFAULT_TIMEOUT_MS        (1000u)
+
+/**
+ * Size of the request copy kept for retransmission. Requests with longer payload can not be retried.
+ * Setting this value to higher numbers will cause more memory usage (SI_CFG_CLIENT_PENDING_NUM times).
+ */
+#define SI_CFG_CLIENT_RETRY_PAYLOAD_SIZE        (128u)
+
+#endif
+
 /**
  * SOME/IP middleware should be able to operate with both connection-oriented and connectionless protocols.
  * However it specificly recommends to use UDP over TCP, because of the synchronization overhead of TCP.
@@ -0,0 +1,116 @@
+// Include guard starts here
+#ifndef SI_EVENT_H_
+#define SI_EVENT_H_
+
+/**
+ * @file    SI_event.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Event publisher. Handles local events, eventgroups and their subscribers.
+ *           A notification is serialised once into a single Tx buffer, then the same buffer is sent
+ *           to every subscriber of the eventgroups the event belongs to.
+ *           Maintains inner buffers, does not allocate heap dynamically."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "lwip/udp.h"
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+
+struct SI_EVENT_subscriber
+{
+    boolean used;
+    uint32 ipv4;                // address of the subscriber (network order)
+    uint16 port;                // port of the subscriber (host order)
+};
+
+/**
+ * Eventgroup of a local service instance. Key: Service ID, Instance ID and Eventgroup ID.
+ * @note If multicast is configured and the eventgroup has more than multicast_threshold subscribers,
+ *       a notification is sent once to the multicast group instead of every subscriber.
+ */
+struct SI_EVENT_eventgroup
+{
+    boolean valid;
+    uint16 service_id;
+    uint16 instance_id;
+    uint16 eventgroup_id;
+    struct udp_pcb* pcb;        // local pcb of the service instance, notifications are sent through it
+    struct SI_EVENT_subscriber subscriber[SI_CFG_MAX_EVENTGROUP_SUBSCRIBERS];
+    uint32 subscriber_count;
+    uint32 multicast_ipv4;      // multicast group address (network order), 0u: multicast is not configured
+    uint16 multicast_port;      // multicast port (host order)
+    uint32 multicast_threshold;
+};
+
+/**
+ * Local event. Key: Service ID and Event ID.
+ * @note eventgroup_mask: bit i is set if the event belongs to the i. eventgroup, an event can belong to several eventgroups
+ */
+struct SI_EVENT_event
+{
+    boolean valid;
+    uint16 service_id;
+    uint16 event_id;
+    uint8 interface_version;
+    uint16 session_id;          // last used Session ID
+    uint32 eventgroup_mask;
+};
+
+/**
+ * Called when a new subscriber of an eventgroup is announced (see SI_EVENT_announce_subscriber()),
+ * e.g. to send initial values.
+ */
+typedef void (*SI_EVENT_SubscribeHook_fptr)(const struct SI_EVENT_eventgroup* eventgroup,
+                                            const struct SI_EVENT_subscriber* subscriber);
+
+struct SI_EVENT_counters
+{
+    uint32 notified;            // number of serialised notifications
+    uint32 sent;                // number of transmitted notifications (every subscriber counted)
+    uint32 tx_failed;           // number of failed transmissions
+    uint32 multicast_sent;      // number of notifications sent to a multicast group instead of the subscribers
+};
+
+#endif
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+
+boolean SI_EVENT_add_eventgroup(struct udp_pcb* pcb, uint16 service_id, uint16 instance_id, uint16 eventgroup_id);
+boolean SI_EVENT_add_event(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint16 event_id, uint8 interface_version);
+struct SI_EVENT_eventgroup* SI_EVENT_find_eventgroup(uint16 service_id, uint16 instance_id, uint16 eventgroup_id);
+struct SI_EVENT_event* SI_EVENT_find_event(uint16 service_id, uint16 event_id);
+boolean SI_EVENT_subscribe(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4, uint16 port);
+boolean SI_EVENT_unsubscribe(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4, uint16 port);
+boolean SI_EVENT_notify(struct SI_EVENT_event* event, const uint8* payload, uint32 payload_length);
+boolean SI_EVENT_notify_subscriber(struct SI_EVENT_event* event, const struct SI_EVENT_eventgroup* eventgroup,
+                                   const struct SI_EVENT_subscriber* subscriber, const uint8* payload, uint32 payload_length);
+boolean SI_EVENT_set_multicast(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4, uint16 port, uint32 threshold);
+boolean SI_EVENT_get_multicast(const struct SI_EVENT_eventgroup* eventgroup, uint32* out_ipv4, uint16* out_port);
+boolean SI_EVENT_is_member(const struct SI_EVENT_event* event, const struct SI_EVENT_eventgroup* eventgroup);
+boolean SI_EVENT_announce_subscriber(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4, uint16 port);
+boolean SI_EVENT_add_subscribe_hook(SI_EVENT_SubscribeHook_fptr hook);
+void SI_EVENT_get_counters(struct SI_EVENT_counters* out_counters);
+
+#endif
+
+// Include guard stops here
+#endif // SI_EVENT_H_
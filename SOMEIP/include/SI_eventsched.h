@@ -0,0 +1,92 @@
+// Include guard starts here
+#ifndef SI_EVENTSCHED_H_
+#define SI_EVENTSCHED_H_
+
+/**
+ * @file    SI_eventsched.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Transmission scheduler of events.
+ *           Producers write the event value at any rate, only the latest value is kept and it is notified
+ *           according to the transmission mode of the event. Bus load depends on the configured cadence only.
+ *           Maintains inner buffers, does not allocate heap dynamically."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_event.h"
+#include "SI_timerwheel.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+
+/**
+ * ON_CHANGE: write is notified immediately if it differs from the last notified value
+ * CYCLIC: latest value is notified in every interval_ms, writes are not notified
+ * MIN_INTERVAL: write is notified immediately, but at most once in interval_ms. Writes in between are coalesced,
+ *               the latest one is notified at the end of the interval.
+ * DEBOUNCE: latest value is notified once no write arrived for interval_ms
+ *
+ * A notification of an ON_CHANGE or debounced event sent to no subscriber (see SI_EVENT_notify()) is retried
+ * in every SI_CFG_EVENTSCHED_RETRY_MS.
+ */
+enum SI_EVENTSCHED_Mode_t
+{
+    SI_EVENTSCHED_Mode_ON_CHANGE = 0u,
+    SI_EVENTSCHED_Mode_CYCLIC = 1u,
+    SI_EVENTSCHED_Mode_MIN_INTERVAL = 2u,
+    SI_EVENTSCHED_Mode_DEBOUNCE = 3u
+};
+
+struct SI_EVENTSCHED_element
+{
+    boolean used;
+    struct SI_EVENT_event* event;
+    enum SI_EVENTSCHED_Mode_t mode;
+    uint32 interval_ms;
+    boolean has_value;          // a value is written already
+    boolean pending;            // latest value is not notified yet
+    struct SI_TIMERWHEEL_node timer;
+    uint32 payload_length;
+    uint8 payload[SI_CFG_EVENTSCHED_PAYLOAD_SIZE];
+    boolean has_notified;       // a value is notified already
+    uint32 notified_length;
+    uint8 notified[SI_CFG_EVENTSCHED_PAYLOAD_SIZE];     // last notified value
+};
+
+struct SI_EVENTSCHED_counters
+{
+    uint32 written;             // number of writes
+    uint32 notified;            // number of notifications
+    uint32 coalesced;           // number of writes overwritten before notification
+    uint32 suppressed;          // number of ON_CHANGE writes equal to the last notified value
+};
+
+#endif
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+
+struct SI_EVENTSCHED_element* SI_EVENTSCHED_configure(struct SI_EVENT_event* event, enum SI_EVENTSCHED_Mode_t mode, uint32 interval_ms);
+boolean SI_EVENTSCHED_write(struct SI_EVENTSCHED_element* element, const uint8* payload, uint32 payload_length);
+void SI_EVENTSCHED_get_counters(struct SI_EVENTSCHED_counters* out_counters);
+void SI_EVENTSCHED_tick(uint32 elapsed_time_ms);
+
+#endif
+
+// Include guard stops here
+#endif // SI_EVENTSCHED_H_
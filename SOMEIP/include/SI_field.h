@@ -0,0 +1,87 @@
+// Include guard starts here
+#ifndef SI_FIELD_H_
+#define SI_FIELD_H_
+
+/**
+ * @file    SI_field.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "SOME/IP fields (getter / setter / notifier).
+ *           A field stores its last serialised value: getters are answered from the stored bytes,
+ *           writing identical bytes does not trigger a notification, new subscribers get the current value at once.
+ *           Maintains inner buffers, does not allocate heap dynamically."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+#include "SI_servman.h"
+#include "SI_event.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/**
+ * Method ID of a missing getter or setter (outside of method range)
+ */
+#define SI_FIELD_NO_METHOD              ((uint16)(0xFFFFu))
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+
+/**
+ * Called before a value received by the setter is stored.
+ * @returns FALSE: value is rejected, setter responds with NOT_OK
+ */
+typedef boolean (*SI_FIELD_SetHook_fptr)(const uint8* value, uint32 length);
+
+/**
+ * Key: Service ID, service instance (port and Interface Version) and getter / setter Method ID
+ */
+struct SI_FIELD_field
+{
+    boolean used;
+    uint16 service_id;
+    uint16 port_be;                     // port of the service instance, see SI_ServiceInstance
+    uint8 interface_version;
+    uint16 getter_id;                   // SI_FIELD_NO_METHOD if field has no getter
+    uint16 setter_id;                   // SI_FIELD_NO_METHOD if field has no setter
+    struct SI_EVENT_event* notifier;    // NULLPTR if field has no notifier
+    SI_FIELD_SetHook_fptr set_hook;     // optional
+    boolean has_value;
+    uint32 length;
+    uint8 value[SI_CFG_FIELD_VALUE_SIZE];
+};
+
+struct SI_FIELD_counters
+{
+    uint32 written;             // number of value changes
+    uint32 suppressed;          // number of writes with unchanged value, not notified
+    uint32 initial_sent;        // number of initial values sent to new subscribers
+};
+
+#endif
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+
+struct SI_FIELD_field* SI_FIELD_add(struct SI_Service* service, uint16 getter_id, uint16 setter_id,
+                                    struct SI_EVENT_event* notifier, SI_FIELD_SetHook_fptr set_hook);
+boolean SI_FIELD_write(struct SI_FIELD_field* field, const uint8* value, uint32 length);
+void SI_FIELD_get_counters(struct SI_FIELD_counters* out_counters);
+
+#endif
+
+// Include guard stops here
+#endif // SI_FIELD_H_
@@ -0,0 +1,58 @@
+// Include guard starts here
+#ifndef SI_HASH_H_
+#define SI_HASH_H_
+
+/**
+ * @file    SI_hash.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Provides hash functions for the static, open-addressing lookup tables.
+ *           Table sizes are powers of two, index is calculated by masking the hash value."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/**
+ * TRUE if x is a power of two (x > 0)
+ */
+#define SI_HASH_IS_POWER_OF_TWO(x)      ((0u != (x)) && (0u == ((x) & ((x) - 1u))))
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+/**
+ * Mixes a 32 bit key (murmur3 finalizer), every input bit affects the lower bits of the result.
+ */
+static inline uint32 SI_HASH_u32(uint32 key)
+{
+    key ^= (key >> 16u);
+    key *= 0x85EBCA6Bu;
+    key ^= (key >> 13u);
+    key *= 0xC2B2AE35u;
+    key ^= (key >> 16u);
+    return key;
+}
+
+/**
+ * Combines a hash value with a further 32 bit key part
+ */
+static inline uint32 SI_HASH_combine(uint32 hash, uint32 key)
+{
+    return SI_HASH_u32(hash ^ (key + 0x9E3779B9u + (hash << 6u) + (hash >> 2u)));
+}
+
+// Include guard stops here
+#endif // SI_HASH_H_
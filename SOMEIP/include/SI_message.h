@@ -54,6 +54,12 @@ struct SI_MESSAGE_tx_pool
     struct SI_MESSAGE_tx_poolElement pool[SI_CFG_MSG_TXPOOL_ELEMENT_NUM];
 };
 
+/**
+ * Called every time a Tx buffer is released (transmission of the message is completed).
+ * @note Runs in the context of the releasing code (any task, possibly under its locks): must not send or block.
+ */
+typedef void (*SI_MESSAGE_ReleaseHook_fptr)(void);
+
 /* **************************************************** */
 /*               Function declarations                  */
 /* **************************************************** */
@@ -62,6 +68,8 @@ boolean SI_MESSAGE_init(struct SI_MessageBuilder* out_message);
 boolean SI_MESSAGE_put(struct SI_MessageBuilder* message, const uint8* payload, uint32 payload_length);
 boolean SI_MESSAGE_finalize(struct SI_MessageBuilder* message, struct SI_Header* header, uint32* out_len);
 boolean SI_MESSAGE_invalidate(struct SI_MessageBuilder* message);
+uint32 SI_MESSAGE_get_free_count(void);
+void SI_MESSAGE_set_release_hook(SI_MESSAGE_ReleaseHook_fptr hook);
 
 // Include guard stops here
 #endif // SI_MESSAGE_H_
@@ -32,7 +32,9 @@
 /*               Function declarations                  */
 /* **************************************************** */
 
+void SI_PROCESS_init(void);
 boolean SI_PROCESS_unicast(struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf, const ip_addr_t *src_addr, u16_t src_port);
+void SI_PROCESS_tick(uint32 elapsed_time_ms);
 
 // Include guard stops here
 #endif /* SI_PROCESS_H_ */
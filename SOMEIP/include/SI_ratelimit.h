@@ -0,0 +1,76 @@
+// Include guard starts here
+#ifndef SI_RATELIMIT_H_
+#define SI_RATELIMIT_H_
+
+/**
+ * @file    SI_ratelimit.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Admission control for received requests.
+ *           Token-bucket limiter per requester (source address), prevents a single
+ *           misbehaving node from starving the others. Requesters are keyed by address only,
+ *           so rotating Client IDs does not yield new buckets."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+
+/**
+ * Tokens are stored in 1/1000 units, refill is exact even for 1 ms ticks.
+ */
+#define SI_RATELIMIT_TOKEN_SCALE            (1000u)
+
+#endif
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+
+/**
+ * Token bucket of a single requester
+ */
+struct SI_RATELIMIT_bucket
+{
+    boolean used;
+    uint32 src_ipv4;            // address of the requester (network order)
+    uint32 tokens;              // available tokens, scaled by SI_RATELIMIT_TOKEN_SCALE
+    uint32 last_refill_ms;      // time of the last refill
+    uint32 rejected;            // number of rejected requests of this requester
+};
+
+struct SI_RATELIMIT_counters
+{
+    uint32 admitted;            // number of admitted requests
+    uint32 rejected;            // number of rejected requests
+    uint32 evicted;             // number of requesters replaced due to full table
+};
+
+#endif
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+
+boolean SI_RATELIMIT_admit(const struct SI_Header* request, uint32 src_ipv4);
+void SI_RATELIMIT_get_counters(struct SI_RATELIMIT_counters* out_counters);
+void SI_RATELIMIT_tick(uint32 elapsed_time_ms);
+
+#endif
+
+// Include guard stops here
+#endif // SI_RATELIMIT_H_
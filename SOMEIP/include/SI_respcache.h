@@ -0,0 +1,89 @@
+// Include guard starts here
+#ifndef SI_RESPCACHE_H_
+#define SI_RESPCACHE_H_
+
+/**
+ * @file    SI_respcache.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Stores recently sent responses for duplicate-request suppression.
+ *           Clients retransmit requests over UDP if the response is late, a retransmitted request
+ *           is answered from the stored bytes instead of invoking the method handler again.
+ *           Memoizes responses of cacheable methods (e.g. field getters) as pre-serialised messages.
+ *           Maintains inner buffers, does not allocate heap dynamically."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+#include "SI_message.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+
+/**
+ * A stored response. Key: source address, Message ID and Request ID of the request.
+ */
+struct SI_RESPCACHE_element
+{
+    boolean used;
+    uint32 src_ipv4;            // address of the requester (network order)
+    struct SI_MessageID message_id;
+    struct SI_RequestID request_id;
+    uint32 age_ms;              // time elapsed since the response was stored
+    uint32 length;              // total length of stored response (header included)
+    uint8 buffer[SI_CFG_RESPCACHE_BLOCK_SIZE];
+};
+
+/**
+ * A memoized response of a cacheable method. Key: local port, Message ID and Interface Version.
+ * Request ID of the stored message is patched before every transmission.
+ */
+struct SI_RESPCACHE_memoElement
+{
+    boolean used;
+    uint16 local_port;          // port of the service instance
+    struct SI_MessageID message_id;
+    uint8 interface_version;
+    uint32 ttl_ms;              // 0u means "valid until invalidated"
+    uint32 age_ms;              // time elapsed since the response was stored
+    uint32 length;              // total length of stored response (header included)
+    uint8 buffer[SI_CFG_RESPCACHE_BLOCK_SIZE];
+};
+
+struct SI_RESPCACHE_pool
+{
+    struct SI_RESPCACHE_element pool[SI_CFG_RESPCACHE_ELEMENT_NUM];
+    struct SI_RESPCACHE_memoElement memo[SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM];
+};
+
+#endif
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+
+boolean SI_RESPCACHE_lookup(const struct SI_Header* request, uint32 src_ipv4, struct SI_MessageBuilder* out_response);
+boolean SI_RESPCACHE_store(const struct SI_Header* request, uint32 src_ipv4, const struct SI_MessageBuilder* response);
+boolean SI_RESPCACHE_memo_lookup(const struct SI_Header* request, uint16 local_port, struct SI_MessageBuilder* out_response);
+boolean SI_RESPCACHE_memo_store(const struct SI_Header* request, uint16 local_port, uint32 ttl_ms, const struct SI_MessageBuilder* response);
+void SI_RESPCACHE_memo_invalidate(uint16 service_id, uint16 method_id);
+void SI_RESPCACHE_tick(uint32 elapsed_time_ms);
+
+#endif
+
+// Include guard stops here
+#endif // SI_RESPCACHE_H_
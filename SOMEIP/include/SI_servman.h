@@ -32,21 +32,48 @@ struct SI_MessageContext
 {
     struct SI_Header header;
     struct SI_Payload payload; // ptr+len
+    uint16 local_port;         // port the message was received on, identifies the service instance (see SI_ServiceInstance)
 };
 
 /**
  * Method handler signature. Returns the response Return Code from the response message header.
  * @param req: the full received message context
- * @param resp_builder: builder for response message
+ * @param resp_builder: builder for response message, NULLPTR in case of REQUEST_NO_RETURN
  */ 
 typedef enum SI_ReturnCode_t (*SI_MethodHandler_fptr)(const struct SI_MessageContext* request,
                                                       struct SI_MessageBuilder* response);
 
+/**
+ * @note cacheable: TRUE only for idempotent methods (e.g. field getters). Responses of requests without payload
+ *       are memoized and served without invoking handler_func, until cache_ttl_ms elapses or
+ *       SI_RESPCACHE_memo_invalidate() is called. cache_ttl_ms == 0 means: valid until invalidated.
+ */
 struct SI_MethodEntry
 {
     boolean valid;
     uint16 method_id;
     SI_MethodHandler_fptr handler_func;
+    boolean cacheable;
+    uint32 cache_ttl_ms;
+};
+
+/**
+ * Event handler signature, invoked for received NOTIFICATION messages.
+ * @param notification: the full received message context
+ */
+typedef void (*SI_EventHandler_fptr)(const struct SI_MessageContext* notification);
+
+/**
+ * Element of the event handler index. Key: Service ID and Event ID.
+ * @note deleted: slot was used, lookup has to continue probing after it
+ */
+struct SI_EventHandlerEntry
+{
+    boolean valid;
+    boolean deleted;
+    uint16 service_id;
+    uint16 event_id;
+    SI_EventHandler_fptr handler_func;
 };
 
 enum SI_UsedTransmitProtocol_t
@@ -86,6 +113,9 @@ struct SI_Service* SI_SERVMAN_find_service(uint16 service_id, uint16 src_port, u
 struct SI_MethodEntry* SI_SERVMAN_find_method(struct SI_Service* service, uint16 method_id);
 boolean SI_SERVMAN_rmv_service(const struct SI_Service* service);
 boolean SI_SERVMAN_rmv_method(struct SI_Service* service, const struct SI_MethodEntry* method);
+boolean SI_SERVMAN_add_event_handler(uint16 service_id, uint16 event_id, SI_EventHandler_fptr handler_func);
+struct SI_EventHandlerEntry* SI_SERVMAN_find_event_handler(uint16 service_id, uint16 event_id);
+boolean SI_SERVMAN_rmv_event_handler(uint16 service_id, uint16 event_id);
 
 // Include guard stops here
 #endif // SI_SERVMAN_H_
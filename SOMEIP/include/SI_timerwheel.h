@@ -0,0 +1,99 @@
+// Include guard starts here
+#ifndef SI_TIMERWHEEL_H_
+#define SI_TIMERWHEEL_H_
+
+/**
+ * @file    SI_timerwheel.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Hierarchical timing wheel.
+ *           Timers are intrusive nodes owned by the user, arm and cancel are O(1),
+ *           advancing the time touches only the expiring slot (and a cascaded slot in every 64th tick).
+ *           Does not allocate heap dynamically."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_types.h"
+#include "SI_config.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define SI_TIMERWHEEL_SLOT_BITS         (6u)
+#define SI_TIMERWHEEL_SLOT_NUM          (1u << SI_TIMERWHEEL_SLOT_BITS)
+#define SI_TIMERWHEEL_SLOT_MASK         (SI_TIMERWHEEL_SLOT_NUM - 1u)
+#define SI_TIMERWHEEL_LEVEL_NUM         (4u)
+
+/**
+ * Longest delay in ticks, longer delays are clamped. (~46 hours at 10 ms resolution)
+ */
+#define SI_TIMERWHEEL_MAX_TICKS         ((1u << (SI_TIMERWHEEL_SLOT_BITS * SI_TIMERWHEEL_LEVEL_NUM)) - 1u)
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+/**
+ * Called when the timer expires. The node is disarmed already, it can be re-armed from the callback.
+ */
+typedef void (*SI_TIMERWHEEL_Callback_fptr)(void* context);
+
+/**
+ * Timer, embed it into the object to be timed.
+ */
+struct SI_TIMERWHEEL_node
+{
+    struct SI_TIMERWHEEL_node* next;
+    struct SI_TIMERWHEEL_node* prev;
+    struct SI_TIMERWHEEL_node** slot;   // list head the node is linked into, NULLPTR if not armed
+    uint32 expiry_tick;                 // absolute expiry time in ticks
+    SI_TIMERWHEEL_Callback_fptr callback;
+    void* context;
+};
+
+struct SI_TIMERWHEEL_wheel
+{
+    struct SI_TIMERWHEEL_node* slots[SI_TIMERWHEEL_LEVEL_NUM][SI_TIMERWHEEL_SLOT_NUM];
+    uint32 now_tick;                    // last processed tick
+    uint32 remainder_ms;                // elapsed time not yet converted to ticks
+};
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+void SI_TIMERWHEEL_init(struct SI_TIMERWHEEL_wheel* wheel);
+boolean SI_TIMERWHEEL_arm(struct SI_TIMERWHEEL_wheel* wheel, struct SI_TIMERWHEEL_node* node, uint32 delay_ms,
+                          SI_TIMERWHEEL_Callback_fptr callback, void* context);
+void SI_TIMERWHEEL_cancel(struct SI_TIMERWHEEL_node* node);
+void SI_TIMERWHEEL_advance(struct SI_TIMERWHEEL_wheel* wheel, uint32 elapsed_time_ms);
+
+/* **************************************************** */
+/*               Function definitions                   */
+/* **************************************************** */
+
+static inline boolean SI_TIMERWHEEL_is_armed(const struct SI_TIMERWHEEL_node* node)
+{
+    return (NULLPTR != node->slot);
+}
+
+/**
+ * @returns time left until the node expires [ms], 0u if it is not armed
+ */
+static inline uint32 SI_TIMERWHEEL_remaining_ms(const struct SI_TIMERWHEEL_wheel* wheel, const struct SI_TIMERWHEEL_node* node)
+{
+    const uint32 remaining_ms = (node->expiry_tick - wheel->now_tick) * SI_CFG_TIMERWHEEL_RESOLUTION_MS;
+
+    if ((FALSE == SI_TIMERWHEEL_is_armed(node)) || (remaining_ms <= wheel->remainder_ms))
+    {
+        return 0u;
+    }
+    return (remaining_ms - wheel->remainder_ms);
+}
+
+// Include guard stops here
+#endif // SI_TIMERWHEEL_H_
@@ -0,0 +1,79 @@
+// Include guard starts here
+#ifndef SI_TXQUEUE_H_
+#define SI_TXQUEUE_H_
+
+/**
+ * @file    SI_txqueue.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Bounded FIFO of deferred requests.
+ *           If Tx pool is exhausted, the request is stored here and answered as soon as a Tx buffer is released,
+ *           short bursts do not turn into client timeouts. Requests are dropped once their deadline passes.
+ *           Maintains inner buffers, does not allocate heap dynamically.
+ *
+ *           Handler contract: the whole request is deferred, not only its response, because the response is built
+ *           into the Tx buffer by the handler itself. The method handler of a deferred request is invoked once,
+ *           up to SI_CFG_TXQUEUE_DEADLINE_MS after reception, from SI_PROCESS_tick() or the end of a later
+ *           SI_PROCESS_unicast(). It is never invoked if the deadline passes first. Handlers must not depend on
+ *           being invoked at reception time (e.g. timestamping the request), they see the state at invocation."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "lwip/ip_addr.h"
+#include "lwip/udp.h"
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+#include "SI_servman.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                  Type definitions                    */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+
+/**
+ * A deferred request, copied out from the Rx buffer
+ */
+struct SI_TXQUEUE_element
+{
+    struct udp_pcb* pcb;        // Rx pcb, response is sent through it
+    ip_addr_t src_addr;
+    u16_t src_port;
+    struct SI_Header header;
+    uint32 payload_length;
+    uint8 payload[SI_CFG_TXQUEUE_PAYLOAD_SIZE];
+    uint32 age_ms;              // time elapsed since the request was deferred
+};
+
+struct SI_TXQUEUE_counters
+{
+    uint32 deferred;            // number of deferred requests
+    uint32 expired;             // number of requests dropped due to deadline
+    uint32 overflow;            // number of requests dropped due to full queue
+};
+
+#endif
+
+/* **************************************************** */
+/*               Function declarations                  */
+/* **************************************************** */
+
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+
+boolean SI_TXQUEUE_push(struct udp_pcb* pcb, const struct SI_MessageContext* request, const ip_addr_t* src_addr, u16_t src_port);
+boolean SI_TXQUEUE_pop(struct SI_TXQUEUE_element* out_element);
+void SI_TXQUEUE_get_counters(struct SI_TXQUEUE_counters* out_counters);
+void SI_TXQUEUE_tick(uint32 elapsed_time_ms);
+
+#endif
+
+// Include guard stops here
+#endif // SI_TXQUEUE_H_
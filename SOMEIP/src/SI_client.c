@@ -0,0 +1,448 @@
+/**
+ * @file    SI_client.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_client.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_client.h"
+
+#include "lwip/udp.h"
+#include "SomeIP_udp.h"     // for SomeIP_udp_transmit
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_const.h"
+#include "SI_header.h"
+#include "SI_message.h"
+#include "SI_servman.h"
+#include "SI_hash.h"
+#include "SI_timerwheel.h"
+
+#include <assert.h>
+#include <string.h>         // for memset, memcpy
+
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+
+static_assert(SI_HASH_IS_POWER_OF_TWO(SI_CFG_CLIENT_PENDING_NUM), "FATAL ERROR: SI_CFG_CLIENT_PENDING_NUM must be a power of two!");
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SI_CLIENT_pendingElement g_pending[SI_CFG_CLIENT_PENDING_NUM];
+static uint32 g_pending_count = 0u;
+static struct SI_CLIENT_session g_sessions[SI_CFG_CLIENT_ID_NUM];
+static struct SI_CLIENT_counters g_counters;
+static struct SI_TIMERWHEEL_wheel g_wheel;
+static boolean g_wheel_initialized = FALSE;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static inline uint32 SI_CLIENT_home(uint16 service_id, uint16 method_id, uint16 client_id, uint16 session_id);
+static struct SI_CLIENT_pendingElement* SI_CLIENT_find(uint16 service_id, uint16 method_id, uint16 client_id, uint16 session_id);
+static struct SI_CLIENT_pendingElement* SI_CLIENT_insert(uint16 service_id, uint16 method_id, uint16 client_id, uint16 session_id);
+static void SI_CLIENT_release(struct SI_CLIENT_pendingElement* element);
+static void SI_CLIENT_timeout(void* context);
+static boolean SI_CLIENT_next_session(uint16 client_id, uint16* out_session_id);
+static boolean SI_CLIENT_transmit(const struct SI_CLIENT_RequestParams* params, uint16 session_id, enum SI_MessageType_t type,
+                                  const uint8* payload, uint32 payload_length);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Sends a request to a remote method. The request stays outstanding until its response arrives, it times out
+ * or it is cancelled, further requests can be sent meanwhile.
+ *
+ * @param params: addressing and timeout policy of the remote method
+ * @param payload: serialised arguments, can be NULLPTR if payload_length is 0
+ * @param callback: called when the response arrives. NULLPTR: REQUEST_NO_RETURN is sent, nothing is kept outstanding.
+ * @param user_data: passed to callback
+ * @param out_session_id (optional): Session ID of the request, needed for SI_CLIENT_cancel(). If not needed give NULLPTR.
+ *
+ * @returns TRUE if request is sent
+ */
+boolean SI_CLIENT_request(const struct SI_CLIENT_RequestParams* params, const uint8* payload, uint32 payload_length,
+                          SI_CLIENT_ResponseCallback_fptr callback, void* user_data, uint16* out_session_id)
+{
+    struct SI_CLIENT_pendingElement* element = NULLPTR;
+    uint16 session_id = 0u;
+    enum SI_MessageType_t type = SI_MessageType_REQUEST_NO_RETURN;
+
+    if ((NULLPTR == params) || (NULLPTR == params->pcb) || (FALSE == SI_HEADER_is_method(params->method_id)))
+    {
+        return FALSE;
+    }
+
+    if ((0u < params->max_retries) && (SI_CFG_CLIENT_RETRY_PAYLOAD_SIZE < payload_length))
+    {
+        // Request could not be retransmitted
+        return FALSE;
+    }
+
+    if (FALSE == g_wheel_initialized)
+    {
+        SI_TIMERWHEEL_init(&g_wheel);
+        g_wheel_initialized = TRUE;
+    }
+
+    if (FALSE == SI_CLIENT_next_session(params->client_id, &session_id))
+    {
+        return FALSE;
+    }
+
+    // Request is registered before transmission, response can not overtake it
+    if (NULLPTR != callback)
+    {
+        type = SI_MessageType_REQUEST;
+
+        element = SI_CLIENT_insert(params->service_id, params->method_id, params->client_id, session_id);
+        if (NULLPTR == element)
+        {
+            return FALSE;
+        }
+
+        element->params = *params;
+        element->callback = callback;
+        element->user_data = user_data;
+        element->retries_left = params->max_retries;
+        element->payload_length = 0u;
+
+        if ((0u < params->max_retries) && (0u < payload_length))
+        {
+            memcpy(element->payload, payload, payload_length);
+            element->payload_length = payload_length;
+        }
+    }
+
+    if (FALSE == SI_CLIENT_transmit(params, session_id, type, payload, payload_length))
+    {
+        if (NULLPTR != element)
+        {
+            SI_CLIENT_release(element);
+        }
+        return FALSE;
+    }
+
+    if (NULLPTR != element)
+    {
+        (void)SI_TIMERWHEEL_arm(&g_wheel, &(element->timer),
+                                ((0u == params->timeout_ms) ? SI_CFG_CLIENT_DEFAULT_TIMEOUT_MS : params->timeout_ms),
+                                SI_CLIENT_timeout, element);
+    }
+
+    if (NULLPTR != out_session_id)
+    {
+        *out_session_id = session_id;
+    }
+
+    g_counters.sent += 1u;
+    return TRUE;
+}
+
+/**
+ * Completes the outstanding request of a received RESPONSE or ERROR message.
+ * Request is removed before its callback is invoked, callback can send new requests.
+ *
+ * @param response: parsed RESPONSE or ERROR message
+ * @param src_ipv4: address of the sender (network order)
+ *
+ * @returns TRUE if the message completed an outstanding request
+ */
+boolean SI_CLIENT_handle_response(const struct SI_MessageContext* response, uint32 src_ipv4)
+{
+    struct SI_CLIENT_pendingElement* element = NULLPTR;
+    SI_CLIENT_ResponseCallback_fptr callback = NULLPTR;
+    void* user_data = NULLPTR;
+
+    if ((NULLPTR == response) || (FALSE == SI_HEADER_validate(&(response->header))))
+    {
+        return FALSE;
+    }
+
+    if ((SI_MessageType_RESPONSE != response->header.message_type) &&
+        (SI_MessageType_ERROR != response->header.message_type))
+    {
+        return FALSE;
+    }
+
+    element = SI_CLIENT_find(response->header.message_id.serviceID,
+                             response->header.message_id.methodID_or_eventID,
+                             response->header.request_id.clientID,
+                             response->header.request_id.sessionID);
+
+    if ((NULLPTR == element) || (src_ipv4 != element->params.dst_ipv4))
+    {
+        // Late response of a cancelled request, or a response that was never requested
+        g_counters.unmatched += 1u;
+        return FALSE;
+    }
+
+    callback = element->callback;
+    user_data = element->user_data;
+    SI_CLIENT_release(element);
+    g_counters.completed += 1u;
+
+    callback(response, response->header.return_code, user_data);
+    return TRUE;
+}
+
+/**
+ * Removes an outstanding request without invoking its callback. Its response will be dropped.
+ *
+ * @returns TRUE if request was outstanding
+ */
+boolean SI_CLIENT_cancel(uint16 service_id, uint16 method_id, uint16 client_id, uint16 session_id)
+{
+    struct SI_CLIENT_pendingElement* element = SI_CLIENT_find(service_id, method_id, client_id, session_id);
+
+    if (NULLPTR == element)
+    {
+        return FALSE;
+    }
+
+    SI_CLIENT_release(element);
+    return TRUE;
+}
+
+uint32 SI_CLIENT_get_pending_count(void)
+{
+    return g_pending_count;
+}
+
+void SI_CLIENT_get_counters(struct SI_CLIENT_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/**
+ * Timekeeping: retransmits and times out the outstanding requests, timeout callbacks are invoked from here.
+ * @note Call this in every cycle!
+ */
+void SI_CLIENT_tick(uint32 elapsed_time_ms)
+{
+    if (TRUE == g_wheel_initialized)
+    {
+        SI_TIMERWHEEL_advance(&g_wheel, elapsed_time_ms);
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static inline uint32 SI_CLIENT_home(uint16 service_id, uint16 method_id, uint16 client_id, uint16 session_id)
+{
+    const uint32 hash = SI_HASH_combine(SI_HASH_u32(((uint32)service_id << 16u) | (uint32)method_id),
+                                        ((uint32)client_id << 16u) | (uint32)session_id);
+    return (hash & (SI_CFG_CLIENT_PENDING_NUM - 1u));
+}
+
+/**
+ * @returns Outstanding request with the given key, NULLPTR if there is none
+ */
+static struct SI_CLIENT_pendingElement* SI_CLIENT_find(uint16 service_id, uint16 method_id, uint16 client_id, uint16 session_id)
+{
+    uint32 i = 0u;
+    const uint32 index = SI_CLIENT_home(service_id, method_id, client_id, session_id);
+    struct SI_CLIENT_pendingElement* element = NULLPTR;
+
+    for (i = 0u; i < SI_CFG_CLIENT_PENDING_NUM; i++)
+    {
+        element = &(g_pending[(index + i) & (SI_CFG_CLIENT_PENDING_NUM - 1u)]);
+
+        if ((FALSE == element->valid) && (FALSE == element->deleted))
+        {
+            // never used slot, end of probe sequence
+            return NULLPTR;
+        }
+
+        if ((TRUE == element->valid) &&
+            (service_id == element->params.service_id) && (method_id == element->params.method_id) &&
+            (client_id == element->params.client_id) && (session_id == element->session_id))
+        {
+            return element;
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * @returns Reserved element, NULLPTR if table is full or the key is already outstanding
+ *          (Session ID wrapped while an old request is still pending)
+ */
+static struct SI_CLIENT_pendingElement* SI_CLIENT_insert(uint16 service_id, uint16 method_id, uint16 client_id, uint16 session_id)
+{
+    uint32 i = 0u;
+    const uint32 index = SI_CLIENT_home(service_id, method_id, client_id, session_id);
+    struct SI_CLIENT_pendingElement* element = NULLPTR;
+
+    if ((SI_CFG_CLIENT_PENDING_NUM <= g_pending_count) ||
+        (NULLPTR != SI_CLIENT_find(service_id, method_id, client_id, session_id)))
+    {
+        return NULLPTR;
+    }
+
+    for (i = 0u; i < SI_CFG_CLIENT_PENDING_NUM; i++)
+    {
+        element = &(g_pending[(index + i) & (SI_CFG_CLIENT_PENDING_NUM - 1u)]);
+
+        if (FALSE == element->valid)
+        {
+            element->valid = TRUE;
+            element->deleted = FALSE;
+            element->params.service_id = service_id;
+            element->params.method_id = method_id;
+            element->params.client_id = client_id;
+            element->session_id = session_id;
+            g_pending_count += 1u;
+            return element;
+        }
+    }
+    return NULLPTR;
+}
+
+static void SI_CLIENT_release(struct SI_CLIENT_pendingElement* element)
+{
+    SI_TIMERWHEEL_cancel(&(element->timer));
+    element->valid = FALSE;
+    element->deleted = TRUE;
+    element->callback = NULLPTR;
+    element->user_data = NULLPTR;
+    g_pending_count -= 1u;
+
+    if (0u == g_pending_count)
+    {
+        // No outstanding request: deleted markers can be dropped, probe sequences become short again
+        memset(g_pending, 0, sizeof(g_pending));
+    }
+}
+
+/**
+ * Timer callback of an outstanding request: retransmits the request while retries are left,
+ * then completes it with SI_ReturnCode_TIMEOUT.
+ */
+static void SI_CLIENT_timeout(void* context)
+{
+    struct SI_CLIENT_pendingElement* element = (struct SI_CLIENT_pendingElement*)context;
+    SI_CLIENT_ResponseCallback_fptr callback = NULLPTR;
+    void* user_data = NULLPTR;
+    const uint32 timeout_ms = ((0u == element->params.timeout_ms) ? SI_CFG_CLIENT_DEFAULT_TIMEOUT_MS : element->params.timeout_ms);
+
+    if (0u < element->retries_left)
+    {
+        // Failed transmission (e.g. Tx pool exhausted) consumes the retry as well
+        element->retries_left -= 1u;
+        (void)SI_CLIENT_transmit(&(element->params), element->session_id, SI_MessageType_REQUEST,
+                                 element->payload, element->payload_length);
+        (void)SI_TIMERWHEEL_arm(&g_wheel, &(element->timer), timeout_ms, SI_CLIENT_timeout, element);
+        g_counters.retransmitted += 1u;
+        return;
+    }
+
+    callback = element->callback;
+    user_data = element->user_data;
+    SI_CLIENT_release(element);
+    g_counters.timed_out += 1u;
+
+    callback(NULLPTR, SI_ReturnCode_TIMEOUT, user_data);
+}
+
+/**
+ * Allocates the next Session ID of a Client ID. Unknown Client ID gets a free counter.
+ *
+ * @returns FALSE if every counter is used by other Client IDs
+ */
+static boolean SI_CLIENT_next_session(uint16 client_id, uint16* out_session_id)
+{
+    uint32 i = 0u;
+    struct SI_CLIENT_session* session = NULLPTR;
+
+    for (i = 0u; i < SI_CFG_CLIENT_ID_NUM; i++)
+    {
+        if ((TRUE == g_sessions[i].used) && (client_id == g_sessions[i].client_id))
+        {
+            session = &(g_sessions[i]);
+            break;
+        }
+
+        if ((FALSE == g_sessions[i].used) && (NULLPTR == session))
+        {
+            session = &(g_sessions[i]);
+        }
+    }
+
+    if (NULLPTR == session)
+    {
+        return FALSE;
+    }
+
+    if (FALSE == session->used)
+    {
+        session->used = TRUE;
+        session->client_id = client_id;
+        session->session_id = 0u;
+    }
+
+    session->session_id = SI_HEADER_increment_sessionID(session->session_id);
+    *out_session_id = session->session_id;
+    return TRUE;
+}
+
+static boolean SI_CLIENT_transmit(const struct SI_CLIENT_RequestParams* params, uint16 session_id, enum SI_MessageType_t type,
+                                  const uint8* payload, uint32 payload_length)
+{
+    struct SI_MessageBuilder request;
+    struct SI_Header header;
+    boolean retval = FALSE;
+
+    header.message_id.serviceID = params->service_id;
+    header.message_id.methodID_or_eventID = params->method_id;
+    header.length = 0u;
+    header.request_id.clientID = params->client_id;
+    header.request_id.sessionID = session_id;
+    header.protocol_version = SI_CONST_PROTO_VERSION;
+    header.interface_version = params->interface_version;
+    header.message_type = type;
+    header.return_code = SI_ReturnCode_OK;
+
+    if (FALSE == SI_MESSAGE_init(&request))
+    {
+        return FALSE;
+    }
+
+    if ((TRUE == SI_MESSAGE_put(&request, payload, payload_length)) &&
+        (TRUE == SI_MESSAGE_finalize(&request, &header, NULLPTR)))
+    {
+        retval = (ERR_OK == SomeIP_udp_transmit(params->pcb, params->dst_ipv4, params->dst_port, &request));
+    }
+
+    (void)SI_MESSAGE_invalidate(&request);
+    return retval;
+}
+
+#endif
+
+/* END OF SI_CLIENT.C FILE */
@@ -0,0 +1,599 @@
+/**
+ * @file    SI_event.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_event.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_event.h"
+
+#include "lwip/udp.h"
+#include "SomeIP_udp.h"     // for SomeIP_udp_transmit
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_const.h"
+#include "SI_header.h"
+#include "SI_message.h"
+
+#include <assert.h>
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+
+static_assert(32u >= SI_CFG_MAX_EVENT_GROUPS, "FATAL ERROR: Eventgroup membership of events is stored in a 32 bit mask!");
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SI_EVENT_eventgroup g_eventgroups[SI_CFG_MAX_EVENT_GROUPS];
+static struct SI_EVENT_event g_events[SI_CFG_MAX_EVENTS];
+static struct SI_EVENT_counters g_counters;
+static SI_EVENT_SubscribeHook_fptr g_subscribe_hooks[SI_CFG_MAX_SUBSCRIBE_HOOKS];
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static struct SI_EVENT_subscriber* SI_EVENT_find_subscriber(struct SI_EVENT_eventgroup* eventgroup, uint32 ipv4, uint16 port);
+static inline boolean SI_EVENT_uses_multicast(const struct SI_EVENT_eventgroup* eventgroup);
+static boolean SI_EVENT_already_served(uint32 eventgroup_mask, uint32 eventgroup_index, const struct SI_EVENT_subscriber* subscriber);
+static boolean SI_EVENT_serialize(struct SI_EVENT_event* event, const uint8* payload, uint32 payload_length, struct SI_MessageBuilder* out_notification);
+static boolean SI_EVENT_has_subscribers(const struct SI_EVENT_event* event);
+static boolean SI_EVENT_fan_out(const struct SI_EVENT_event* event, struct SI_MessageBuilder* notification);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Registers an eventgroup of a local service instance.
+ *
+ * @param pcb: local pcb of the service instance, notifications are sent through it
+ *
+ * @returns TRUE if eventgroup is registered (or it is registered already)
+ */
+boolean SI_EVENT_add_eventgroup(struct udp_pcb* pcb, uint16 service_id, uint16 instance_id, uint16 eventgroup_id)
+{
+    uint32 i = 0u;
+
+    if (NULLPTR == pcb)
+    {
+        return FALSE;
+    }
+
+    if (NULLPTR != SI_EVENT_find_eventgroup(service_id, instance_id, eventgroup_id))
+    {
+        return TRUE;
+    }
+
+    for (i = 0u; i < SI_CFG_MAX_EVENT_GROUPS; i++)
+    {
+        if (FALSE == g_eventgroups[i].valid)
+        {
+            g_eventgroups[i].valid = TRUE;
+            g_eventgroups[i].service_id = service_id;
+            g_eventgroups[i].instance_id = instance_id;
+            g_eventgroups[i].eventgroup_id = eventgroup_id;
+            g_eventgroups[i].pcb = pcb;
+            g_eventgroups[i].subscriber_count = 0u;
+            g_eventgroups[i].multicast_ipv4 = 0u;
+            g_eventgroups[i].multicast_port = 0u;
+            g_eventgroups[i].multicast_threshold = 0u;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Adds an event to a registered eventgroup. Event is created at its first addition.
+ *
+ * @returns TRUE if event belongs to the eventgroup
+ */
+boolean SI_EVENT_add_event(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint16 event_id, uint8 interface_version)
+{
+    uint32 i = 0u;
+    struct SI_EVENT_eventgroup* eventgroup = SI_EVENT_find_eventgroup(service_id, instance_id, eventgroup_id);
+    struct SI_EVENT_event* event = NULLPTR;
+
+    if ((NULLPTR == eventgroup) || (FALSE == SI_HEADER_is_event(event_id)))
+    {
+        return FALSE;
+    }
+
+    event = SI_EVENT_find_event(service_id, event_id);
+
+    for (i = 0u; (NULLPTR == event) && (i < SI_CFG_MAX_EVENTS); i++)
+    {
+        if (FALSE == g_events[i].valid)
+        {
+            event = &(g_events[i]);
+            event->valid = TRUE;
+            event->service_id = service_id;
+            event->event_id = event_id;
+            event->interface_version = interface_version;
+            event->session_id = 0u;
+            event->eventgroup_mask = 0u;
+        }
+    }
+
+    if (NULLPTR == event)
+    {
+        return FALSE;
+    }
+
+    event->eventgroup_mask |= (1u << (uint32)(eventgroup - g_eventgroups));
+    return TRUE;
+}
+
+struct SI_EVENT_eventgroup* SI_EVENT_find_eventgroup(uint16 service_id, uint16 instance_id, uint16 eventgroup_id)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_CFG_MAX_EVENT_GROUPS; i++)
+    {
+        if ((TRUE == g_eventgroups[i].valid) &&
+            (service_id == g_eventgroups[i].service_id) &&
+            (instance_id == g_eventgroups[i].instance_id) &&
+            (eventgroup_id == g_eventgroups[i].eventgroup_id))
+        {
+            return &(g_eventgroups[i]);
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * @returns pointer for event, NULLPTR if event is not registered. Keep it, notify needs no further lookup.
+ */
+struct SI_EVENT_event* SI_EVENT_find_event(uint16 service_id, uint16 event_id)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_CFG_MAX_EVENTS; i++)
+    {
+        if ((TRUE == g_events[i].valid) &&
+            (service_id == g_events[i].service_id) &&
+            (event_id == g_events[i].event_id))
+        {
+            return &(g_events[i]);
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * Adds a subscriber to an eventgroup. Subscribe hooks are not invoked: call SI_EVENT_announce_subscriber()
+ * once the subscriber is ready to receive notifications (e.g. after SubscribeEventgroupAck is sent).
+ *
+ * @returns TRUE if subscriber is added (or it is subscribed already)
+ */
+boolean SI_EVENT_subscribe(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4, uint16 port)
+{
+    uint32 i = 0u;
+    struct SI_EVENT_eventgroup* eventgroup = SI_EVENT_find_eventgroup(service_id, instance_id, eventgroup_id);
+
+    if (NULLPTR == eventgroup)
+    {
+        return FALSE;
+    }
+
+    if (NULLPTR != SI_EVENT_find_subscriber(eventgroup, ipv4, port))
+    {
+        return TRUE;
+    }
+
+    for (i = 0u; i < SI_CFG_MAX_EVENTGROUP_SUBSCRIBERS; i++)
+    {
+        if (FALSE == eventgroup->subscriber[i].used)
+        {
+            eventgroup->subscriber[i].used = TRUE;
+            eventgroup->subscriber[i].ipv4 = ipv4;
+            eventgroup->subscriber[i].port = port;
+            eventgroup->subscriber_count += 1u;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+boolean SI_EVENT_unsubscribe(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4, uint16 port)
+{
+    struct SI_EVENT_eventgroup* eventgroup = SI_EVENT_find_eventgroup(service_id, instance_id, eventgroup_id);
+    struct SI_EVENT_subscriber* subscriber = NULLPTR;
+
+    if (NULLPTR == eventgroup)
+    {
+        return FALSE;
+    }
+
+    subscriber = SI_EVENT_find_subscriber(eventgroup, ipv4, port);
+    if (NULLPTR == subscriber)
+    {
+        return FALSE;
+    }
+
+    subscriber->used = FALSE;
+    eventgroup->subscriber_count -= 1u;
+    return TRUE;
+}
+
+/**
+ * Sends a notification to every subscriber of the event. Message is serialised only once.
+ * A subscriber of several eventgroups of the event gets the notification once.
+ *
+ * @param event: event, see SI_EVENT_find_event()
+ * @param payload: serialised event data, can be NULLPTR if payload_length is 0
+ *
+ * @returns TRUE if notification is sent to at least one destination (or there is no subscriber).
+ *          FALSE if nothing is sent: notifying again does not duplicate it at any subscriber.
+ */
+boolean SI_EVENT_notify(struct SI_EVENT_event* event, const uint8* payload, uint32 payload_length)
+{
+    struct SI_MessageBuilder notification;
+    boolean retval = FALSE;
+
+    if ((NULLPTR == event) || (FALSE == event->valid))
+    {
+        return FALSE;
+    }
+
+    if (FALSE == SI_EVENT_has_subscribers(event))
+    {
+        return TRUE;
+    }
+
+    if (FALSE == SI_MESSAGE_init(&notification))
+    {
+        return FALSE;
+    }
+
+    if (TRUE == SI_EVENT_serialize(event, payload, payload_length, &notification))
+    {
+        retval = SI_EVENT_fan_out(event, &notification);
+    }
+
+    (void)SI_MESSAGE_invalidate(&notification);
+    return retval;
+}
+
+/**
+ * Sends a notification to a single subscriber, e.g. initial value of a field to a new subscriber.
+ *
+ * @param eventgroup: eventgroup of the subscriber, event must belong to it
+ *
+ * @returns TRUE if notification is sent
+ */
+boolean SI_EVENT_notify_subscriber(struct SI_EVENT_event* event, const struct SI_EVENT_eventgroup* eventgroup,
+                                   const struct SI_EVENT_subscriber* subscriber, const uint8* payload, uint32 payload_length)
+{
+    struct SI_MessageBuilder notification;
+    boolean retval = FALSE;
+
+    if ((NULLPTR == subscriber) || (FALSE == SI_EVENT_is_member(event, eventgroup)))
+    {
+        return FALSE;
+    }
+
+    if (FALSE == SI_MESSAGE_init(&notification))
+    {
+        return FALSE;
+    }
+
+    if (TRUE == SI_EVENT_serialize(event, payload, payload_length, &notification))
+    {
+        retval = (ERR_OK == SomeIP_udp_transmit(eventgroup->pcb, subscriber->ipv4, subscriber->port, &notification));
+        if (TRUE == retval)
+        {
+            g_counters.sent += 1u;
+        }
+        else
+        {
+            g_counters.tx_failed += 1u;
+        }
+    }
+
+    (void)SI_MESSAGE_invalidate(&notification);
+    return retval;
+}
+
+/**
+ * Configures multicast delivery of an eventgroup. Notifications go to the multicast group
+ * while the eventgroup has more than threshold subscribers, otherwise they are sent to every subscriber.
+ * Send cost depends on the number of network segments instead of the number of subscribers.
+ *
+ * @param ipv4: multicast group address (network order), 0u disables multicast delivery
+ * @param port: multicast port (host order)
+ * @param threshold: number of subscribers above multicast is used
+ *
+ * @returns TRUE if eventgroup is configured
+ */
+boolean SI_EVENT_set_multicast(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4, uint16 port, uint32 threshold)
+{
+    struct SI_EVENT_eventgroup* eventgroup = SI_EVENT_find_eventgroup(service_id, instance_id, eventgroup_id);
+
+    if (NULLPTR == eventgroup)
+    {
+        return FALSE;
+    }
+
+    eventgroup->multicast_ipv4 = ipv4;
+    eventgroup->multicast_port = port;
+    eventgroup->multicast_threshold = threshold;
+    return TRUE;
+}
+
+/**
+ * Multicast endpoint of the eventgroup, advertised to subscribers by SD (IPv4 Multicast Option).
+ *
+ * @returns TRUE if multicast delivery is configured
+ */
+boolean SI_EVENT_get_multicast(const struct SI_EVENT_eventgroup* eventgroup, uint32* out_ipv4, uint16* out_port)
+{
+    if ((NULLPTR == eventgroup) || (NULLPTR == out_ipv4) || (NULLPTR == out_port) || (0u == eventgroup->multicast_ipv4))
+    {
+        return FALSE;
+    }
+
+    *out_ipv4 = eventgroup->multicast_ipv4;
+    *out_port = eventgroup->multicast_port;
+    return TRUE;
+}
+
+/**
+ * @returns TRUE if event belongs to the eventgroup
+ */
+boolean SI_EVENT_is_member(const struct SI_EVENT_event* event, const struct SI_EVENT_eventgroup* eventgroup)
+{
+    if ((NULLPTR == event) || (NULLPTR == eventgroup) || (FALSE == event->valid) || (FALSE == eventgroup->valid))
+    {
+        return FALSE;
+    }
+
+    return (0u != (event->eventgroup_mask & (1u << (uint32)(eventgroup - g_eventgroups))));
+}
+
+/**
+ * Invokes every subscribe hook for a new subscriber of the eventgroup (e.g. initial values of fields are sent).
+ *
+ * @returns FALSE if subscriber is not found
+ */
+boolean SI_EVENT_announce_subscriber(uint16 service_id, uint16 instance_id, uint16 eventgroup_id, uint32 ipv4, uint16 port)
+{
+    uint32 i = 0u;
+    struct SI_EVENT_eventgroup* eventgroup = SI_EVENT_find_eventgroup(service_id, instance_id, eventgroup_id);
+    const struct SI_EVENT_subscriber* subscriber = NULLPTR;
+
+    if (NULLPTR == eventgroup)
+    {
+        return FALSE;
+    }
+
+    subscriber = SI_EVENT_find_subscriber(eventgroup, ipv4, port);
+    if (NULLPTR == subscriber)
+    {
+        return FALSE;
+    }
+
+    for (i = 0u; (i < SI_CFG_MAX_SUBSCRIBE_HOOKS) && (NULLPTR != g_subscribe_hooks[i]); i++)
+    {
+        g_subscribe_hooks[i](eventgroup, subscriber);
+    }
+    return TRUE;
+}
+
+/**
+ * Adds a hook to the chain of subscribe hooks. Hooks are invoked in the order of registration.
+ *
+ * @returns TRUE if hook is added (or it is added already), FALSE if chain is full
+ */
+boolean SI_EVENT_add_subscribe_hook(SI_EVENT_SubscribeHook_fptr hook)
+{
+    uint32 i = 0u;
+
+    if (NULLPTR == hook)
+    {
+        return FALSE;
+    }
+
+    for (i = 0u; i < SI_CFG_MAX_SUBSCRIBE_HOOKS; i++)
+    {
+        if (hook == g_subscribe_hooks[i])
+        {
+            return TRUE;
+        }
+
+        if (NULLPTR == g_subscribe_hooks[i])
+        {
+            g_subscribe_hooks[i] = hook;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+void SI_EVENT_get_counters(struct SI_EVENT_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static struct SI_EVENT_subscriber* SI_EVENT_find_subscriber(struct SI_EVENT_eventgroup* eventgroup, uint32 ipv4, uint16 port)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_CFG_MAX_EVENTGROUP_SUBSCRIBERS; i++)
+    {
+        if ((TRUE == eventgroup->subscriber[i].used) &&
+            (ipv4 == eventgroup->subscriber[i].ipv4) &&
+            (port == eventgroup->subscriber[i].port))
+        {
+            return &(eventgroup->subscriber[i]);
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * Assembles the notification of the event into a builder holding a Tx buffer. New Session ID is used.
+ */
+static boolean SI_EVENT_serialize(struct SI_EVENT_event* event, const uint8* payload, uint32 payload_length, struct SI_MessageBuilder* out_notification)
+{
+    struct SI_Header header;
+
+    event->session_id = SI_HEADER_increment_sessionID(event->session_id);
+
+    header.message_id.serviceID = event->service_id;
+    header.message_id.methodID_or_eventID = event->event_id;
+    header.length = 0u;
+    header.request_id.clientID = 0u;
+    header.request_id.sessionID = event->session_id;
+    header.protocol_version = SI_CONST_PROTO_VERSION;
+    header.interface_version = event->interface_version;
+    header.message_type = SI_MessageType_NOTIFICATION;
+    header.return_code = SI_ReturnCode_OK;
+
+    if ((TRUE == SI_MESSAGE_put(out_notification, payload, payload_length)) &&
+        (TRUE == SI_MESSAGE_finalize(out_notification, &header, NULLPTR)))
+    {
+        g_counters.notified += 1u;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static inline boolean SI_EVENT_uses_multicast(const struct SI_EVENT_eventgroup* eventgroup)
+{
+    return ((0u != eventgroup->multicast_ipv4) && (eventgroup->multicast_threshold < eventgroup->subscriber_count));
+}
+
+/**
+ * @returns TRUE if subscriber gets the notification through an other eventgroup of the mask:
+ *          it is subscribed to a multicast eventgroup, or to a unicast eventgroup that precedes eventgroup_index
+ */
+static boolean SI_EVENT_already_served(uint32 eventgroup_mask, uint32 eventgroup_index, const struct SI_EVENT_subscriber* subscriber)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_CFG_MAX_EVENT_GROUPS; i++)
+    {
+        if ((i == eventgroup_index) || (0u == (eventgroup_mask & (1u << i))) || (FALSE == g_eventgroups[i].valid))
+        {
+            continue;
+        }
+
+        if (((i < eventgroup_index) || (TRUE == SI_EVENT_uses_multicast(&(g_eventgroups[i])))) &&
+            (NULLPTR != SI_EVENT_find_subscriber(&(g_eventgroups[i]), subscriber->ipv4, subscriber->port)))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * @returns TRUE if an eventgroup of the event has a subscriber
+ */
+static boolean SI_EVENT_has_subscribers(const struct SI_EVENT_event* event)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_CFG_MAX_EVENT_GROUPS; i++)
+    {
+        if ((0u != (event->eventgroup_mask & (1u << i))) && (TRUE == g_eventgroups[i].valid) && (0u < g_eventgroups[i].subscriber_count))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Sends the finalized notification to every subscriber of the event.
+ * Destinations whose transmission failed miss this notification, see SI_EVENT_notify().
+ *
+ * @returns FALSE if notification is sent to no destination although it had to
+ */
+static boolean SI_EVENT_fan_out(const struct SI_EVENT_event* event, struct SI_MessageBuilder* notification)
+{
+    uint32 i = 0u;
+    uint32 j = 0u;
+    struct SI_EVENT_eventgroup* eventgroup = NULLPTR;
+    const struct SI_EVENT_subscriber* subscriber = NULLPTR;
+    boolean delivered = FALSE;
+    boolean failed = FALSE;
+
+    for (i = 0u; i < SI_CFG_MAX_EVENT_GROUPS; i++)
+    {
+        eventgroup = &(g_eventgroups[i]);
+
+        if ((0u == (event->eventgroup_mask & (1u << i))) || (FALSE == eventgroup->valid) || (0u == eventgroup->subscriber_count))
+        {
+            continue;
+        }
+
+        // Many subscribers -> a single datagram to the multicast group
+        if (TRUE == SI_EVENT_uses_multicast(eventgroup))
+        {
+            if (ERR_OK == SomeIP_udp_transmit(eventgroup->pcb, eventgroup->multicast_ipv4, eventgroup->multicast_port, notification))
+            {
+                g_counters.multicast_sent += 1u;
+                delivered = TRUE;
+            }
+            else
+            {
+                g_counters.tx_failed += 1u;
+                failed = TRUE;
+            }
+            continue;
+        }
+
+        for (j = 0u; j < SI_CFG_MAX_EVENTGROUP_SUBSCRIBERS; j++)
+        {
+            subscriber = &(eventgroup->subscriber[j]);
+
+            if ((FALSE == subscriber->used) || (TRUE == SI_EVENT_already_served(event->eventgroup_mask, i, subscriber)))
+            {
+                continue;
+            }
+
+            if (ERR_OK == SomeIP_udp_transmit(eventgroup->pcb, subscriber->ipv4, subscriber->port, notification))
+            {
+                g_counters.sent += 1u;
+                delivered = TRUE;
+            }
+            else
+            {
+                g_counters.tx_failed += 1u;
+                failed = TRUE;
+            }
+        }
+    }
+    return ((TRUE == delivered) || (FALSE == failed));
+}
+
+#endif
+
+/* END OF SI_EVENT.C FILE */
@@ -0,0 +1,317 @@
+/**
+ * @file    SI_eventsched.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_eventsched.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_eventsched.h"
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_event.h"
+#include "SI_timerwheel.h"
+
+#include <string.h>         // for memcmp, memcpy
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SI_EVENTSCHED_element g_elements[SI_CFG_EVENTSCHED_ELEMENT_NUM];
+static struct SI_EVENTSCHED_counters g_counters;
+static struct SI_TIMERWHEEL_wheel g_wheel;
+static boolean g_wheel_initialized = FALSE;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static void SI_EVENTSCHED_send(struct SI_EVENTSCHED_element* element);
+static void SI_EVENTSCHED_send_or_retry(struct SI_EVENTSCHED_element* element);
+static boolean SI_EVENTSCHED_is_notified(const struct SI_EVENTSCHED_element* element, const uint8* payload, uint32 payload_length);
+static void SI_EVENTSCHED_timer_expired(void* context);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Sets the transmission mode of an event. Configuring an already scheduled event changes its mode,
+ * the latest value is kept.
+ *
+ * @param event: event, see SI_EVENT_find_event()
+ * @param interval_ms: cycle time, minimum interval or debounce time. Not used in ON_CHANGE mode.
+ *
+ * @returns handle for SI_EVENTSCHED_write(), NULLPTR if parameters are invalid or there is no free element
+ */
+struct SI_EVENTSCHED_element* SI_EVENTSCHED_configure(struct SI_EVENT_event* event, enum SI_EVENTSCHED_Mode_t mode, uint32 interval_ms)
+{
+    uint32 i = 0u;
+    struct SI_EVENTSCHED_element* element = NULLPTR;
+
+    if ((NULLPTR == event) || (SI_EVENTSCHED_Mode_DEBOUNCE < mode) ||
+        ((SI_EVENTSCHED_Mode_ON_CHANGE != mode) && (0u == interval_ms)))
+    {
+        return NULLPTR;
+    }
+
+    if (FALSE == g_wheel_initialized)
+    {
+        SI_TIMERWHEEL_init(&g_wheel);
+        g_wheel_initialized = TRUE;
+    }
+
+    for (i = 0u; i < SI_CFG_EVENTSCHED_ELEMENT_NUM; i++)
+    {
+        if ((TRUE == g_elements[i].used) && (event == g_elements[i].event))
+        {
+            element = &(g_elements[i]);
+            break;
+        }
+
+        if ((FALSE == g_elements[i].used) && (NULLPTR == element))
+        {
+            element = &(g_elements[i]);
+        }
+    }
+
+    if (NULLPTR == element)
+    {
+        return NULLPTR;
+    }
+
+    if (FALSE == element->used)
+    {
+        element->used = TRUE;
+        element->event = event;
+        element->has_value = FALSE;
+        element->pending = FALSE;
+        element->payload_length = 0u;
+        element->has_notified = FALSE;
+        element->notified_length = 0u;
+    }
+
+    SI_TIMERWHEEL_cancel(&(element->timer));
+    element->mode = mode;
+    element->interval_ms = interval_ms;
+
+    if (SI_EVENTSCHED_Mode_CYCLIC == mode)
+    {
+        (void)SI_TIMERWHEEL_arm(&g_wheel, &(element->timer), interval_ms, SI_EVENTSCHED_timer_expired, element);
+    }
+    else if ((SI_EVENTSCHED_Mode_ON_CHANGE == mode) && (TRUE == element->pending))
+    {
+        (void)SI_TIMERWHEEL_arm(&g_wheel, &(element->timer), SI_CFG_EVENTSCHED_RETRY_MS, SI_EVENTSCHED_timer_expired, element);
+    }
+    else
+    {
+        // MIN_INTERVAL and DEBOUNCE are started by the next write
+    }
+
+    return element;
+}
+
+/**
+ * Stores the latest value of the event, it is notified according to the transmission mode.
+ *
+ * @param payload: serialised event data, can be NULLPTR if payload_length is 0
+ *
+ * @returns TRUE if value is stored
+ */
+boolean SI_EVENTSCHED_write(struct SI_EVENTSCHED_element* element, const uint8* payload, uint32 payload_length)
+{
+    if ((NULLPTR == element) || (FALSE == element->used) ||
+        (SI_CFG_EVENTSCHED_PAYLOAD_SIZE < payload_length) || ((0u < payload_length) && (NULLPTR == payload)))
+    {
+        return FALSE;
+    }
+
+    if (TRUE == element->pending)
+    {
+        g_counters.coalesced += 1u;
+    }
+
+    if ((SI_EVENTSCHED_Mode_ON_CHANGE == element->mode) &&
+        (TRUE == SI_EVENTSCHED_is_notified(element, payload, payload_length)))
+    {
+        // Value is not changed since the last notification, a pending retry is not needed either
+        SI_TIMERWHEEL_cancel(&(element->timer));
+        memcpy(element->payload, element->notified, element->notified_length);
+        element->payload_length = element->notified_length;
+        element->pending = FALSE;
+        g_counters.suppressed += 1u;
+        return TRUE;
+    }
+
+    if (0u < payload_length)
+    {
+        memcpy(element->payload, payload, payload_length);
+    }
+    element->payload_length = payload_length;
+    element->has_value = TRUE;
+    element->pending = TRUE;
+    g_counters.written += 1u;
+
+    switch (element->mode)
+    {
+        case SI_EVENTSCHED_Mode_ON_CHANGE:
+        {
+            SI_TIMERWHEEL_cancel(&(element->timer));
+            SI_EVENTSCHED_send_or_retry(element);
+            break;
+        }
+        case SI_EVENTSCHED_Mode_MIN_INTERVAL:
+        {
+            // Armed timer means: interval is not elapsed since the last notification
+            if (FALSE == SI_TIMERWHEEL_is_armed(&(element->timer)))
+            {
+                SI_EVENTSCHED_send(element);
+                (void)SI_TIMERWHEEL_arm(&g_wheel, &(element->timer), element->interval_ms, SI_EVENTSCHED_timer_expired, element);
+            }
+            break;
+        }
+        case SI_EVENTSCHED_Mode_DEBOUNCE:
+        {
+            // Every write restarts the debounce time
+            (void)SI_TIMERWHEEL_arm(&g_wheel, &(element->timer), element->interval_ms, SI_EVENTSCHED_timer_expired, element);
+            break;
+        }
+        case SI_EVENTSCHED_Mode_CYCLIC:
+            /* FALL THROUGH */
+        default:
+        {
+            break;
+        }
+    }
+    return TRUE;
+}
+
+void SI_EVENTSCHED_get_counters(struct SI_EVENTSCHED_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/**
+ * Timekeeping: notifications of cyclic, minimum interval and debounced events are sent from here.
+ * @note Call this in every cycle!
+ */
+void SI_EVENTSCHED_tick(uint32 elapsed_time_ms)
+{
+    if (TRUE == g_wheel_initialized)
+    {
+        SI_TIMERWHEEL_advance(&g_wheel, elapsed_time_ms);
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+/**
+ * Notifies the latest value. It stays pending if notification reached no subscriber (e.g. Tx pool exhausted).
+ */
+static void SI_EVENTSCHED_send(struct SI_EVENTSCHED_element* element)
+{
+    if (TRUE == SI_EVENT_notify(element->event, element->payload, element->payload_length))
+    {
+        if (0u < element->payload_length)
+        {
+            memcpy(element->notified, element->payload, element->payload_length);
+        }
+        element->notified_length = element->payload_length;
+        element->has_notified = TRUE;
+        element->pending = FALSE;
+        g_counters.notified += 1u;
+    }
+}
+
+/**
+ * Notifies the latest value. If notification failed, it is retried after SI_CFG_EVENTSCHED_RETRY_MS
+ * (a removed event is not retried).
+ */
+static void SI_EVENTSCHED_send_or_retry(struct SI_EVENTSCHED_element* element)
+{
+    SI_EVENTSCHED_send(element);
+
+    if ((TRUE == element->pending) && (TRUE == element->event->valid))
+    {
+        (void)SI_TIMERWHEEL_arm(&g_wheel, &(element->timer), SI_CFG_EVENTSCHED_RETRY_MS, SI_EVENTSCHED_timer_expired, element);
+    }
+}
+
+/**
+ * @returns TRUE if payload equals to the last notified value
+ */
+static boolean SI_EVENTSCHED_is_notified(const struct SI_EVENTSCHED_element* element, const uint8* payload, uint32 payload_length)
+{
+    return ((TRUE == element->has_notified) && (payload_length == element->notified_length) &&
+            ((0u == payload_length) || (0 == memcmp(element->notified, payload, payload_length))));
+}
+
+static void SI_EVENTSCHED_timer_expired(void* context)
+{
+    struct SI_EVENTSCHED_element* element = (struct SI_EVENTSCHED_element*)context;
+
+    switch (element->mode)
+    {
+        case SI_EVENTSCHED_Mode_CYCLIC:
+        {
+            if (TRUE == element->has_value)
+            {
+                SI_EVENTSCHED_send(element);
+            }
+            (void)SI_TIMERWHEEL_arm(&g_wheel, &(element->timer), element->interval_ms, SI_EVENTSCHED_timer_expired, element);
+            break;
+        }
+        case SI_EVENTSCHED_Mode_MIN_INTERVAL:
+        {
+            // Coalesced writes -> notify the latest one and start a new interval, otherwise interval is over
+            if (TRUE == element->pending)
+            {
+                SI_EVENTSCHED_send(element);
+                (void)SI_TIMERWHEEL_arm(&g_wheel, &(element->timer), element->interval_ms, SI_EVENTSCHED_timer_expired, element);
+            }
+            break;
+        }
+        case SI_EVENTSCHED_Mode_ON_CHANGE:
+            /* FALL THROUGH: retry of a failed notification */
+        case SI_EVENTSCHED_Mode_DEBOUNCE:
+        {
+            if (TRUE == element->pending)
+            {
+                SI_EVENTSCHED_send_or_retry(element);
+            }
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+#endif
+
+/* END OF SI_EVENTSCHED.C FILE */
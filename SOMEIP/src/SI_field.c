@@ -0,0 +1,325 @@
+/**
+ * @file    SI_field.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_field.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_field.h"
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+#include "SI_message.h"
+#include "SI_servman.h"
+#include "SI_event.h"
+#include "SI_respcache.h"
+
+#include <string.h>         // for memcmp, memcpy
+
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SI_FIELD_field g_fields[SI_CFG_MAX_FIELDS];
+static struct SI_FIELD_counters g_counters;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static struct SI_FIELD_field* SI_FIELD_find(const struct SI_MessageContext* request);
+static boolean SI_FIELD_method_exists(struct SI_Service* service, uint16 method_id);
+static boolean SI_FIELD_add_method(struct SI_Service* service, uint16 method_id, SI_MethodHandler_fptr handler_func, boolean cacheable);
+static void SI_FIELD_rmv_method(struct SI_Service* service, uint16 method_id);
+static enum SI_ReturnCode_t SI_FIELD_getter(const struct SI_MessageContext* request, struct SI_MessageBuilder* response);
+static enum SI_ReturnCode_t SI_FIELD_setter(const struct SI_MessageContext* request, struct SI_MessageBuilder* response);
+static void SI_FIELD_subscribed(const struct SI_EVENT_eventgroup* eventgroup, const struct SI_EVENT_subscriber* subscriber);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Creates a field of a local service. Getter and setter are registered as methods of the service,
+ * the getter is cacheable (see SI_MethodEntry).
+ *
+ * @param service: registered local service
+ * @param getter_id: Method ID of the getter, SI_FIELD_NO_METHOD if there is none
+ * @param setter_id: Method ID of the setter, SI_FIELD_NO_METHOD if there is none
+ * @param notifier: event of the notifier, NULLPTR if there is none
+ * @param set_hook (optional): validates values received by the setter. If not needed give NULLPTR.
+ *
+ * @returns handle of the field, NULLPTR if parameters are invalid, a getter / setter Method ID is already registered
+ *          or there is no free field (nothing is registered then)
+ */
+struct SI_FIELD_field* SI_FIELD_add(struct SI_Service* service, uint16 getter_id, uint16 setter_id,
+                                    struct SI_EVENT_event* notifier, SI_FIELD_SetHook_fptr set_hook)
+{
+    uint32 i = 0u;
+    struct SI_FIELD_field* field = NULLPTR;
+    const boolean has_getter = (SI_FIELD_NO_METHOD != getter_id);
+    const boolean has_setter = (SI_FIELD_NO_METHOD != setter_id);
+
+    if ((NULLPTR == service) ||
+        (has_getter && (FALSE == SI_HEADER_is_method(getter_id))) ||
+        (has_setter && (FALSE == SI_HEADER_is_method(setter_id))) ||
+        (has_getter && has_setter && (getter_id == setter_id)) ||
+        (has_getter && (TRUE == SI_FIELD_method_exists(service, getter_id))) ||
+        (has_setter && (TRUE == SI_FIELD_method_exists(service, setter_id))))
+    {
+        return NULLPTR;
+    }
+
+    for (i = 0u; i < SI_CFG_MAX_FIELDS; i++)
+    {
+        if (FALSE == g_fields[i].used)
+        {
+            field = &(g_fields[i]);
+            break;
+        }
+    }
+
+    if (NULLPTR == field)
+    {
+        return NULLPTR;
+    }
+
+    if ((FALSE == SI_EVENT_add_subscribe_hook(SI_FIELD_subscribed)) ||
+        (has_getter && (FALSE == SI_FIELD_add_method(service, getter_id, SI_FIELD_getter, TRUE))))
+    {
+        return NULLPTR;
+    }
+
+    if (has_setter && (FALSE == SI_FIELD_add_method(service, setter_id, SI_FIELD_setter, FALSE)))
+    {
+        if (has_getter)
+        {
+            SI_FIELD_rmv_method(service, getter_id);
+        }
+        return NULLPTR;
+    }
+
+    field->used = TRUE;
+    field->service_id = service->service_id;
+    field->port_be = service->instance.port_be;
+    field->interface_version = service->interface_version;
+    field->getter_id = getter_id;
+    field->setter_id = setter_id;
+    field->notifier = notifier;
+    field->set_hook = set_hook;
+    field->has_value = FALSE;
+    field->length = 0u;
+    return field;
+}
+
+/**
+ * Stores the value of the field and notifies it. Writing the stored value again is not notified.
+ *
+ * @param value: serialised value, can be NULLPTR if length is 0
+ *
+ * @returns TRUE if value is stored (or it is equal to the stored value)
+ */
+boolean SI_FIELD_write(struct SI_FIELD_field* field, const uint8* value, uint32 length)
+{
+    if ((NULLPTR == field) || (FALSE == field->used) ||
+        (SI_CFG_FIELD_VALUE_SIZE < length) || ((0u < length) && (NULLPTR == value)))
+    {
+        return FALSE;
+    }
+
+    if ((TRUE == field->has_value) && (length == field->length) && (0 == memcmp(field->value, value, length)))
+    {
+        g_counters.suppressed += 1u;
+        return TRUE;
+    }
+
+    if (0u < length)
+    {
+        memcpy(field->value, value, length);
+    }
+    field->length = length;
+    field->has_value = TRUE;
+    g_counters.written += 1u;
+
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+    if (SI_FIELD_NO_METHOD != field->getter_id)
+    {
+        SI_RESPCACHE_memo_invalidate(field->service_id, field->getter_id);
+    }
+#endif
+
+    if (NULLPTR != field->notifier)
+    {
+        (void)SI_EVENT_notify(field->notifier, field->value, field->length);
+    }
+    return TRUE;
+}
+
+void SI_FIELD_get_counters(struct SI_FIELD_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+/**
+ * @returns field of the service instance the request was received by, with the requested getter or setter,
+ *          NULLPTR if there is none
+ */
+static struct SI_FIELD_field* SI_FIELD_find(const struct SI_MessageContext* request)
+{
+    uint32 i = 0u;
+    const uint16 method_id = request->header.message_id.methodID_or_eventID;
+
+    for (i = 0u; i < SI_CFG_MAX_FIELDS; i++)
+    {
+        if ((TRUE == g_fields[i].used) && (request->header.message_id.serviceID == g_fields[i].service_id) &&
+            (request->local_port == g_fields[i].port_be) && (request->header.interface_version == g_fields[i].interface_version) &&
+            ((method_id == g_fields[i].getter_id) || (method_id == g_fields[i].setter_id)))
+        {
+            return &(g_fields[i]);
+        }
+    }
+    return NULLPTR;
+}
+
+/**
+ * @returns TRUE if a method with the given Method ID is registered in the service
+ */
+static boolean SI_FIELD_method_exists(struct SI_Service* service, uint16 method_id)
+{
+    uint32 i = 0u;
+    const struct SI_Service* registered = SI_SERVMAN_find_service(service->service_id, service->instance.port_be, service->interface_version);
+
+    for (i = 0u; (NULLPTR != registered) && (i < SI_CFG_MAX_METHODS); i++)
+    {
+        if ((FALSE != registered->method[i].valid) && (method_id == registered->method[i].method_id))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static boolean SI_FIELD_add_method(struct SI_Service* service, uint16 method_id, SI_MethodHandler_fptr handler_func, boolean cacheable)
+{
+    struct SI_MethodEntry method;
+
+    method.valid = TRUE;
+    method.method_id = method_id;
+    method.handler_func = handler_func;
+    method.cacheable = cacheable;
+    method.cache_ttl_ms = 0u;       // valid until the field is written
+
+    return SI_SERVMAN_add_method(service, &method);
+}
+
+static void SI_FIELD_rmv_method(struct SI_Service* service, uint16 method_id)
+{
+    struct SI_MethodEntry method;
+
+    method.method_id = method_id;
+    (void)SI_SERVMAN_rmv_method(service, &method);
+}
+
+/**
+ * Method handler of getters: responds with the stored value
+ */
+static enum SI_ReturnCode_t SI_FIELD_getter(const struct SI_MessageContext* request, struct SI_MessageBuilder* response)
+{
+    const struct SI_FIELD_field* field = SI_FIELD_find(request);
+
+    if (NULLPTR == field)
+    {
+        return SI_ReturnCode_NOT_OK;
+    }
+
+    if (FALSE == field->has_value)
+    {
+        return SI_ReturnCode_NOT_READY;
+    }
+
+    if ((NULLPTR != response) && (FALSE == SI_MESSAGE_put(response, field->value, field->length)))
+    {
+        return SI_ReturnCode_NOT_OK;
+    }
+    return SI_ReturnCode_OK;
+}
+
+/**
+ * Method handler of setters: stores the received value, responds with the stored value
+ */
+static enum SI_ReturnCode_t SI_FIELD_setter(const struct SI_MessageContext* request, struct SI_MessageBuilder* response)
+{
+    struct SI_FIELD_field* field = SI_FIELD_find(request);
+
+    if (NULLPTR == field)
+    {
+        return SI_ReturnCode_NOT_OK;
+    }
+
+    if (SI_CFG_FIELD_VALUE_SIZE < request->payload.length)
+    {
+        return SI_ReturnCode_MALFORMED_MESSAGE;
+    }
+
+    if ((NULLPTR != field->set_hook) && (FALSE == field->set_hook(request->payload.data, request->payload.length)))
+    {
+        return SI_ReturnCode_NOT_OK;
+    }
+
+    (void)SI_FIELD_write(field, request->payload.data, request->payload.length);
+
+    if ((NULLPTR != response) && (FALSE == SI_MESSAGE_put(response, field->value, field->length)))
+    {
+        return SI_ReturnCode_NOT_OK;
+    }
+    return SI_ReturnCode_OK;
+}
+
+/**
+ * Subscribe hook: sends the current value of every field notified in the eventgroup to the new subscriber.
+ * Invoked after the subscription is acknowledged, see SI_EVENT_announce_subscriber().
+ */
+static void SI_FIELD_subscribed(const struct SI_EVENT_eventgroup* eventgroup, const struct SI_EVENT_subscriber* subscriber)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_CFG_MAX_FIELDS; i++)
+    {
+        if ((TRUE == g_fields[i].used) && (TRUE == g_fields[i].has_value) &&
+            (TRUE == SI_EVENT_is_member(g_fields[i].notifier, eventgroup)) &&
+            (TRUE == SI_EVENT_notify_subscriber(g_fields[i].notifier, eventgroup, subscriber, g_fields[i].value, g_fields[i].length)))
+        {
+            g_counters.initial_sent += 1u;
+        }
+    }
+}
+
+#endif
+
+/* END OF SI_FIELD.C FILE */
@@ -35,6 +35,7 @@ static_assert(SI_CFG_MSG_TXPOOL_BLOCK_SIZE <= SI_CONST_UDP_MTU_LENGTH, "FATAL ER
 /* **************************************************** */
 
 static struct SI_MESSAGE_tx_pool g_tx_message_pool;
+static SI_MESSAGE_ReleaseHook_fptr g_release_hook = NULLPTR;
 
 /* **************************************************** */
 /*                True global variables                 */
@@ -152,6 +153,10 @@ boolean SI_MESSAGE_finalize(struct SI_MessageBuilder* message, struct SI_Header*
     return FALSE;
 }
 
+/**
+ * Releases the Tx buffer of the message. Call this when transmission of the message is completed.
+ * Invokes the release hook (if there is one), so deferred messages can use the released buffer.
+ */
 boolean SI_MESSAGE_invalidate(struct SI_MessageBuilder* message)
 {
     uint16 i = 0u;
@@ -170,12 +175,43 @@ boolean SI_MESSAGE_invalidate(struct SI_MessageBuilder* message)
             message->cursor = 0u;
             message->cap = 0u;
             message->length = 0u;
+
+            if (NULLPTR != g_release_hook)
+            {
+                g_release_hook();
+            }
             return TRUE;
         }
     }
     return FALSE;
 }
 
+/**
+ * @returns Number of Tx buffers available for allocation
+ */
+uint32 SI_MESSAGE_get_free_count(void)
+{
+    uint32 i = 0u;
+    uint32 free_count = 0u;
+
+    for (i = 0u; i < SI_CFG_MSG_TXPOOL_ELEMENT_NUM; i++)
+    {
+        if (FALSE == g_tx_message_pool.pool[i].used)
+        {
+            free_count += 1u;
+        }
+    }
+    return free_count;
+}
+
+/**
+ * @param hook: function called every time a Tx buffer is released, NULLPTR removes the hook
+ */
+void SI_MESSAGE_set_release_hook(SI_MESSAGE_ReleaseHook_fptr hook)
+{
+    g_release_hook = hook;
+}
+
 /* **************************************************** */
 /*             Local function definitions               */
 /* **************************************************** */
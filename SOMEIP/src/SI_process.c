@@ -21,6 +21,11 @@
 #include "SI_header.h"
 #include "SI_servman.h"
 #include "SI_message.h"
+#include "SI_respcache.h"
+#include "SI_ratelimit.h"
+#include "SI_txqueue.h"
+#include "SI_client.h"
+#include "SI_eventsched.h"
 #include "ERH.h"
 
 /* **************************************************** */
@@ -31,6 +36,10 @@
 /*               Static global variables                */
 /* **************************************************** */
 
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+static volatile boolean g_tx_released = FALSE;  // a Tx buffer was released since the last drain of deferred requests
+#endif
+
 /* **************************************************** */
 /*                True global variables                 */
 /* **************************************************** */
@@ -60,57 +69,231 @@ enum SI_PROC_ErrType_t
 /*             Local function declarations              */
 /* **************************************************** */
 
+static boolean SI_PROCESS_handle_request(struct udp_pcb *rx_udp_pcb, const struct SI_MessageContext* in_request, const ip_addr_t *src_addr, u16_t src_port, boolean admitted);
+static boolean SI_PROCESS_handle_one_way(const struct udp_pcb *rx_udp_pcb, const struct SI_MessageContext* message, const ip_addr_t *src_addr);
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+static boolean SI_PROCESS_admit(struct udp_pcb *rx_udp_pcb, const struct SI_MessageContext* request, const ip_addr_t *src_addr, u16_t src_port);
+#endif
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+static void SI_PROCESS_tx_released(void);
+static void SI_PROCESS_drain_deferred(void);
+#endif
 static boolean SI_PROCESS_construct_header(const struct SI_MessageContext* req, struct SI_Header* resp_header, enum SI_MessageType_t type, enum SI_ReturnCode_t code);
+#if ((TRUE == SI_CFG_ENABLE_RATE_LIMIT) && (TRUE == SI_CFG_RATELIMIT_REJECT_WITH_NOT_READY))
+static boolean SI_PROCESS_send_error(struct udp_pcb *rx_udp_pcb, const struct SI_MessageContext* req, const ip_addr_t *src_addr, u16_t src_port, enum SI_ReturnCode_t code);
+#endif
 static void SI_PROCESS_report_error(enum SI_PROC_ErrType_t type, const void* field0, const void* field1, const void* field2, const void* field3, const void* field4);
 
 /* **************************************************** */
 /*             Global function definitions              */
 /* **************************************************** */
 
+/**
+ * Initializes SOME/IP modul. Should be called after system initialization, before the first received message.
+ */
+void SI_PROCESS_init(void)
+{
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+    SI_MESSAGE_set_release_hook(SI_PROCESS_tx_released);
+#endif
+}
+
 boolean SI_PROCESS_unicast(struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf, const ip_addr_t *src_addr, u16_t src_port)
 {
     struct SI_MessageContext request;
+    boolean retval = FALSE;
+
+    // ---- 0) Input validation
+    if ((NULLPTR == rx_udp_pcb) || (NULLPTR == rx_pbuf) || (NULLPTR == src_addr))
+    {
+        return FALSE;
+    }
+
+    // ---- 1) Parse
+    // Note: uint8 must be a typedef for unsigned char. Otherwise effective type / strict aliasing / alignment problems might arise.
+    if (FALSE == SI_PARSER_parse_datagram((const uint8*)rx_pbuf->payload, (uint32)rx_pbuf->len, &request.header, &request.payload))
+    {
+        return FALSE;
+    }
+    request.local_port = rx_udp_pcb->local_port;
+
+    // ---- 1/a) One-way messages -> fire-and-forget path, Tx pool is not touched
+    if ((SI_MessageType_REQUEST_NO_RETURN == request.header.message_type) ||
+        (SI_MessageType_NOTIFICATION == request.header.message_type))
+    {
+        return SI_PROCESS_handle_one_way(rx_udp_pcb, &request, src_addr);
+    }
+
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+    // ---- 1/b) Responses -> complete the outstanding request of the client side
+    if ((SI_MessageType_RESPONSE == request.header.message_type) ||
+        (SI_MessageType_ERROR == request.header.message_type))
+    {
+        return SI_CLIENT_handle_response(&request, (uint32)src_addr->addr);
+    }
+#endif
+
+    // ---- 2) Respond
+    retval = SI_PROCESS_handle_request(rx_udp_pcb, &request, src_addr, src_port, FALSE);
+
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+    // ---- 3) Tx buffers released meanwhile -> answer deferred requests
+    SI_PROCESS_drain_deferred();
+#endif
+
+    return retval;
+}
+
+/**
+ * Timekeeping for SOME/IP modul. Answers deferred requests if a Tx buffer was released meanwhile.
+ * @note Call this in every cycle, from the same task as SI_SD_PROVIDER_tick_ms() and SI_PROCESS_unicast()!
+ */
+void SI_PROCESS_tick(uint32 elapsed_time_ms)
+{
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+    SI_RESPCACHE_tick(elapsed_time_ms);
+#endif
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+    SI_RATELIMIT_tick(elapsed_time_ms);
+#endif
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+    SI_CLIENT_tick(elapsed_time_ms);
+#endif
+#if (TRUE == SI_CFG_ENABLE_EVENTS)
+    SI_EVENTSCHED_tick(elapsed_time_ms);
+#endif
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+    SI_TXQUEUE_tick(elapsed_time_ms);
+    SI_PROCESS_drain_deferred();
+#endif
+    (void)elapsed_time_ms;
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+/**
+ * Dispatches a parsed request, invokes the service handler and sends the response.
+ * Returns TRUE if function execution was done on happy-path only.
+ * @param rx_udp_pcb: pcb the request was received on, response is sent through it
+ * @param in_request: parsed request message
+ * @param src_addr: address of the requester
+ * @param src_port: port of the requester
+ * @param admitted: TRUE if request already passed admission control (deferred request)
+*/
+static boolean SI_PROCESS_handle_request(struct udp_pcb *rx_udp_pcb, const struct SI_MessageContext* in_request, const ip_addr_t *src_addr, u16_t src_port, boolean admitted)
+{
+    const struct SI_MessageContext request = *in_request;
     struct SI_Header response_header;
     struct SI_MessageBuilder response;
     struct SI_DISPATCHER_status dispatcher_status;
     boolean response_possible = FALSE;
     boolean error_condition = FALSE;
     boolean interface_mismatch = FALSE;
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+    boolean memoizable = FALSE;
+#endif
     struct SI_Service* requested_service = NULLPTR; 
     struct SI_MethodEntry* requested_method = NULLPTR;
     
     enum SI_ReturnCode_t handler_return_code = SI_ReturnCode_OK;
 
-    // ---- 0) Input validation
-    if ((NULLPTR == rx_udp_pcb) || (NULLPTR == rx_pbuf) || (NULLPTR == src_addr))
+    // ---- 2) Determine response actions based on request header
+    if(FALSE == SI_DISPATCHER_dispatch(&request, &dispatcher_status))
     {
         return FALSE;
     }
 
-    // ---- 1) Parse
-    // Note: uint8 must be a typedef for unsigned char. Otherwise effective type / strict aliasing / alignment problems might arise.
-    if (FALSE == SI_PARSER_parse_datagram((const uint8*)rx_pbuf->payload, (uint32)rx_pbuf->len, &request.header, &request.payload))
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+    // ---- 2/a) Retransmitted request -> replay the stored response, handler is not invoked again
+    if ((SI_MessageType_REQUEST == request.header.message_type) &&
+        (TRUE == SI_RESPCACHE_lookup(&request.header, (uint32)src_addr->addr, &response)))
     {
-        return FALSE;
+        if (ERR_OK != SomeIP_udp_transmit(rx_udp_pcb, (uint32)src_addr->addr, (uint16)src_port, &response))
+        {
+            SI_PROCESS_report_error(SI_PROC_ErrType_udp_tx_fail, src_addr, &src_port, 0u, 0u, 0u);
+            return FALSE;
+        }
+        return TRUE;
     }
+#endif
 
-    // ---- 2) Determine response actions based on request header
-    if(FALSE == SI_DISPATCHER_dispatch(&request, &dispatcher_status))
+    // ---- 3) Get requested service and method
+    if ((FALSE == dispatcher_status.error) && (TRUE == dispatcher_status.call_handler))
+    {
+        requested_service = SI_SERVMAN_find_service(request.header.message_id.serviceID, rx_udp_pcb->local_port, request.header.interface_version);
+        if (NULLPTR == requested_service)
+        {
+            error_condition = TRUE;
+            (void)SI_PROCESS_construct_header(&request, &response_header, SI_MessageType_ERROR, SI_ReturnCode_UNKNOWN_SERVICE);
+
+            SI_PROCESS_report_error(SI_PROC_ErrType_local_service_not_found, &request, 0u, 0u, 0u, 0u);
+        }
+
+        interface_mismatch = ((NULLPTR != requested_service) && (request.header.interface_version != requested_service->interface_version));
+        if (interface_mismatch && (FALSE == error_condition))
+        {
+            error_condition = TRUE;
+            (void)SI_PROCESS_construct_header(&request, &response_header, SI_MessageType_ERROR, SI_ReturnCode_WRONG_INTERFACE_VERSION);
+
+            SI_PROCESS_report_error(SI_PROC_ErrType_local_service_not_compatible, &request, 0u, 0u, 0u, 0u);
+        }
+
+        requested_method = SI_SERVMAN_find_method(requested_service, request.header.message_id.methodID_or_eventID);
+        if ((NULLPTR == requested_method) && (FALSE == error_condition))
+        {
+            error_condition = TRUE;
+            (void)SI_PROCESS_construct_header(&request, &response_header, SI_MessageType_ERROR, SI_ReturnCode_UNKNOWN_METHOD);
+
+            SI_PROCESS_report_error(SI_PROC_ErrType_local_service_not_found, &request, 0u, 0u, 0u, 0u);   
+        }
+    }
+
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+    // ---- 3/a) Getter of a cacheable method -> serve memoized response, only Request ID is patched
+    memoizable = ((FALSE == error_condition) && (NULLPTR != requested_method) && (TRUE == requested_method->cacheable) &&
+                  (SI_MessageType_REQUEST == request.header.message_type) && (0u == request.payload.length));
+
+    if ((TRUE == memoizable) &&
+        (TRUE == SI_RESPCACHE_memo_lookup(&request.header, rx_udp_pcb->local_port, &response)))
+    {
+        if (ERR_OK != SomeIP_udp_transmit(rx_udp_pcb, (uint32)src_addr->addr, (uint16)src_port, &response))
+        {
+            SI_PROCESS_report_error(SI_PROC_ErrType_udp_tx_fail, src_addr, &src_port, 0u, 0u, 0u);
+            return FALSE;
+        }
+        return TRUE;
+    }
+#endif
+
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+    // ---- 3/b) Admission control, requester exceeded its rate -> reject
+    if ((FALSE == admitted) && (FALSE == SI_PROCESS_admit(rx_udp_pcb, &request, src_addr, src_port)))
     {
         return FALSE;
     }
+#endif
+    (void)admitted;
 
-    // ---- 3) Allocate Tx buffer
+    // ---- 4) Allocate Tx buffer
     if (TRUE == dispatcher_status.send_response)
     {
         response_possible = SI_MESSAGE_init(&response);
     }
 
-    // ---- 4) Faliure -> send error message
-    if ((TRUE == dispatcher_status.error) && (TRUE == response_possible))
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+    // ---- 4/a) Tx pool exhausted -> defer the request until a Tx buffer is released
+    if ((TRUE == dispatcher_status.send_response) && (FALSE == response_possible) &&
+        (TRUE == SI_TXQUEUE_push(rx_udp_pcb, &request, src_addr, src_port)))
     {
-        error_condition = TRUE;
+        return TRUE;
+    }
+#endif
 
+    // ---- 5) Faliure -> send error message
+    if ((TRUE == dispatcher_status.error) && (TRUE == response_possible))
+    {
         if (FALSE == SI_PROCESS_construct_header(&request, &response_header,
                                                  dispatcher_status.error_message_type,
                                                  dispatcher_status.error_return_code))
@@ -153,42 +336,20 @@ boolean SI_PROCESS_unicast(struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf, con
             return FALSE;
         }
 
-        // ---- 5) Get requested service
-        requested_service = SI_SERVMAN_find_service(request.header.message_id.serviceID, rx_udp_pcb->local_port, request.header.interface_version);
-        if (NULLPTR == requested_service)
-        {
-            error_condition = TRUE;
-            (void)SI_PROCESS_construct_header(&request, &response_header, SI_MessageType_ERROR, SI_ReturnCode_UNKNOWN_SERVICE);
-
-            SI_PROCESS_report_error(SI_PROC_ErrType_local_service_not_found, &request, 0u, 0u, 0u, 0u);
-        }
-
-        interface_mismatch = (request.header.interface_version != requested_service->interface_version);
-        if (interface_mismatch && (FALSE == error_condition))
+        if ((TRUE == dispatcher_status.send_response) && (FALSE == response_possible))
         {
-            error_condition = TRUE;
-            (void)SI_PROCESS_construct_header(&request, &response_header, SI_MessageType_ERROR, SI_ReturnCode_WRONG_INTERFACE_VERSION);
-
-            SI_PROCESS_report_error(SI_PROC_ErrType_local_service_not_compatible, &request, 0u, 0u, 0u, 0u);
-        }
-
-        // ---- 6) Get requested method
-        requested_method = SI_SERVMAN_find_method(requested_service, request.header.message_id.methodID_or_eventID);
-        if ((NULLPTR == requested_method) && (FALSE == error_condition))
-        {
-            error_condition = TRUE;
-            (void)SI_PROCESS_construct_header(&request, &response_header, SI_MessageType_ERROR, SI_ReturnCode_UNKNOWN_METHOD);
-
-            SI_PROCESS_report_error(SI_PROC_ErrType_local_service_not_found, &request, 0u, 0u, 0u, 0u);   
+            // Response can not be built, handler is not invoked: client retransmits the request
+            SI_PROCESS_report_error(SI_PROC_ErrType_buffering_malfuntion, &request, 0u, 0u, 0u, 0u);
+            return FALSE;
         }
 
-        // ---- 7) Call service handler
+        // ---- 6) Call service handler
         if (FALSE == error_condition)
         {
             handler_return_code = requested_method->handler_func(&request, &response);
         }
 
-        // ---- 8) Success -> send response message
+        // ---- 7) Success -> send response message
         if ((TRUE == dispatcher_status.send_response) && (TRUE == response_possible))
         {
             if (FALSE == error_condition)
@@ -206,6 +367,15 @@ boolean SI_PROCESS_unicast(struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf, con
                 return FALSE;
             }
 
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+            (void)SI_RESPCACHE_store(&request.header, (uint32)src_addr->addr, &response);
+
+            if ((TRUE == memoizable) && (SI_ReturnCode_OK == handler_return_code))
+            {
+                (void)SI_RESPCACHE_memo_store(&request.header, rx_udp_pcb->local_port, requested_method->cache_ttl_ms, &response);
+            }
+#endif
+
             if (ERR_OK != SomeIP_udp_transmit(rx_udp_pcb, (uint32)src_addr->addr, (uint16)src_port, &response))
             {
                 SI_PROCESS_report_error(SI_PROC_ErrType_udp_tx_fail, src_addr, &src_port, 0u, 0u, 0u);
@@ -223,9 +393,146 @@ boolean SI_PROCESS_unicast(struct udp_pcb *rx_udp_pcb, struct pbuf *rx_pbuf, con
     }
 }
 
-/* **************************************************** */
-/*             Local function definitions               */
-/* **************************************************** */
+/**
+ * Delivers a REQUEST_NO_RETURN or NOTIFICATION message. No response is sent, even in case of error,
+ * so neither the dispatcher nor a Tx buffer is needed.
+ * Notifications are looked up in the event handler index, requests in the local service registry.
+ * Returns TRUE if the message is delivered to a handler.
+ * @param rx_udp_pcb: pcb the message was received on
+ * @param message: parsed message
+ * @param src_addr: address of the sender
+*/
+static boolean SI_PROCESS_handle_one_way(const struct udp_pcb *rx_udp_pcb, const struct SI_MessageContext* message, const ip_addr_t *src_addr)
+{
+    const uint16 id = message->header.message_id.methodID_or_eventID;
+    struct SI_EventHandlerEntry* event_handler = NULLPTR;
+    struct SI_Service* requested_service = NULLPTR;
+    struct SI_MethodEntry* requested_method = NULLPTR;
+
+    if (FALSE == SI_HEADER_validate(&(message->header)))
+    {
+        return FALSE;
+    }
+
+    if (SI_MessageType_NOTIFICATION == message->header.message_type)
+    {
+        if (FALSE == SI_HEADER_is_event(id))
+        {
+            return FALSE;
+        }
+
+        event_handler = SI_SERVMAN_find_event_handler(message->header.message_id.serviceID, id);
+        if (NULLPTR == event_handler)
+        {
+            // Nobody is interested in this event
+            return FALSE;
+        }
+
+        event_handler->handler_func(message);
+        return TRUE;
+    }
+
+    if (FALSE == SI_HEADER_is_method(id))
+    {
+        return FALSE;
+    }
+
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+    // Requester exceeded its rate -> drop, nothing to answer
+    if (FALSE == SI_RATELIMIT_admit(&(message->header), (uint32)src_addr->addr))
+    {
+        return FALSE;
+    }
+#endif
+    (void)src_addr;
+
+    requested_service = SI_SERVMAN_find_service(message->header.message_id.serviceID, rx_udp_pcb->local_port, message->header.interface_version);
+    if (NULLPTR == requested_service)
+    {
+        SI_PROCESS_report_error(SI_PROC_ErrType_local_service_not_found, message, 0u, 0u, 0u, 0u);
+        return FALSE;
+    }
+
+    if (message->header.interface_version != requested_service->interface_version)
+    {
+        SI_PROCESS_report_error(SI_PROC_ErrType_local_service_not_compatible, message, 0u, 0u, 0u, 0u);
+        return FALSE;
+    }
+
+    requested_method = SI_SERVMAN_find_method(requested_service, id);
+    if (NULLPTR == requested_method)
+    {
+        SI_PROCESS_report_error(SI_PROC_ErrType_local_method_not_found, message, 0u, 0u, 0u, 0u);
+        return FALSE;
+    }
+
+    (void)requested_method->handler_func(message, NULLPTR);
+    return TRUE;
+}
+
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+/**
+ * Admission control of a REQUEST. Rejected request is answered with NOT_READY (if configured)
+ * only while the Tx pool is not running low, otherwise it is dropped silently.
+ * Returns TRUE if request can be processed.
+*/
+static boolean SI_PROCESS_admit(struct udp_pcb *rx_udp_pcb, const struct SI_MessageContext* request, const ip_addr_t *src_addr, u16_t src_port)
+{
+    if (TRUE == SI_RATELIMIT_admit(&(request->header), (uint32)src_addr->addr))
+    {
+        return TRUE;
+    }
+
+#if (TRUE == SI_CFG_RATELIMIT_REJECT_WITH_NOT_READY)
+    if ((SI_MessageType_REQUEST == request->header.message_type) &&
+        (SI_CFG_RATELIMIT_NOT_READY_MIN_FREE_TX <= SI_MESSAGE_get_free_count()))
+    {
+        (void)SI_PROCESS_send_error(rx_udp_pcb, request, src_addr, src_port, SI_ReturnCode_NOT_READY);
+    }
+#endif
+    (void)rx_udp_pcb;
+    (void)src_port;
+    return FALSE;
+}
+#endif
+
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+/**
+ * Tx buffer release hook. Runs in the context releasing the buffer (any task), so it only records the release,
+ * deferred requests are answered by SI_PROCESS_drain_deferred().
+ */
+static void SI_PROCESS_tx_released(void)
+{
+    g_tx_released = TRUE;
+}
+
+/**
+ * Answers deferred requests while there are free Tx buffers, if a Tx buffer was released since the last drain.
+ * Invoked only at the end of every received message and at every tick, never from the release hook:
+ * handlers of deferred requests run in the SOME/IP task (see SI_txqueue.h).
+ */
+static void SI_PROCESS_drain_deferred(void)
+{
+    struct SI_TXQUEUE_element deferred;
+    struct SI_MessageContext request;
+
+    if (FALSE == g_tx_released)
+    {
+        return;
+    }
+    g_tx_released = FALSE;
+
+    while ((0u < SI_MESSAGE_get_free_count()) && (TRUE == SI_TXQUEUE_pop(&deferred)))
+    {
+        request.header = deferred.header;
+        request.payload.data = deferred.payload;
+        request.payload.length = deferred.payload_length;
+        request.local_port = deferred.pcb->local_port;
+
+        (void)SI_PROCESS_handle_request(deferred.pcb, &request, &(deferred.src_addr), deferred.src_port, TRUE);
+    }
+}
+#endif
 
 /**
  * Sets response message header based on request message header.
@@ -253,6 +560,35 @@ static boolean SI_PROCESS_construct_header(const struct SI_MessageContext* req,
     return FALSE;
 }
 
+#if ((TRUE == SI_CFG_ENABLE_RATE_LIMIT) && (TRUE == SI_CFG_RATELIMIT_REJECT_WITH_NOT_READY))
+/**
+ * Sends an ERROR message with the given Return Code as a response for req, using its own Tx buffer.
+ * Returns TRUE if message is transmitted.
+ * @param req: request message, this function assembles and sends the error message for that message
+ * @param code: Return Code field of the error message
+*/
+static boolean SI_PROCESS_send_error(struct udp_pcb *rx_udp_pcb, const struct SI_MessageContext* req, const ip_addr_t *src_addr, u16_t src_port, enum SI_ReturnCode_t code)
+{
+    struct SI_MessageBuilder response;
+    struct SI_Header response_header;
+    boolean retval = FALSE;
+
+    if (FALSE == SI_MESSAGE_init(&response))
+    {
+        return FALSE;
+    }
+
+    if ((TRUE == SI_PROCESS_construct_header(req, &response_header, SI_MessageType_ERROR, code)) &&
+        (TRUE == SI_MESSAGE_finalize(&response, &response_header, NULLPTR)))
+    {
+        retval = (ERR_OK == SomeIP_udp_transmit(rx_udp_pcb, (uint32)src_addr->addr, (uint16)src_port, &response));
+    }
+
+    (void)SI_MESSAGE_invalidate(&response);
+    return retval;
+}
+#endif
+
 static void SI_PROCESS_report_error(enum SI_PROC_ErrType_t type, const void* field0, const void* field1, const void* field2, const void* field3, const void* field4)
 {
     switch (type)
@@ -0,0 +1,202 @@
+/**
+ * @file    SI_ratelimit.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_ratelimit.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_ratelimit.h"
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+
+#include <assert.h>
+
+#if (TRUE == SI_CFG_ENABLE_RATE_LIMIT)
+
+static_assert(0u < SI_CFG_RATELIMIT_RATE_PER_SEC, "FATAL ERROR: Rate limit must admit at least one request per second!");
+static_assert(0u < SI_CFG_RATELIMIT_BURST, "FATAL ERROR: Rate limit burst must admit at least one request!");
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/**
+ * Bucket capacity (scaled)
+ */
+#define SI_RATELIMIT_TOKENS_MAX         (SI_CFG_RATELIMIT_BURST * SI_RATELIMIT_TOKEN_SCALE)
+
+/**
+ * Tokens of a new (or replaced) requester: half of the burst, so a requester can not gain a full bucket
+ * by getting evicted and seen again
+ */
+#define SI_RATELIMIT_TOKENS_INITIAL     (((SI_CFG_RATELIMIT_BURST + 1u) / 2u) * SI_RATELIMIT_TOKEN_SCALE)
+
+/**
+ * Time [ms] needed to refill an empty bucket, longer idle time can not add more tokens.
+ * Tokens per second equals to scaled tokens per millisecond.
+ */
+#define SI_RATELIMIT_FULL_REFILL_MS     (SI_RATELIMIT_TOKENS_MAX / SI_CFG_RATELIMIT_RATE_PER_SEC)
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SI_RATELIMIT_bucket g_buckets[SI_CFG_RATELIMIT_CLIENT_NUM];
+static struct SI_RATELIMIT_counters g_counters;
+static uint32 g_time_ms = 0u;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static struct SI_RATELIMIT_bucket* SI_RATELIMIT_get_bucket(uint32 src_ipv4);
+static void SI_RATELIMIT_refill(struct SI_RATELIMIT_bucket* bucket);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Admission check, call after the response cache lookups (served retransmissions do not consume tokens).
+ * Only REQUEST and REQUEST_NO_RETURN messages are limited, every other message type is admitted.
+ *
+ * @param request: header of the received message
+ * @param src_ipv4: address of the requester (network order)
+ *
+ * @returns TRUE if request can be processed, FALSE if it has to be rejected
+ */
+boolean SI_RATELIMIT_admit(const struct SI_Header* request, uint32 src_ipv4)
+{
+    struct SI_RATELIMIT_bucket* bucket = NULLPTR;
+
+    if (NULLPTR == request)
+    {
+        return FALSE;
+    }
+
+    if ((SI_MessageType_REQUEST != request->message_type) &&
+        (SI_MessageType_REQUEST_NO_RETURN != request->message_type))
+    {
+        return TRUE;
+    }
+
+    bucket = SI_RATELIMIT_get_bucket(src_ipv4);
+    SI_RATELIMIT_refill(bucket);
+
+    if (SI_RATELIMIT_TOKEN_SCALE > bucket->tokens)
+    {
+        bucket->rejected += 1u;
+        g_counters.rejected += 1u;
+        return FALSE;
+    }
+
+    bucket->tokens -= SI_RATELIMIT_TOKEN_SCALE;
+    g_counters.admitted += 1u;
+    return TRUE;
+}
+
+void SI_RATELIMIT_get_counters(struct SI_RATELIMIT_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/**
+ * Timekeeping: buckets are refilled lazily, based on this time base.
+ * @note Call this in every cycle!
+ */
+void SI_RATELIMIT_tick(uint32 elapsed_time_ms)
+{
+    g_time_ms += elapsed_time_ms;
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+/**
+ * @returns Bucket of the requester. Unknown requester gets a half full bucket,
+ *          replacing the least recently seen requester if table is full.
+ */
+static struct SI_RATELIMIT_bucket* SI_RATELIMIT_get_bucket(uint32 src_ipv4)
+{
+    uint32 i = 0u;
+    uint32 free_index = SI_CFG_RATELIMIT_CLIENT_NUM;
+    uint32 oldest = 0u;
+
+    for (i = 0u; i < SI_CFG_RATELIMIT_CLIENT_NUM; i++)
+    {
+        if (FALSE == g_buckets[i].used)
+        {
+            if (SI_CFG_RATELIMIT_CLIENT_NUM == free_index)
+            {
+                free_index = i;
+            }
+            continue;
+        }
+
+        if (src_ipv4 == g_buckets[i].src_ipv4)
+        {
+            return &(g_buckets[i]);
+        }
+
+        if ((g_time_ms - g_buckets[i].last_refill_ms) > (g_time_ms - g_buckets[oldest].last_refill_ms))
+        {
+            oldest = i;
+        }
+    }
+
+    if (SI_CFG_RATELIMIT_CLIENT_NUM == free_index)
+    {
+        free_index = oldest;
+        g_counters.evicted += 1u;
+    }
+
+    g_buckets[free_index].used = TRUE;
+    g_buckets[free_index].src_ipv4 = src_ipv4;
+    g_buckets[free_index].tokens = SI_RATELIMIT_TOKENS_INITIAL;
+    g_buckets[free_index].last_refill_ms = g_time_ms;
+    g_buckets[free_index].rejected = 0u;
+
+    return &(g_buckets[free_index]);
+}
+
+static void SI_RATELIMIT_refill(struct SI_RATELIMIT_bucket* bucket)
+{
+    const uint32 elapsed_ms = g_time_ms - bucket->last_refill_ms;   // wraps properly on time base overflow
+
+    if (SI_RATELIMIT_FULL_REFILL_MS <= elapsed_ms)
+    {
+        bucket->tokens = SI_RATELIMIT_TOKENS_MAX;
+    }
+    else
+    {
+        bucket->tokens += (elapsed_ms * SI_CFG_RATELIMIT_RATE_PER_SEC);
+
+        if (SI_RATELIMIT_TOKENS_MAX < bucket->tokens)
+        {
+            bucket->tokens = SI_RATELIMIT_TOKENS_MAX;
+        }
+    }
+    bucket->last_refill_ms = g_time_ms;
+}
+
+#endif
+
+/* END OF SI_RATELIMIT.C FILE */
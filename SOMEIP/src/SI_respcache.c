@@ -0,0 +1,338 @@
+/**
+ * @file    SI_respcache.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_respcache.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_respcache.h"
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+#include "SI_message.h"
+#include "SI_endian.h"
+
+#include <string.h>         // for memcpy
+
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SI_RESPCACHE_pool g_response_cache;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static inline boolean SI_RESPCACHE_match(const struct SI_RESPCACHE_element* element, const struct SI_Header* request, uint32 src_ipv4);
+static uint32 SI_RESPCACHE_allocate(void);
+static inline boolean SI_RESPCACHE_memo_match(const struct SI_RESPCACHE_memoElement* element, const struct SI_Header* request, uint16 local_port);
+static uint32 SI_RESPCACHE_memo_allocate(const struct SI_Header* request, uint16 local_port);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Searches a stored response for the given request.
+ * On success out_response refers to the stored bytes, it is ready to be transmitted.
+ * @note out_response is not a Tx pool element, it must not be passed to SI_MESSAGE_invalidate().
+ *
+ * @param request: header of the received request
+ * @param src_ipv4: address of the requester (network order)
+ * @param out_response: builder referring to the stored response
+ *
+ * @returns TRUE if request is a duplicate and a stored response is available
+ */
+boolean SI_RESPCACHE_lookup(const struct SI_Header* request, uint32 src_ipv4, struct SI_MessageBuilder* out_response)
+{
+    uint32 i = 0u;
+
+    if ((NULLPTR == request) || (NULLPTR == out_response))
+    {
+        return FALSE;
+    }
+
+    for (i = 0u; i < SI_CFG_RESPCACHE_ELEMENT_NUM; i++)
+    {
+        if (TRUE == SI_RESPCACHE_match(&(g_response_cache.pool[i]), request, src_ipv4))
+        {
+            out_response->data = g_response_cache.pool[i].buffer;
+            out_response->cap = g_response_cache.pool[i].length;
+            out_response->cursor = g_response_cache.pool[i].length;
+            out_response->length = g_response_cache.pool[i].length;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Stores a finalized response. If every element is used, the oldest one is overwritten.
+ *
+ * @param request: header of the received request
+ * @param src_ipv4: address of the requester (network order)
+ * @param response: finalized response message
+ *
+ * @returns TRUE if response is stored, FALSE if it does not fit into a cache element
+ */
+boolean SI_RESPCACHE_store(const struct SI_Header* request, uint32 src_ipv4, const struct SI_MessageBuilder* response)
+{
+    uint32 index = SI_CFG_RESPCACHE_ELEMENT_NUM;
+
+    if ((NULLPTR == request) || (NULLPTR == response) || (NULLPTR == response->data))
+    {
+        return FALSE;
+    }
+
+    if (SI_CFG_RESPCACHE_BLOCK_SIZE < response->length)
+    {
+        return FALSE;
+    }
+
+    index = SI_RESPCACHE_allocate();
+
+    g_response_cache.pool[index].used = TRUE;
+    g_response_cache.pool[index].src_ipv4 = src_ipv4;
+    g_response_cache.pool[index].message_id = request->message_id;
+    g_response_cache.pool[index].request_id = request->request_id;
+    g_response_cache.pool[index].age_ms = 0u;
+    g_response_cache.pool[index].length = response->length;
+    memcpy(g_response_cache.pool[index].buffer, response->data, response->length);
+
+    return TRUE;
+}
+
+/**
+ * Searches a memoized response of a cacheable method.
+ * On success the Request ID of the stored message is overwritten with the Request ID of the given request,
+ * out_response refers to the stored bytes, it is ready to be transmitted.
+ * @note out_response is not a Tx pool element, it must not be passed to SI_MESSAGE_invalidate().
+ *
+ * @param request: header of the received request
+ * @param local_port: port of the requested service instance
+ * @param out_response: builder referring to the stored response
+ *
+ * @returns TRUE if a valid memoized response is available
+ */
+boolean SI_RESPCACHE_memo_lookup(const struct SI_Header* request, uint16 local_port, struct SI_MessageBuilder* out_response)
+{
+    uint32 i = 0u;
+    struct SI_RESPCACHE_memoElement* element = NULLPTR;
+
+    if ((NULLPTR == request) || (NULLPTR == out_response))
+    {
+        return FALSE;
+    }
+
+    for (i = 0u; i < SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM; i++)
+    {
+        element = &(g_response_cache.memo[i]);
+
+        if (TRUE == SI_RESPCACHE_memo_match(element, request, local_port))
+        {
+            // struct SI_RequestID: [client_id:16 | session_id:16], header offset 8
+            u16_to_u8array(&(element->buffer[8u]), request->request_id.clientID);
+            u16_to_u8array(&(element->buffer[10u]), request->request_id.sessionID);
+
+            out_response->data = element->buffer;
+            out_response->cap = element->length;
+            out_response->cursor = element->length;
+            out_response->length = element->length;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Memoizes a finalized response of a cacheable method.
+ * Previous response of the same method is overwritten, otherwise a free or the oldest element is used.
+ *
+ * @param request: header of the received request
+ * @param local_port: port of the requested service instance
+ * @param ttl_ms: validity of the stored response, 0u means "valid until invalidated"
+ * @param response: finalized response message
+ *
+ * @returns TRUE if response is stored, FALSE if it does not fit into a cache element
+ */
+boolean SI_RESPCACHE_memo_store(const struct SI_Header* request, uint16 local_port, uint32 ttl_ms, const struct SI_MessageBuilder* response)
+{
+    uint32 index = SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM;
+
+    if ((NULLPTR == request) || (NULLPTR == response) || (NULLPTR == response->data))
+    {
+        return FALSE;
+    }
+
+    if (SI_CFG_RESPCACHE_BLOCK_SIZE < response->length)
+    {
+        return FALSE;
+    }
+
+    index = SI_RESPCACHE_memo_allocate(request, local_port);
+
+    g_response_cache.memo[index].used = TRUE;
+    g_response_cache.memo[index].local_port = local_port;
+    g_response_cache.memo[index].message_id = request->message_id;
+    g_response_cache.memo[index].interface_version = request->interface_version;
+    g_response_cache.memo[index].ttl_ms = ttl_ms;
+    g_response_cache.memo[index].age_ms = 0u;
+    g_response_cache.memo[index].length = response->length;
+    memcpy(g_response_cache.memo[index].buffer, response->data, response->length);
+
+    return TRUE;
+}
+
+/**
+ * Drops memoized responses of the given method (every instance).
+ * Call this when the value behind a cacheable method changes.
+ */
+void SI_RESPCACHE_memo_invalidate(uint16 service_id, uint16 method_id)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM; i++)
+    {
+        if ((service_id == g_response_cache.memo[i].message_id.serviceID) &&
+            (method_id == g_response_cache.memo[i].message_id.methodID_or_eventID))
+        {
+            g_response_cache.memo[i].used = FALSE;
+        }
+    }
+}
+
+/**
+ * Timekeeping: ages stored responses, drops the ones older than SI_CFG_RESPCACHE_WINDOW_MS
+ * and the memoized ones older than their ttl.
+ * @note Call this in every cycle!
+ */
+void SI_RESPCACHE_tick(uint32 elapsed_time_ms)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < SI_CFG_RESPCACHE_ELEMENT_NUM; i++)
+    {
+        if (TRUE == g_response_cache.pool[i].used)
+        {
+            g_response_cache.pool[i].age_ms += elapsed_time_ms;
+
+            if (SI_CFG_RESPCACHE_WINDOW_MS <= g_response_cache.pool[i].age_ms)
+            {
+                g_response_cache.pool[i].used = FALSE;
+            }
+        }
+    }
+
+    for (i = 0u; i < SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM; i++)
+    {
+        if (TRUE == g_response_cache.memo[i].used)
+        {
+            g_response_cache.memo[i].age_ms += elapsed_time_ms;
+
+            if ((0u != g_response_cache.memo[i].ttl_ms) && (g_response_cache.memo[i].ttl_ms <= g_response_cache.memo[i].age_ms))
+            {
+                g_response_cache.memo[i].used = FALSE;
+            }
+        }
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static inline boolean SI_RESPCACHE_match(const struct SI_RESPCACHE_element* element, const struct SI_Header* request, uint32 src_ipv4)
+{
+    return ((TRUE == element->used) &&
+            (src_ipv4 == element->src_ipv4) &&
+            (request->message_id.serviceID == element->message_id.serviceID) &&
+            (request->message_id.methodID_or_eventID == element->message_id.methodID_or_eventID) &&
+            (request->request_id.clientID == element->request_id.clientID) &&
+            (request->request_id.sessionID == element->request_id.sessionID));
+}
+
+/**
+ * @returns Index of a free element, or the index of the oldest element if every element is used.
+ */
+static uint32 SI_RESPCACHE_allocate(void)
+{
+    uint32 i = 0u;
+    uint32 oldest = 0u;
+
+    for (i = 0u; i < SI_CFG_RESPCACHE_ELEMENT_NUM; i++)
+    {
+        if (FALSE == g_response_cache.pool[i].used)
+        {
+            return i;
+        }
+
+        if (g_response_cache.pool[i].age_ms > g_response_cache.pool[oldest].age_ms)
+        {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+static inline boolean SI_RESPCACHE_memo_match(const struct SI_RESPCACHE_memoElement* element, const struct SI_Header* request, uint16 local_port)
+{
+    return ((TRUE == element->used) &&
+            (local_port == element->local_port) &&
+            (request->message_id.serviceID == element->message_id.serviceID) &&
+            (request->message_id.methodID_or_eventID == element->message_id.methodID_or_eventID) &&
+            (request->interface_version == element->interface_version));
+}
+
+/**
+ * @returns Index of the element already holding the response of the method, otherwise index of a free element,
+ *          or the index of the oldest element if every element is used.
+ */
+static uint32 SI_RESPCACHE_memo_allocate(const struct SI_Header* request, uint16 local_port)
+{
+    uint32 i = 0u;
+    uint32 free_index = SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM;
+    uint32 oldest = 0u;
+
+    for (i = 0u; i < SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM; i++)
+    {
+        if (TRUE == SI_RESPCACHE_memo_match(&(g_response_cache.memo[i]), request, local_port))
+        {
+            return i;
+        }
+
+        if ((FALSE == g_response_cache.memo[i].used) && (SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM == free_index))
+        {
+            free_index = i;
+        }
+
+        if (g_response_cache.memo[i].age_ms > g_response_cache.memo[oldest].age_ms)
+        {
+            oldest = i;
+        }
+    }
+    return (SI_CFG_RESPCACHE_MEMO_ELEMENT_NUM != free_index) ? (free_index) : (oldest);
+}
+
+#endif
+
+/* END OF SI_RESPCACHE.C FILE */
@@ -15,6 +15,12 @@
 #include "SI_config.h"
 #include "SI_header.h"
 #include "SI_message.h"
+#include "SI_hash.h"
+
+#include <assert.h>
+#include <string.h>         // for memset
+
+static_assert(SI_HASH_IS_POWER_OF_TWO(SI_CFG_EVENT_HANDLER_INDEX_SIZE), "FATAL ERROR: SI_CFG_EVENT_HANDLER_INDEX_SIZE must be a power of two!");
 
 /* **************************************************** */
 /*                       Defines                        */
@@ -27,6 +33,9 @@
 static struct SI_Service local_service_registry[SI_CFG_MAX_SERVICES] = {0u};
 static uint32 local_service_count = 0u;
 
+static struct SI_EventHandlerEntry event_handler_index[SI_CFG_EVENT_HANDLER_INDEX_SIZE] = {0u};
+static uint32 event_handler_count = 0u;
+
 /* **************************************************** */
 /*                True global variables                 */
 /* **************************************************** */
@@ -40,6 +49,7 @@ static uint32 local_service_count = 0u;
 /* **************************************************** */
 
 void SI_SERVMAN_erase_methodlist(struct SI_MethodEntry* method);
+static inline uint32 SI_SERVMAN_event_index_home(uint16 service_id, uint16 event_id);
 
 /* **************************************************** */
 /*             Global function definitions              */
@@ -250,6 +260,8 @@ boolean SI_SERVMAN_rmv_method(struct SI_Service* service, const struct SI_Method
             found_service->method[i].valid = FALSE;
             found_service->method[i].handler_func = NULLPTR;
             found_service->method[i].method_id = 0u;
+            found_service->method[i].cacheable = FALSE;
+            found_service->method[i].cache_ttl_ms = 0u;
 
             found_service->method_counter -= 1u;
             return TRUE;
@@ -258,10 +270,111 @@ boolean SI_SERVMAN_rmv_method(struct SI_Service* service, const struct SI_Method
     return FALSE;
 }
 
+/**
+ * Registers handler for received notifications of an event.
+ * Event handlers are kept in a separate hash index, lookup does not depend on the number of services or methods.
+ * Handler of an already registered event is replaced.
+ *
+ * @returns TRUE if handler is registered, FALSE if index is full or IDs are invalid
+ */
+boolean SI_SERVMAN_add_event_handler(uint16 service_id, uint16 event_id, SI_EventHandler_fptr handler_func)
+{
+    uint32 i = 0u;
+    uint32 index = 0u;
+    struct SI_EventHandlerEntry* existing = NULLPTR;
+    struct SI_EventHandlerEntry* entry = NULLPTR;
+
+    if ((NULLPTR == handler_func) || (FALSE == SI_HEADER_is_event(event_id)))
+    {
+        return FALSE;
+    }
+
+    existing = SI_SERVMAN_find_event_handler(service_id, event_id);
+    if (NULLPTR != existing)
+    {
+        existing->handler_func = handler_func;
+        return TRUE;
+    }
+
+    index = SI_SERVMAN_event_index_home(service_id, event_id);
+    for (i = 0u; i < SI_CFG_EVENT_HANDLER_INDEX_SIZE; i++)
+    {
+        entry = &(event_handler_index[(index + i) & (SI_CFG_EVENT_HANDLER_INDEX_SIZE - 1u)]);
+
+        if (FALSE == entry->valid)
+        {
+            entry->valid = TRUE;
+            entry->deleted = FALSE;
+            entry->service_id = service_id;
+            entry->event_id = event_id;
+            entry->handler_func = handler_func;
+            event_handler_count += 1u;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Searches the handler of an event (linear probing from the hashed slot).
+ *
+ * @returns pointer for event handler entry, NULLPTR if event has no handler
+ */
+struct SI_EventHandlerEntry* SI_SERVMAN_find_event_handler(uint16 service_id, uint16 event_id)
+{
+    uint32 i = 0u;
+    uint32 index = SI_SERVMAN_event_index_home(service_id, event_id);
+    struct SI_EventHandlerEntry* entry = NULLPTR;
+
+    for (i = 0u; i < SI_CFG_EVENT_HANDLER_INDEX_SIZE; i++)
+    {
+        entry = &(event_handler_index[(index + i) & (SI_CFG_EVENT_HANDLER_INDEX_SIZE - 1u)]);
+
+        if ((FALSE == entry->valid) && (FALSE == entry->deleted))
+        {
+            // never used slot, end of probe sequence
+            return NULLPTR;
+        }
+
+        if ((TRUE == entry->valid) && (service_id == entry->service_id) && (event_id == entry->event_id))
+        {
+            return entry;
+        }
+    }
+    return NULLPTR;
+}
+
+boolean SI_SERVMAN_rmv_event_handler(uint16 service_id, uint16 event_id)
+{
+    struct SI_EventHandlerEntry* entry = SI_SERVMAN_find_event_handler(service_id, event_id);
+
+    if (NULLPTR == entry)
+    {
+        return FALSE;
+    }
+
+    entry->valid = FALSE;
+    entry->deleted = TRUE;
+    entry->handler_func = NULLPTR;
+    event_handler_count -= 1u;
+
+    if (0u == event_handler_count)
+    {
+        // No handler: deleted markers can be dropped, probe sequences become short again
+        memset(event_handler_index, 0, sizeof(event_handler_index));
+    }
+    return TRUE;
+}
+
 /* **************************************************** */
 /*             Local function definitions               */
 /* **************************************************** */
 
+static inline uint32 SI_SERVMAN_event_index_home(uint16 service_id, uint16 event_id)
+{
+    return (SI_HASH_u32(((uint32)service_id << 16u) | (uint32)event_id) & (SI_CFG_EVENT_HANDLER_INDEX_SIZE - 1u));
+}
+
 void SI_SERVMAN_erase_methodlist(struct SI_MethodEntry* method)
 {
     uint16 i = 0u;
@@ -271,6 +384,8 @@ void SI_SERVMAN_erase_methodlist(struct SI_MethodEntry* method)
         method[i].valid = FALSE;
         method[i].handler_func = NULLPTR;
         method[i].method_id = 0u;
+        method[i].cacheable = FALSE;
+        method[i].cache_ttl_ms = 0u;
     }
 }
 
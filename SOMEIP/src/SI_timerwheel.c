@@ -0,0 +1,216 @@
+/**
+ * @file    SI_timerwheel.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_timerwheel.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_timerwheel.h"
+
+#include "SI_types.h"
+#include "SI_config.h"
+
+#include <assert.h>
+#include <string.h>         // for memset
+
+static_assert(0u < SI_CFG_TIMERWHEEL_RESOLUTION_MS, "FATAL ERROR: Timer wheel resolution must be at least 1 ms!");
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static void SI_TIMERWHEEL_link(struct SI_TIMERWHEEL_wheel* wheel, struct SI_TIMERWHEEL_node* node);
+static void SI_TIMERWHEEL_cascade(struct SI_TIMERWHEEL_wheel* wheel, uint32 level);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+void SI_TIMERWHEEL_init(struct SI_TIMERWHEEL_wheel* wheel)
+{
+    if (NULLPTR != wheel)
+    {
+        memset(wheel, 0, sizeof(struct SI_TIMERWHEEL_wheel));
+    }
+}
+
+/**
+ * Arms a timer. An already armed timer is re-armed with the new delay.
+ *
+ * @param delay_ms: rounded up to the wheel resolution (SI_CFG_TIMERWHEEL_RESOLUTION_MS), at least one tick
+ * @param callback: called from SI_TIMERWHEEL_advance() when the timer expires
+ * @param context: passed to callback
+ *
+ * @returns TRUE if timer is armed
+ */
+boolean SI_TIMERWHEEL_arm(struct SI_TIMERWHEEL_wheel* wheel, struct SI_TIMERWHEEL_node* node, uint32 delay_ms,
+                          SI_TIMERWHEEL_Callback_fptr callback, void* context)
+{
+    uint32 ticks = 0u;
+
+    if ((NULLPTR == wheel) || (NULLPTR == node) || (NULLPTR == callback))
+    {
+        return FALSE;
+    }
+
+    SI_TIMERWHEEL_cancel(node);
+
+    ticks = (delay_ms / SI_CFG_TIMERWHEEL_RESOLUTION_MS) + ((0u == (delay_ms % SI_CFG_TIMERWHEEL_RESOLUTION_MS)) ? 0u : 1u);
+    if (0u == ticks)
+    {
+        ticks = 1u;
+    }
+    else if (SI_TIMERWHEEL_MAX_TICKS < ticks)
+    {
+        ticks = SI_TIMERWHEEL_MAX_TICKS;
+    }
+
+    node->expiry_tick = wheel->now_tick + ticks;
+    node->callback = callback;
+    node->context = context;
+    SI_TIMERWHEEL_link(wheel, node);
+    return TRUE;
+}
+
+/**
+ * Disarms a timer. Does nothing if the timer is not armed.
+ */
+void SI_TIMERWHEEL_cancel(struct SI_TIMERWHEEL_node* node)
+{
+    if ((NULLPTR == node) || (NULLPTR == node->slot))
+    {
+        return;
+    }
+
+    if (NULLPTR != node->prev)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        *(node->slot) = node->next;
+    }
+
+    if (NULLPTR != node->next)
+    {
+        node->next->prev = node->prev;
+    }
+
+    node->next = NULLPTR;
+    node->prev = NULLPTR;
+    node->slot = NULLPTR;
+}
+
+/**
+ * Timekeeping: expires the timers of the elapsed ticks, callbacks are invoked from here.
+ * @note Call this in every cycle!
+ */
+void SI_TIMERWHEEL_advance(struct SI_TIMERWHEEL_wheel* wheel, uint32 elapsed_time_ms)
+{
+    uint32 level = 0u;
+    struct SI_TIMERWHEEL_node* node = NULLPTR;
+
+    if (NULLPTR == wheel)
+    {
+        return;
+    }
+
+    wheel->remainder_ms += elapsed_time_ms;
+
+    while (SI_CFG_TIMERWHEEL_RESOLUTION_MS <= wheel->remainder_ms)
+    {
+        wheel->remainder_ms -= SI_CFG_TIMERWHEEL_RESOLUTION_MS;
+        wheel->now_tick += 1u;
+
+        // Lower level wrapped around -> timers of the next period move down from the upper level
+        for (level = 1u; level < SI_TIMERWHEEL_LEVEL_NUM; level++)
+        {
+            if (0u != ((wheel->now_tick >> (SI_TIMERWHEEL_SLOT_BITS * (level - 1u))) & SI_TIMERWHEEL_SLOT_MASK))
+            {
+                break;
+            }
+            SI_TIMERWHEEL_cascade(wheel, level);
+        }
+
+        // Callback can arm timers into the same slot, they belong to a later period: take the head one by one
+        node = wheel->slots[0u][wheel->now_tick & SI_TIMERWHEEL_SLOT_MASK];
+        while ((NULLPTR != node) && (node->expiry_tick == wheel->now_tick))
+        {
+            SI_TIMERWHEEL_cancel(node);
+            node->callback(node->context);
+            node = wheel->slots[0u][wheel->now_tick & SI_TIMERWHEEL_SLOT_MASK];
+        }
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+/**
+ * Links node into the slot of its expiry. Level is chosen by the remaining time.
+ */
+static void SI_TIMERWHEEL_link(struct SI_TIMERWHEEL_wheel* wheel, struct SI_TIMERWHEEL_node* node)
+{
+    const uint32 delta = node->expiry_tick - wheel->now_tick;
+    uint32 level = 0u;
+    struct SI_TIMERWHEEL_node** slot = NULLPTR;
+
+    while ((level < (SI_TIMERWHEEL_LEVEL_NUM - 1u)) &&
+           ((1u << (SI_TIMERWHEEL_SLOT_BITS * (level + 1u))) <= delta))
+    {
+        level++;
+    }
+
+    slot = &(wheel->slots[level][(node->expiry_tick >> (SI_TIMERWHEEL_SLOT_BITS * level)) & SI_TIMERWHEEL_SLOT_MASK]);
+
+    node->prev = NULLPTR;
+    node->next = *slot;
+    if (NULLPTR != *slot)
+    {
+        (*slot)->prev = node;
+    }
+    *slot = node;
+    node->slot = slot;
+}
+
+/**
+ * Re-links the timers of the current slot of an upper level, they expire within the period of the lower level.
+ */
+static void SI_TIMERWHEEL_cascade(struct SI_TIMERWHEEL_wheel* wheel, uint32 level)
+{
+    struct SI_TIMERWHEEL_node** slot = &(wheel->slots[level][(wheel->now_tick >> (SI_TIMERWHEEL_SLOT_BITS * level)) & SI_TIMERWHEEL_SLOT_MASK]);
+    struct SI_TIMERWHEEL_node* node = *slot;
+    struct SI_TIMERWHEEL_node* next = NULLPTR;
+
+    *slot = NULLPTR;
+
+    while (NULLPTR != node)
+    {
+        next = node->next;
+        SI_TIMERWHEEL_link(wheel, node);
+        node = next;
+    }
+}
+
+/* END OF SI_TIMERWHEEL.C FILE */
@@ -0,0 +1,191 @@
+/**
+ * @file    SI_txqueue.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements SI_txqueue.h"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_txqueue.h"
+
+#include "lwip/ip_addr.h"
+#include "lwip/udp.h"
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_header.h"
+#include "SI_servman.h"
+
+#include <string.h>         // for memcpy
+
+#if (TRUE == SI_CFG_ENABLE_TX_BACKPRESSURE)
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SI_TXQUEUE_element g_tx_queue[SI_CFG_TXQUEUE_ELEMENT_NUM];
+static uint32 g_tx_queue_head = 0u;     // index of the oldest element
+static uint32 g_tx_queue_count = 0u;
+static struct SI_TXQUEUE_counters g_counters;
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+/* **************************************************** */
+/*                Local type definitions                */
+/* **************************************************** */
+
+/* **************************************************** */
+/*             Local function declarations              */
+/* **************************************************** */
+
+static inline uint32 SI_TXQUEUE_index(uint32 position);
+static boolean SI_TXQUEUE_contains(const struct SI_Header* header, const ip_addr_t* src_addr, u16_t src_port);
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+/**
+ * Defers a request. Retransmission of an already deferred request is not stored again.
+ *
+ * @param pcb: pcb the request was received on
+ * @param request: received request, payload is copied
+ * @param src_addr: address of the requester
+ * @param src_port: port of the requester
+ *
+ * @returns TRUE if the request is deferred (or it is already deferred)
+ */
+boolean SI_TXQUEUE_push(struct udp_pcb* pcb, const struct SI_MessageContext* request, const ip_addr_t* src_addr, u16_t src_port)
+{
+    struct SI_TXQUEUE_element* element = NULLPTR;
+
+    if ((NULLPTR == pcb) || (NULLPTR == request) || (NULLPTR == src_addr))
+    {
+        return FALSE;
+    }
+
+    if (SI_CFG_TXQUEUE_PAYLOAD_SIZE < request->payload.length)
+    {
+        return FALSE;
+    }
+
+    if (TRUE == SI_TXQUEUE_contains(&(request->header), src_addr, src_port))
+    {
+        return TRUE;
+    }
+
+    if (SI_CFG_TXQUEUE_ELEMENT_NUM <= g_tx_queue_count)
+    {
+        g_counters.overflow += 1u;
+        return FALSE;
+    }
+
+    element = &(g_tx_queue[SI_TXQUEUE_index(g_tx_queue_count)]);
+    element->pcb = pcb;
+    element->src_addr = *src_addr;
+    element->src_port = src_port;
+    element->header = request->header;
+    element->payload_length = request->payload.length;
+    memcpy(element->payload, request->payload.data, request->payload.length);
+    element->age_ms = 0u;
+
+    g_tx_queue_count += 1u;
+    g_counters.deferred += 1u;
+    return TRUE;
+}
+
+/**
+ * Removes the oldest deferred request from the queue.
+ * @note Payload of the request is copied into out_element, it remains valid after the next push.
+ *
+ * @returns TRUE if a request is popped, FALSE if queue is empty
+ */
+boolean SI_TXQUEUE_pop(struct SI_TXQUEUE_element* out_element)
+{
+    if ((NULLPTR == out_element) || (0u == g_tx_queue_count))
+    {
+        return FALSE;
+    }
+
+    *out_element = g_tx_queue[g_tx_queue_head];
+    g_tx_queue_head = SI_TXQUEUE_index(1u);
+    g_tx_queue_count -= 1u;
+    return TRUE;
+}
+
+void SI_TXQUEUE_get_counters(struct SI_TXQUEUE_counters* out_counters)
+{
+    if (NULLPTR != out_counters)
+    {
+        *out_counters = g_counters;
+    }
+}
+
+/**
+ * Timekeeping: ages deferred requests, drops the ones older than SI_CFG_TXQUEUE_DEADLINE_MS.
+ * Every request has the same deadline, so the expired ones are always at the head of the queue.
+ * @note Call this in every cycle!
+ */
+void SI_TXQUEUE_tick(uint32 elapsed_time_ms)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < g_tx_queue_count; i++)
+    {
+        g_tx_queue[SI_TXQUEUE_index(i)].age_ms += elapsed_time_ms;
+    }
+
+    while ((0u < g_tx_queue_count) && (SI_CFG_TXQUEUE_DEADLINE_MS <= g_tx_queue[g_tx_queue_head].age_ms))
+    {
+        g_tx_queue_head = SI_TXQUEUE_index(1u);
+        g_tx_queue_count -= 1u;
+        g_counters.expired += 1u;
+    }
+}
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+/**
+ * @returns Array index of the element at the given position, counted from the head of the queue
+ */
+static inline uint32 SI_TXQUEUE_index(uint32 position)
+{
+    return ((g_tx_queue_head + position) % SI_CFG_TXQUEUE_ELEMENT_NUM);
+}
+
+static boolean SI_TXQUEUE_contains(const struct SI_Header* header, const ip_addr_t* src_addr, u16_t src_port)
+{
+    uint32 i = 0u;
+    const struct SI_TXQUEUE_element* element = NULLPTR;
+
+    for (i = 0u; i < g_tx_queue_count; i++)
+    {
+        element = &(g_tx_queue[SI_TXQUEUE_index(i)]);
+
+        if ((src_addr->addr == element->src_addr.addr) &&
+            (src_port == element->src_port) &&
+            (header->message_id.serviceID == element->header.message_id.serviceID) &&
+            (header->message_id.methodID_or_eventID == element->header.message_id.methodID_or_eventID) &&
+            (header->request_id.clientID == element->header.request_id.clientID) &&
+            (header->request_id.sessionID == element->header.request_id.sessionID))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+#endif
+
+/* END OF SI_TXQUEUE.C FILE */
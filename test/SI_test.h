@@ -0,0 +1,44 @@
+// Include guard starts here
+#ifndef SI_TEST_H_
+#define SI_TEST_H_
+
+/**
+ * @file    SI_test.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Minimal check macros of the host tests. Every test_*.c is a separate program (module states are global),
+ *           a failed check is printed and the test goes on. Return SI_TEST_RESULT() from main()."
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include <stdio.h>
+
+#include "SI_types.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define SI_TEST_CHECK(condition)                                                            \
+    do                                                                                      \
+    {                                                                                       \
+        if (!(condition))                                                                   \
+        {                                                                                   \
+            g_si_test_failed += 1u;                                                         \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);            \
+        }                                                                                   \
+    } while (0)
+
+#define SI_TEST_RESULT()        ((0u == g_si_test_failed) ? 0 : 1)
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static uint32 g_si_test_failed = 0u;
+
+// Include guard stops here
+#endif // SI_TEST_H_
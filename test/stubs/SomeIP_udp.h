@@ -0,0 +1,20 @@
+// Include guard starts here
+#ifndef SOMEIP_UDP_H_
+#define SOMEIP_UDP_H_
+
+/**
+ * @file    SomeIP_udp.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test stub of the UDP transport of the application. Transmissions are counted, see stubs.h."
+ */
+
+#include "lwip/udp.h"
+
+#include "SI_types.h"
+#include "SI_message.h"
+
+err_t SomeIP_udp_transmit(struct udp_pcb* pcb, uint32 addr, uint16 port, struct SI_MessageBuilder* message);
+
+// Include guard stops here
+#endif // SOMEIP_UDP_H_
@@ -0,0 +1,20 @@
+// Include guard starts here
+#ifndef LWIP_ARCH_H_
+#define LWIP_ARCH_H_
+
+/**
+ * @file    arch.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test stub of lwIP: basic types."
+ */
+
+#include <stdint.h>
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+typedef int8_t s8_t;
+
+// Include guard stops here
+#endif // LWIP_ARCH_H_
@@ -0,0 +1,20 @@
+// Include guard starts here
+#ifndef LWIP_DEF_H_
+#define LWIP_DEF_H_
+
+/**
+ * @file    def.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test stub of lwIP: byte order conversion."
+ */
+
+#include "lwip/arch.h"
+
+u16_t lwip_htons(u16_t x);
+u16_t lwip_ntohs(u16_t x);
+u32_t lwip_htonl(u32_t x);
+u32_t lwip_ntohl(u32_t x);
+
+// Include guard stops here
+#endif // LWIP_DEF_H_
@@ -0,0 +1,20 @@
+// Include guard starts here
+#ifndef LWIP_ERR_H_
+#define LWIP_ERR_H_
+
+/**
+ * @file    err.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test stub of lwIP: error codes."
+ */
+
+#include "lwip/arch.h"
+
+typedef s8_t err_t;
+
+#define ERR_OK      (0)
+#define ERR_MEM     (-1)
+
+// Include guard stops here
+#endif // LWIP_ERR_H_
@@ -0,0 +1,19 @@
+// Include guard starts here
+#ifndef LWIP_IP_H_
+#define LWIP_IP_H_
+
+/**
+ * @file    ip.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test stub of lwIP: destination address of the received datagram, set by the test."
+ */
+
+#include "lwip/ip_addr.h"
+
+extern ip_addr_t g_stub_dest_addr;
+
+#define ip_current_dest_addr()          (&g_stub_dest_addr)
+
+// Include guard stops here
+#endif // LWIP_IP_H_
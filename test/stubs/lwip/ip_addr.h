@@ -0,0 +1,22 @@
+// Include guard starts here
+#ifndef LWIP_IP_ADDR_H_
+#define LWIP_IP_ADDR_H_
+
+/**
+ * @file    ip_addr.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test stub of lwIP: IPv4 address (network order)."
+ */
+
+#include "lwip/def.h"
+
+typedef struct
+{
+    u32_t addr;
+} ip_addr_t;
+
+#define ip_addr_ismulticast(ipaddr)     ((lwip_ntohl((ipaddr)->addr) & 0xF0000000u) == 0xE0000000u)
+
+// Include guard stops here
+#endif // LWIP_IP_ADDR_H_
@@ -0,0 +1,24 @@
+// Include guard starts here
+#ifndef LWIP_PBUF_H_
+#define LWIP_PBUF_H_
+
+/**
+ * @file    pbuf.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test stub of lwIP: single buffer packets."
+ */
+
+#include "lwip/arch.h"
+#include "lwip/err.h"
+
+struct pbuf
+{
+    struct pbuf* next;
+    void* payload;
+    u16_t tot_len;
+    u16_t len;
+};
+
+// Include guard stops here
+#endif // LWIP_PBUF_H_
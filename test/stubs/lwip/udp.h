@@ -0,0 +1,23 @@
+// Include guard starts here
+#ifndef LWIP_UDP_H_
+#define LWIP_UDP_H_
+
+/**
+ * @file    udp.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test stub of lwIP: UDP control block."
+ */
+
+#include "lwip/arch.h"
+#include "lwip/err.h"
+#include "lwip/pbuf.h"
+#include "lwip/ip_addr.h"
+
+struct udp_pcb
+{
+    u16_t local_port;
+};
+
+// Include guard stops here
+#endif // LWIP_UDP_H_
@@ -0,0 +1,63 @@
+/**
+ * @file    stubs.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Implements the host test stubs of lwIP and of the UDP transport"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "stubs.h"
+
+#include "lwip/def.h"
+#include "lwip/ip.h"
+#include "SomeIP_udp.h"
+
+/* **************************************************** */
+/*                True global variables                 */
+/* **************************************************** */
+
+uint32 g_stub_transmit_count = 0u;
+err_t g_stub_transmit_result = ERR_OK;
+ip_addr_t g_stub_dest_addr = {0u};
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+u16_t lwip_htons(u16_t x)
+{
+    const u8_t* bytes = (const u8_t*)&x;
+    return (u16_t)(((u16_t)bytes[0] << 8u) | (u16_t)bytes[1]);
+}
+
+u16_t lwip_ntohs(u16_t x)
+{
+    return lwip_htons(x);
+}
+
+u32_t lwip_htonl(u32_t x)
+{
+    const u8_t* bytes = (const u8_t*)&x;
+    return (((u32_t)bytes[0] << 24u) | ((u32_t)bytes[1] << 16u) | ((u32_t)bytes[2] << 8u) | (u32_t)bytes[3]);
+}
+
+u32_t lwip_ntohl(u32_t x)
+{
+    return lwip_htonl(x);
+}
+
+err_t SomeIP_udp_transmit(struct udp_pcb* pcb, uint32 addr, uint16 port, struct SI_MessageBuilder* message)
+{
+    (void)pcb;
+    (void)addr;
+    (void)port;
+    (void)message;
+
+    g_stub_transmit_count += 1u;
+    return g_stub_transmit_result;
+}
+
+/* END OF STUBS.C FILE */
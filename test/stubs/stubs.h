@@ -0,0 +1,21 @@
+// Include guard starts here
+#ifndef STUBS_H_
+#define STUBS_H_
+
+/**
+ * @file    stubs.h
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Controls of the host test stubs."
+ */
+
+#include "lwip/err.h"
+#include "lwip/ip.h"
+
+#include "SI_types.h"
+
+extern uint32 g_stub_transmit_count;        // number of SomeIP_udp_transmit() calls
+extern err_t g_stub_transmit_result;        // returned by SomeIP_udp_transmit(), ERR_OK by default
+
+// Include guard stops here
+#endif // STUBS_H_
@@ -0,0 +1,149 @@
+/**
+ * @file    test_client.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test of SI_client.h: pending-request table with deleted markers, retransmission and timeout"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_test.h"
+#include "stubs.h"
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_client.h"
+
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define TEST_SERVICE_ID     (0x1234u)
+#define TEST_METHOD_ID      (0x0001u)
+#define TEST_CLIENT_ID      (0x0042u)
+#define TEST_TIMEOUT_MS     (100u)
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct udp_pcb g_pcb;
+static uint32 g_callbacks = 0u;
+static enum SI_ReturnCode_t g_return_code = SI_ReturnCode_OK;
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static void test_response(const struct SI_MessageContext* response, enum SI_ReturnCode_t return_code, void* user_data)
+{
+    (void)response;
+    (void)user_data;
+
+    g_callbacks += 1u;
+    g_return_code = return_code;
+}
+
+static struct SI_CLIENT_RequestParams test_params(uint8 max_retries)
+{
+    struct SI_CLIENT_RequestParams params = {0};
+
+    params.pcb = &g_pcb;
+    params.dst_ipv4 = lwip_htonl(0x0A000001u);
+    params.dst_port = 30501u;
+    params.service_id = TEST_SERVICE_ID;
+    params.method_id = TEST_METHOD_ID;
+    params.client_id = TEST_CLIENT_ID;
+    params.interface_version = 1u;
+    params.timeout_ms = TEST_TIMEOUT_MS;
+    params.max_retries = max_retries;
+    return params;
+}
+
+/**
+ * Outstanding requests stay reachable behind deleted elements, deleted elements are reused
+ */
+static void test_deleted_markers(void)
+{
+    uint32 i = 0u;
+    uint16 sessions[SI_CFG_CLIENT_PENDING_NUM] = {0u};
+    const struct SI_CLIENT_RequestParams params = test_params(0u);
+
+    for (i = 0u; i < SI_CFG_CLIENT_PENDING_NUM; i++)
+    {
+        SI_TEST_CHECK(TRUE == SI_CLIENT_request(&params, NULLPTR, 0u, test_response, NULLPTR, &(sessions[i])));
+    }
+    SI_TEST_CHECK(SI_CFG_CLIENT_PENDING_NUM == SI_CLIENT_get_pending_count());
+    SI_TEST_CHECK(FALSE == SI_CLIENT_request(&params, NULLPTR, 0u, test_response, NULLPTR, NULLPTR));
+
+    for (i = 0u; i < SI_CFG_CLIENT_PENDING_NUM; i += 2u)
+    {
+        SI_TEST_CHECK(TRUE == SI_CLIENT_cancel(TEST_SERVICE_ID, TEST_METHOD_ID, TEST_CLIENT_ID, sessions[i]));
+        SI_TEST_CHECK(FALSE == SI_CLIENT_cancel(TEST_SERVICE_ID, TEST_METHOD_ID, TEST_CLIENT_ID, sessions[i]));
+    }
+    SI_TEST_CHECK((SI_CFG_CLIENT_PENDING_NUM / 2u) == SI_CLIENT_get_pending_count());
+
+    // New requests take the deleted elements
+    for (i = 0u; i < SI_CFG_CLIENT_PENDING_NUM; i += 2u)
+    {
+        SI_TEST_CHECK(TRUE == SI_CLIENT_request(&params, NULLPTR, 0u, test_response, NULLPTR, &(sessions[i])));
+    }
+    SI_TEST_CHECK(SI_CFG_CLIENT_PENDING_NUM == SI_CLIENT_get_pending_count());
+
+    for (i = 0u; i < SI_CFG_CLIENT_PENDING_NUM; i++)
+    {
+        SI_TEST_CHECK(TRUE == SI_CLIENT_cancel(TEST_SERVICE_ID, TEST_METHOD_ID, TEST_CLIENT_ID, sessions[i]));
+    }
+    SI_TEST_CHECK(0u == SI_CLIENT_get_pending_count());
+    SI_TEST_CHECK(0u == g_callbacks);
+}
+
+/**
+ * Request is retransmitted after every timeout while retries are left, then completed with TIMEOUT
+ */
+static void test_retry_and_timeout(void)
+{
+    const struct SI_CLIENT_RequestParams params = test_params(2u);
+    const uint8 payload[4] = {1u, 2u, 3u, 4u};
+    const uint32 sent_before = g_stub_transmit_count;
+
+    g_callbacks = 0u;
+    SI_TEST_CHECK(TRUE == SI_CLIENT_request(&params, payload, sizeof(payload), test_response, NULLPTR, NULLPTR));
+    SI_TEST_CHECK((sent_before + 1u) == g_stub_transmit_count);
+
+    SI_CLIENT_tick(TEST_TIMEOUT_MS - SI_CFG_TIMERWHEEL_RESOLUTION_MS);
+    SI_TEST_CHECK((sent_before + 1u) == g_stub_transmit_count);
+    SI_CLIENT_tick(SI_CFG_TIMERWHEEL_RESOLUTION_MS);
+    SI_TEST_CHECK((sent_before + 2u) == g_stub_transmit_count);
+    SI_CLIENT_tick(TEST_TIMEOUT_MS);
+    SI_TEST_CHECK((sent_before + 3u) == g_stub_transmit_count);
+    SI_TEST_CHECK(0u == g_callbacks);
+
+    SI_CLIENT_tick(TEST_TIMEOUT_MS);
+    SI_TEST_CHECK((sent_before + 3u) == g_stub_transmit_count);
+    SI_TEST_CHECK(1u == g_callbacks);
+    SI_TEST_CHECK(SI_ReturnCode_TIMEOUT == g_return_code);
+    SI_TEST_CHECK(0u == SI_CLIENT_get_pending_count());
+}
+
+#endif
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+int main(void)
+{
+#if (TRUE == SI_CFG_ENABLE_CLIENT)
+    test_deleted_markers();
+    test_retry_and_timeout();
+#endif
+
+    return SI_TEST_RESULT();
+}
+
+/* END OF TEST_CLIENT.C FILE */
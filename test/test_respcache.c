@@ -0,0 +1,149 @@
+/**
+ * @file    test_respcache.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test of SI_respcache.h: retransmitted requests are answered from the stored response
+ *           without invoking the method handler again, stored responses age out"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "lwip/pbuf.h"
+#include "lwip/ip_addr.h"
+#include "lwip/udp.h"
+
+#include "SI_test.h"
+#include "stubs.h"
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_servman.h"
+#include "SI_process.h"
+#include "SI_respcache.h"
+
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define TEST_SERVICE_ID         (0x1234u)
+#define TEST_METHOD_ID          (0x0001u)
+#define TEST_CLIENT_ID          (0x0042u)
+#define TEST_PORT               (30501u)
+#define TEST_REQUESTER_IPV4     (0x0700000Au)
+#define TEST_OTHER_IPV4         (0x0800000Au)
+#define TEST_REQUESTER_PORT     (40000u)
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct udp_pcb g_pcb;
+static uint32 g_handler_calls = 0u;
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static enum SI_ReturnCode_t test_handler(const struct SI_MessageContext* request, struct SI_MessageBuilder* response)
+{
+    (void)request;
+    (void)response;
+
+    g_handler_calls += 1u;
+    return SI_ReturnCode_OK;
+}
+
+static void test_add_service(void)
+{
+    struct SI_Service service = {0};
+    struct SI_MethodEntry method = {0};
+
+    service.valid = TRUE;
+    service.service_id = TEST_SERVICE_ID;
+    service.instance.instance_id = 1u;
+    service.instance.port_be = TEST_PORT;
+    service.interface_version = 1u;
+    SI_TEST_CHECK(TRUE == SI_SERVMAN_add_service(&service));
+
+    method.valid = TRUE;
+    method.method_id = TEST_METHOD_ID;
+    method.handler_func = test_handler;
+    SI_TEST_CHECK(TRUE == SI_SERVMAN_add_method(SI_SERVMAN_find_service(TEST_SERVICE_ID, TEST_PORT, 1u), &method));
+
+    g_pcb.local_port = TEST_PORT;
+}
+
+/**
+ * Receives a REQUEST of the test method
+ *
+ * @returns number of handler invocations it caused
+ */
+static uint32 test_request(uint32 src_ipv4, uint16 session_id)
+{
+    uint8 datagram[] = {(uint8)(TEST_SERVICE_ID >> 8u), (uint8)TEST_SERVICE_ID, (uint8)(TEST_METHOD_ID >> 8u), (uint8)TEST_METHOD_ID,
+                        0u, 0u, 0u, 8u,
+                        (uint8)(TEST_CLIENT_ID >> 8u), (uint8)TEST_CLIENT_ID, (uint8)(session_id >> 8u), (uint8)session_id,
+                        1u, 1u, 0x00u, 0x00u};
+    struct pbuf rx_pbuf = {NULLPTR, datagram, sizeof(datagram), sizeof(datagram)};
+    const ip_addr_t src_addr = {src_ipv4};
+    const uint32 calls_before = g_handler_calls;
+    const uint32 sent_before = g_stub_transmit_count;
+
+    SI_TEST_CHECK(TRUE == SI_PROCESS_unicast(&g_pcb, &rx_pbuf, &src_addr, TEST_REQUESTER_PORT));
+    SI_TEST_CHECK((sent_before + 1u) == g_stub_transmit_count);
+
+    return (g_handler_calls - calls_before);
+}
+
+/**
+ * Same requester, Client ID and Session ID: response is replayed. Other sessions and requesters invoke the handler.
+ */
+static void test_duplicate_suppressed(void)
+{
+    SI_TEST_CHECK(1u == test_request(TEST_REQUESTER_IPV4, 1u));
+    SI_TEST_CHECK(0u == test_request(TEST_REQUESTER_IPV4, 1u));
+    SI_TEST_CHECK(0u == test_request(TEST_REQUESTER_IPV4, 1u));
+
+    SI_TEST_CHECK(1u == test_request(TEST_REQUESTER_IPV4, 2u));
+    SI_TEST_CHECK(1u == test_request(TEST_OTHER_IPV4, 1u));
+    SI_TEST_CHECK(0u == test_request(TEST_REQUESTER_IPV4, 2u));
+}
+
+/**
+ * Stored response is replayed within SI_CFG_RESPCACHE_WINDOW_MS only
+ */
+static void test_window_ages_out(void)
+{
+    SI_TEST_CHECK(1u == test_request(TEST_REQUESTER_IPV4, 3u));
+
+    SI_RESPCACHE_tick(SI_CFG_RESPCACHE_WINDOW_MS - 1u);
+    SI_TEST_CHECK(0u == test_request(TEST_REQUESTER_IPV4, 3u));
+
+    SI_RESPCACHE_tick(1u);
+    SI_TEST_CHECK(1u == test_request(TEST_REQUESTER_IPV4, 3u));
+    SI_TEST_CHECK(0u == test_request(TEST_REQUESTER_IPV4, 3u));
+}
+
+#endif
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+int main(void)
+{
+#if (TRUE == SI_CFG_ENABLE_RESPONSE_CACHE)
+    SI_PROCESS_init();
+    test_add_service();
+    test_duplicate_suppressed();
+    test_window_ages_out();
+#endif
+
+    return SI_TEST_RESULT();
+}
+
+/* END OF TEST_RESPCACHE.C FILE */
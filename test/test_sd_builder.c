@@ -0,0 +1,139 @@
+/**
+ * @file    test_sd_builder.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test of SI_SD_builder.h: identical options are stored once, entries are added until the MTU is reached"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_test.h"
+#include "stubs.h"
+
+#include "SI_types.h"
+#include "SI_const.h"
+#include "SI_SD_const.h"
+#include "SI_SD_config.h"
+#include "SI_SD_payload.h"
+#include "SI_SD_builder.h"
+#include "SI_SD_service_manager.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define TEST_ENDPOINT_IPV4          (0x0A000001u)
+#define TEST_ENDPOINT_PORT          (30501u)
+
+// SOME/IP header, flags and "Length of Entries Array" precede the first entry
+#define TEST_FIRST_ENTRY_OFFSET     (SI_CONST_HEADER_LENGTH + 8u)
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static struct SI_SD_ServiceEntry test_entry(uint16 service_id)
+{
+    struct SI_SD_ServiceEntry entry;
+
+    (void)SI_SD_PAYLOAD_create_single_entry(SD_EntryTypes_Offer, 0u, 0u, 1u, 0u, service_id, 1u, 1u, 3u, 0u, &entry);
+    return entry;
+}
+
+static struct SI_SD_IPv4EndpointOption test_option(uint16 port)
+{
+    struct SI_SD_IPv4EndpointOption option;
+
+    (void)SI_SD_PAYLOAD_create_option(SI_SD_CONST_IPV4_OPTION_LENGTH, SD_OptionTypes_IPV4_ENDPOINT, FALSE,
+                                      TEST_ENDPOINT_IPV4, SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP, port, &option);
+    return option;
+}
+
+/**
+ * Entries with the same endpoint share one option, the option table limit does not stop shared options
+ */
+static void test_option_dedup(void)
+{
+    struct SI_SD_PayloadBuilder builder;
+    struct SI_SD_ServiceEntry entry = test_entry(0x1000u);
+    const struct SI_SD_IPv4EndpointOption shared = test_option(TEST_ENDPOINT_PORT);
+    struct SI_SD_IPv4EndpointOption option;
+    uint32 i = 0u;
+
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_init(&builder));
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_is_empty(&builder));
+
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_add_service_entry(&builder, &entry, &shared));
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_add_service_entry(&builder, &entry, &shared));
+    SI_TEST_CHECK(2u == builder.entries_num);
+    SI_TEST_CHECK(1u == builder.options_num);
+
+    for (i = 1u; i < SI_SD_CFG_BUILDER_MAX_OPTIONS; i++)
+    {
+        option = test_option((uint16)(TEST_ENDPOINT_PORT + i));
+        SI_TEST_CHECK(TRUE == SI_SD_BUILDER_add_service_entry(&builder, &entry, &option));
+        SI_TEST_CHECK((i + 1u) == builder.options_num);
+    }
+
+    option = test_option((uint16)(TEST_ENDPOINT_PORT + SI_SD_CFG_BUILDER_MAX_OPTIONS));
+    SI_TEST_CHECK(FALSE == SI_SD_BUILDER_add_service_entry(&builder, &entry, &option));
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_add_service_entry(&builder, &entry, &shared));
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_add_service_entry(&builder, &entry, NULLPTR));
+    SI_TEST_CHECK(SI_SD_CFG_BUILDER_MAX_OPTIONS == builder.options_num);
+    SI_TEST_CHECK((SI_SD_CFG_BUILDER_MAX_OPTIONS + 3u) == builder.entries_num);
+
+    SI_TEST_CHECK(TRUE == SI_SD_PROVIDER_serialize(&builder));
+    // 2nd entry references the shared option, 3rd entry the second option
+    SI_TEST_CHECK(0u == builder.message.data[TEST_FIRST_ENTRY_OFFSET + SI_SD_CONST_ENTRY_ARRAY_SIZE + 1u]);
+    SI_TEST_CHECK(1u == builder.message.data[TEST_FIRST_ENTRY_OFFSET + (2u * SI_SD_CONST_ENTRY_ARRAY_SIZE) + 1u]);
+    SI_TEST_CHECK(FALSE == SI_SD_BUILDER_add_service_entry(&builder, &entry, &shared));
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_invalidate(&builder));
+}
+
+/**
+ * Entries are added while the message with the options array stays within the MTU
+ */
+static void test_mtu_split(void)
+{
+    struct SI_SD_PayloadBuilder builder;
+    const struct SI_SD_IPv4EndpointOption shared = test_option(TEST_ENDPOINT_PORT);
+    struct SI_SD_ServiceEntry entry;
+    const uint32 expected = (SI_CONST_UDP_MTU_LENGTH - SI_SD_CONST_HEADER_LENGTH - SI_SD_CONST_OPTION_ARRAY_SIZE) /
+                            SI_SD_CONST_ENTRY_ARRAY_SIZE;
+    uint32 added = 0u;
+
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_init(&builder));
+    entry = test_entry((uint16)added);
+    while (TRUE == SI_SD_BUILDER_add_service_entry(&builder, &entry, &shared))
+    {
+        added += 1u;
+        entry = test_entry((uint16)added);
+    }
+    SI_TEST_CHECK(expected == added);
+
+    SI_TEST_CHECK(TRUE == SI_SD_PROVIDER_serialize(&builder));
+    SI_TEST_CHECK(SI_CONST_UDP_MTU_LENGTH >= builder.message.length);
+    SI_TEST_CHECK(SI_CONST_UDP_MTU_LENGTH < (builder.message.length + SI_SD_CONST_ENTRY_ARRAY_SIZE));
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_invalidate(&builder));
+
+    // Remaining entry starts the next datagram
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_init(&builder));
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_add_service_entry(&builder, &entry, &shared));
+    SI_TEST_CHECK(TRUE == SI_SD_BUILDER_invalidate(&builder));
+}
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+int main(void)
+{
+    test_option_dedup();
+    test_mtu_split();
+
+    return SI_TEST_RESULT();
+}
+
+/* END OF TEST_SD_BUILDER.C FILE */
@@ -0,0 +1,148 @@
+/**
+ * @file    test_sd_parser.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test of SI_SD_parser.h: option runs of the entries are resolved through the indexed options array,
+ *           unknown discardable options are skipped, entries referencing missing or unknown mandatory options are rejected"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include <string.h>
+
+#include "lwip/def.h"
+
+#include "SI_test.h"
+#include "stubs.h"
+
+#include "SI_types.h"
+#include "SI_SD_parser.h"
+#include "SI_SD_service_manager.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define TEST_LOCAL_IPV4_BE          (0x0100A8C0u)   // 192.168.0.1
+#define TEST_MULTICAST_IPV4_BE      (0xFAFFFFEFu)   // 239.255.255.250
+#define TEST_PEER_IPV4_BE           (0x0700000Au)   // 10.0.0.7
+#define TEST_PEER_PORT_BE           (0x5A77u)
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+// SOME/IP header of an SD message (length is set by test_build_message()), reboot and unicast flags
+static const uint8 g_header[] = {0xFFu, 0xFFu, 0x81u, 0x00u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u, 1u, 1u, 2u, 0u,
+                                 0xC0u, 0u, 0u, 0u};
+
+// Offer entries: type, 1st run index, 2nd run index, run lengths, service ID, instance ID, major, TTL, minor
+static const uint8 g_entries[] =
+{
+    0x01u, 0u, 2u, 0x22u, 0x12u, 0x34u, 0u, 1u, 1u, 0u, 0u, 3u, 0u, 0u, 0u, 0u,   // runs 0..1 and 2..3: applied
+    0x01u, 4u, 0u, 0x10u, 0x56u, 0x78u, 0u, 2u, 1u, 0u, 0u, 3u, 0u, 0u, 0u, 0u,   // unknown mandatory option: rejected
+    0x01u, 3u, 9u, 0x11u, 0x9Au, 0xBCu, 0u, 1u, 1u, 0u, 0u, 3u, 0u, 0u, 0u, 0u,   // option 9 is missing: rejected
+    0x01u, 5u, 3u, 0x11u, 0x11u, 0x11u, 0u, 1u, 1u, 0u, 0u, 3u, 0u, 0u, 0u, 0u,   // configuration and endpoint: applied
+};
+
+// Options: length, type, discardable flag, content
+static const uint8 g_options[] =
+{
+    0u, 9u, 0x14u, 0u, 239u, 0u, 0u, 1u, 0u, 0x11u, 0x12u, 0x34u,     // 0: IPv4 multicast
+    0u, 5u, 0x77u, 0x80u, 1u, 2u, 3u, 4u,                             // 1: unknown, discardable
+    0u, 9u, 0x04u, 0u, 10u, 0u, 0u, 7u, 0u, 0x06u, 0x30u, 0x39u,      // 2: IPv4 TCP endpoint
+    0u, 9u, 0x04u, 0u, 10u, 0u, 0u, 8u, 0u, 0x11u, 0x30u, 0x3Au,      // 3: IPv4 UDP endpoint
+    0u, 2u, 0x55u, 0x00u, 9u,                                         // 4: unknown, mandatory
+    0u, 6u, 0x01u, 0u, 3u, 'a', '=', 'b', 0u,                         // 5: configuration
+};
+
+static uint8 g_message[sizeof(g_header) + 4u + sizeof(g_entries) + 4u + sizeof(g_options)];
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static boolean test_tx(uint32 dst_ipv4_be, uint16 dst_port_be, const uint8* data, uint32 length, void* user_ctx)
+{
+    (void)dst_ipv4_be;
+    (void)dst_port_be;
+    (void)data;
+    (void)length;
+    (void)user_ctx;
+
+    return TRUE;
+}
+
+static uint32 test_put_array(uint32 offset, const uint8* array, uint32 length)
+{
+    g_message[offset] = 0u;
+    g_message[offset + 1u] = 0u;
+    g_message[offset + 2u] = (uint8)(length >> 8u);
+    g_message[offset + 3u] = (uint8)length;
+    memcpy(&(g_message[offset + 4u]), array, length);
+
+    return (offset + 4u + length);
+}
+
+static uint32 test_build_message(void)
+{
+    uint32 length = sizeof(g_header);
+
+    memcpy(g_message, g_header, sizeof(g_header));
+    length = test_put_array(length, g_entries, sizeof(g_entries));
+    length = test_put_array(length, g_options, sizeof(g_options));
+    g_message[7] = (uint8)(length - 8u);
+
+    return length;
+}
+
+/**
+ * Entries are applied or rejected by their option runs, the other entries of the message are still processed
+ */
+static void test_option_runs(void)
+{
+    struct SD_Context sd_context;
+    const struct SD_TransportHandler_vtable tx_handler = {test_tx};
+    struct SI_SD_PARSER_Context parser_context;
+    struct SD_Header header;
+    struct SD_Payload payload;
+    struct SD_remote_Service* service = NULLPTR;
+    const uint32 length = test_build_message();
+
+    SI_TEST_CHECK(TRUE == SI_SD_PROVIDER_init(&sd_context, TEST_LOCAL_IPV4_BE, 0u, TEST_MULTICAST_IPV4_BE, &tx_handler, NULLPTR));
+    SI_TEST_CHECK(TRUE == SI_SD_PARSER_parse_datagram(g_message, length, &header, &payload));
+
+    SI_SD_PARSER_init_context(&parser_context, &sd_context, TEST_PEER_IPV4_BE, TEST_PEER_PORT_BE, TRUE);
+    SI_TEST_CHECK(TRUE == SI_SD_PARSER_parse_payload(&parser_context, &payload));
+    SI_TEST_CHECK(6u == parser_context.options_numof);
+    SI_TEST_CHECK(2u == parser_context.entries_applied);
+    SI_TEST_CHECK(2u == parser_context.entries_rejected);
+    SI_TEST_CHECK(1u == parser_context.options_skipped);
+
+    // UDP endpoint of the 2nd run is used, multicast and TCP endpoints are ignored
+    service = SI_SD_PROVIDER_lookup_service(0x1234u, 1u, 1u);
+    SI_TEST_CHECK(NULLPTR != service);
+    if (NULLPTR != service)
+    {
+        SI_TEST_CHECK(lwip_htonl(0x0A000008u) == service->endpoint.ipv4_be);
+        SI_TEST_CHECK(lwip_htons(0x303Au) == service->endpoint.port_be);
+    }
+    SI_TEST_CHECK(NULLPTR == SI_SD_PROVIDER_lookup_service(0x5678u, 2u, 1u));
+    SI_TEST_CHECK(NULLPTR == SI_SD_PROVIDER_lookup_service(0x9ABCu, 1u, 1u));
+    SI_TEST_CHECK(NULLPTR != SI_SD_PROVIDER_lookup_service(0x1111u, 1u, 1u));
+}
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+int main(void)
+{
+    test_option_runs();
+
+    return SI_TEST_RESULT();
+}
+
+/* END OF TEST_SD_PARSER.C FILE */
@@ -0,0 +1,108 @@
+/**
+ * @file    test_sd_peer.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test of SI_SD_peer.h: reboot detection from the session ID and the reboot flag of each channel"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_test.h"
+#include "stubs.h"
+
+#include "SI_types.h"
+#include "SI_SD_peer.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define TEST_PEER_IPV4      (0x0700000Au)
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static uint32 test_reboots(void)
+{
+    struct SI_SD_PEER_counters counters;
+
+    SI_SD_PEER_get_counters(&counters);
+    return counters.reboots_detected;
+}
+
+/**
+ * Increasing sessions with the reboot flag set are one life, a session not increasing starts a new one
+ */
+static void test_session_restart(void)
+{
+    const uint32 reboots_before = test_reboots();
+
+    SI_SD_PEER_init();
+
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 5u, TRUE, TRUE));
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 6u, TRUE, TRUE));
+    SI_TEST_CHECK(TRUE == SI_SD_PEER_update(TEST_PEER_IPV4, 6u, TRUE, TRUE));
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 7u, TRUE, TRUE));
+    SI_TEST_CHECK(TRUE == SI_SD_PEER_update(TEST_PEER_IPV4, 1u, TRUE, TRUE));
+    SI_TEST_CHECK((reboots_before + 2u) == test_reboots());
+}
+
+/**
+ * Session ID wrapping around clears the reboot flag: not a reboot. The flag set again is a reboot.
+ */
+static void test_flag_set_again(void)
+{
+    const uint32 reboots_before = test_reboots();
+
+    SI_SD_PEER_init();
+
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 0xFFFFu, TRUE, TRUE));
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 1u, FALSE, TRUE));
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 2u, FALSE, TRUE));
+    SI_TEST_CHECK(TRUE == SI_SD_PEER_update(TEST_PEER_IPV4, 3u, TRUE, TRUE));
+    SI_TEST_CHECK((reboots_before + 1u) == test_reboots());
+}
+
+/**
+ * Multicast and unicast sessions are counted separately, a reboot on one channel forgets both
+ */
+static void test_channels(void)
+{
+    struct SD_Peer peer;
+    const uint32 reboots_before = test_reboots();
+
+    SI_SD_PEER_init();
+
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_get(TEST_PEER_IPV4, &peer));
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 10u, TRUE, TRUE));
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 2u, TRUE, FALSE));
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 11u, TRUE, TRUE));
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 3u, TRUE, FALSE));
+
+    SI_TEST_CHECK(TRUE == SI_SD_PEER_update(TEST_PEER_IPV4, 1u, TRUE, TRUE));
+    SI_TEST_CHECK(TRUE == SI_SD_PEER_get(TEST_PEER_IPV4, &peer));
+    SI_TEST_CHECK(TRUE == peer.multicast.seen);
+    SI_TEST_CHECK(FALSE == peer.unicast.seen);
+
+    // First unicast message of the new life
+    SI_TEST_CHECK(FALSE == SI_SD_PEER_update(TEST_PEER_IPV4, 1u, TRUE, FALSE));
+    SI_TEST_CHECK((reboots_before + 1u) == test_reboots());
+}
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+int main(void)
+{
+    test_session_restart();
+    test_flag_set_again();
+    test_channels();
+
+    return SI_TEST_RESULT();
+}
+
+/* END OF TEST_SD_PEER.C FILE */
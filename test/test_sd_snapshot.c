@@ -0,0 +1,201 @@
+/**
+ * @file    test_sd_snapshot.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test of SI_SD_snapshot.h: remote service registry survives a save / load round trip with the
+ *           TTLs reduced by the time passed, corrupted or truncated snapshots are refused"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "lwip/def.h"
+
+#include "SI_test.h"
+#include "stubs.h"
+
+#include "SI_types.h"
+#include "SI_SD_const.h"
+#include "SI_SD_config.h"
+#include "SI_SD_payload.h"
+#include "SI_SD_snapshot.h"
+#include "SI_SD_service_manager.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define TEST_LOCAL_IPV4_BE          (0x0100A8C0u)   // 192.168.0.1
+#define TEST_MULTICAST_IPV4_BE      (0xFAFFFFEFu)   // 239.255.255.250
+#define TEST_PEER_IPV4_BE           (0x0100000Au)   // 10.0.0.1
+#define TEST_ENDPOINT_IPV4          (0x0A000001u)
+#define TEST_ENDPOINT_PORT          (1234u)
+#define TEST_MINOR                  (7u)
+#define TEST_SERVICES_NUM           (5u)
+
+#define TEST_SAVED_SEC              (1000u)
+#define TEST_LOADED_SEC             (1050u)
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+static struct SD_Context g_sd_context;
+static uint8 g_snapshot[SI_SD_SNAPSHOT_SIZE(SI_SD_CFG_MAX_REMOTE_SERVICES)];
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static boolean test_tx(uint32 dst_ipv4_be, uint16 dst_port_be, const uint8* data, uint32 length, void* user_ctx)
+{
+    (void)dst_ipv4_be;
+    (void)dst_port_be;
+    (void)data;
+    (void)length;
+    (void)user_ctx;
+
+    return TRUE;
+}
+
+static void test_init(void)
+{
+    const struct SD_TransportHandler_vtable tx_handler = {test_tx};
+
+    SI_TEST_CHECK(TRUE == SI_SD_PROVIDER_init(&g_sd_context, TEST_LOCAL_IPV4_BE, 0u, TEST_MULTICAST_IPV4_BE, &tx_handler, NULLPTR));
+}
+
+static void test_offer(uint16 service_id, uint32 ttl)
+{
+    struct SI_SD_ServiceEntry entry;
+    struct SI_SD_IPv4EndpointOption option;
+
+    (void)SI_SD_PAYLOAD_create_single_entry(SD_EntryTypes_Offer, 0u, 0u, 1u, 0u, service_id, 1u, 1u, ttl, TEST_MINOR, &entry);
+    (void)SI_SD_PAYLOAD_create_option(SI_SD_CONST_IPV4_OPTION_LENGTH, SD_OptionTypes_IPV4_ENDPOINT, FALSE,
+                                      TEST_ENDPOINT_IPV4 + service_id, SI_SD_CONST_IPV4_PROTOCOL_TYPE_UDP,
+                                      TEST_ENDPOINT_PORT, &option);
+    SI_SD_PROVIDER_apply_offer(&entry, &option, TEST_PEER_IPV4_BE);
+}
+
+/**
+ * @returns bit i is set if service i is in the registry
+ */
+static uint32 test_known_services(void)
+{
+    uint32 known = 0u;
+    uint16 i = 0u;
+
+    for (i = 0u; i < TEST_SERVICES_NUM; i++)
+    {
+        if (NULLPTR != SI_SD_PROVIDER_lookup_service(i, 1u, 1u))
+        {
+            known |= (1u << i);
+        }
+    }
+    return known;
+}
+
+/**
+ * Services offered before the save are restored, services expired while the node was down are not
+ */
+static void test_round_trip(void)
+{
+    struct SD_Endpoint endpoint;
+    uint32 generation = 0u;
+    uint32 length = 0u;
+    struct SD_remote_Service* service = NULLPTR;
+
+    test_init();
+    test_offer(0u, 10u);
+    test_offer(1u, 100u);
+    test_offer(2u, SI_SD_CONST_TTL_INFINITE);
+    test_offer(3u, 5000u);
+    test_offer(4u, 1u);
+    SI_SD_PROVIDER_tick_ms(&g_sd_context, 1500u);
+    SI_TEST_CHECK(0x0Fu == test_known_services());
+
+    length = SI_SD_PROVIDER_save_snapshot(g_snapshot, sizeof(g_snapshot), TEST_SAVED_SEC);
+    SI_TEST_CHECK(SI_SD_SNAPSHOT_SIZE(4u) == length);
+
+    test_init();
+    SI_TEST_CHECK(0u == test_known_services());
+    SI_TEST_CHECK(3u == SI_SD_PROVIDER_load_snapshot(g_snapshot, length, TEST_LOADED_SEC));
+    SI_TEST_CHECK(0x0Eu == test_known_services());
+
+    service = SI_SD_PROVIDER_resolve_service(3u, 1u, 1u, &endpoint, &generation);
+    SI_TEST_CHECK(NULLPTR != service);
+    if (NULLPTR != service)
+    {
+        SI_TEST_CHECK(lwip_htonl(TEST_ENDPOINT_IPV4 + 3u) == endpoint.ipv4_be);
+        SI_TEST_CHECK(lwip_htons(TEST_ENDPOINT_PORT) == endpoint.port_be);
+        // Remaining TTL is saved in whole seconds, rounded up
+        SI_TEST_CHECK((5000u - 2u - (TEST_LOADED_SEC - TEST_SAVED_SEC)) == service->ttl);
+        SI_TEST_CHECK(TEST_MINOR == service->minor);
+        SI_TEST_CHECK(TEST_PEER_IPV4_BE == service->peer_ipv4_be);
+    }
+
+    // Restored services are live registry entries: known ones are not restored again, TTLs go on expiring
+    SI_TEST_CHECK(0u == SI_SD_PROVIDER_load_snapshot(g_snapshot, length, TEST_LOADED_SEC));
+    SI_SD_PROVIDER_tick_ms(&g_sd_context, 49000u);
+    SI_TEST_CHECK(0x0Cu == test_known_services());
+}
+
+/**
+ * Buffer too small for the registry: the least recently offered services are left out
+ */
+static void test_small_buffer(void)
+{
+    uint32 length = 0u;
+
+    test_init();
+    test_offer(1u, 100u);
+    test_offer(2u, 100u);
+    test_offer(3u, 100u);
+    SI_TEST_CHECK(0u == SI_SD_PROVIDER_save_snapshot(g_snapshot, SI_SD_SNAPSHOT_HEADER_SIZE - 1u, TEST_SAVED_SEC));
+    length = SI_SD_PROVIDER_save_snapshot(g_snapshot, SI_SD_SNAPSHOT_SIZE(2u), TEST_SAVED_SEC);
+    SI_TEST_CHECK(SI_SD_SNAPSHOT_SIZE(2u) == length);
+
+    test_init();
+    SI_TEST_CHECK(2u == SI_SD_PROVIDER_load_snapshot(g_snapshot, length, TEST_SAVED_SEC));
+    SI_TEST_CHECK(0x0Cu == test_known_services());
+}
+
+/**
+ * A flipped bit or a missing byte makes the whole snapshot rejected
+ */
+static void test_corrupted(void)
+{
+    uint32 length = 0u;
+
+    test_init();
+    test_offer(1u, 100u);
+    test_offer(2u, 100u);
+    length = SI_SD_PROVIDER_save_snapshot(g_snapshot, sizeof(g_snapshot), TEST_SAVED_SEC);
+    SI_TEST_CHECK(SI_SD_SNAPSHOT_SIZE(2u) == length);
+
+    test_init();
+    g_snapshot[SI_SD_SNAPSHOT_HEADER_SIZE + 2u] ^= 1u;
+    SI_TEST_CHECK(0u == SI_SD_PROVIDER_load_snapshot(g_snapshot, length, TEST_SAVED_SEC));
+    g_snapshot[SI_SD_SNAPSHOT_HEADER_SIZE + 2u] ^= 1u;
+    SI_TEST_CHECK(0u == SI_SD_PROVIDER_load_snapshot(g_snapshot, length - 1u, TEST_SAVED_SEC));
+    SI_TEST_CHECK(0u == test_known_services());
+
+    SI_TEST_CHECK(2u == SI_SD_PROVIDER_load_snapshot(g_snapshot, length, TEST_SAVED_SEC));
+    SI_TEST_CHECK(0x06u == test_known_services());
+}
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+int main(void)
+{
+    test_round_trip();
+    test_small_buffer();
+    test_corrupted();
+
+    return SI_TEST_RESULT();
+}
+
+/* END OF TEST_SD_SNAPSHOT.C FILE */
@@ -0,0 +1,160 @@
+/**
+ * @file    test_timerwheel.c
+ * @author  Erdei Sándor (sandorerdei21@gmail.com)
+ * @date
+ * @brief   "Host test of SI_timerwheel.h: expiry on every level of the wheel, cascading and cancelling"
+ */
+
+/* **************************************************** */
+/*                      Includes                        */
+/* **************************************************** */
+
+#include "SI_test.h"
+
+#include "SI_types.h"
+#include "SI_config.h"
+#include "SI_timerwheel.h"
+
+/* **************************************************** */
+/*                       Defines                        */
+/* **************************************************** */
+
+#define TEST_TICK_MS        (SI_CFG_TIMERWHEEL_RESOLUTION_MS)
+#define TEST_LEVEL1_MS      (SI_TIMERWHEEL_SLOT_NUM * TEST_TICK_MS)
+#define TEST_LEVEL2_MS      (SI_TIMERWHEEL_SLOT_NUM * TEST_LEVEL1_MS)
+#define TEST_LEVEL3_MS      (SI_TIMERWHEEL_SLOT_NUM * TEST_LEVEL2_MS)
+
+/* **************************************************** */
+/*               Static global variables                */
+/* **************************************************** */
+
+struct test_timer
+{
+    struct SI_TIMERWHEEL_node node;
+    uint32 fired_ms;
+    uint32 fired_num;
+};
+
+static struct SI_TIMERWHEEL_wheel g_wheel;
+static uint32 g_now_ms = 0u;
+
+/* **************************************************** */
+/*             Local function definitions               */
+/* **************************************************** */
+
+static void test_expired(void* context)
+{
+    struct test_timer* timer = (struct test_timer*)context;
+
+    timer->fired_ms = g_now_ms;
+    timer->fired_num += 1u;
+}
+
+static void test_advance(uint32 duration_ms)
+{
+    uint32 i = 0u;
+
+    for (i = 0u; i < (duration_ms / TEST_TICK_MS); i++)
+    {
+        g_now_ms += TEST_TICK_MS;
+        SI_TIMERWHEEL_advance(&g_wheel, TEST_TICK_MS);
+    }
+}
+
+/**
+ * Timers of every level expire exactly after their delay, also if the wheel does not start at tick 0
+ */
+static void test_levels(uint32 start_ms)
+{
+    uint32 i = 0u;
+    const uint32 delays_ms[] = {TEST_TICK_MS, TEST_LEVEL1_MS - TEST_TICK_MS, TEST_LEVEL1_MS, TEST_LEVEL1_MS + TEST_TICK_MS,
+                                TEST_LEVEL2_MS - TEST_TICK_MS, TEST_LEVEL2_MS, TEST_LEVEL2_MS + (7u * TEST_TICK_MS),
+                                TEST_LEVEL3_MS + (3u * TEST_LEVEL1_MS) + TEST_TICK_MS};
+    const uint32 timers_num = sizeof(delays_ms) / sizeof(delays_ms[0]);
+    struct test_timer timers[sizeof(delays_ms) / sizeof(delays_ms[0])] = {0};
+
+    SI_TIMERWHEEL_init(&g_wheel);
+    g_now_ms = 0u;
+    test_advance(start_ms);
+
+    for (i = 0u; i < timers_num; i++)
+    {
+        SI_TEST_CHECK(TRUE == SI_TIMERWHEEL_arm(&g_wheel, &(timers[i].node), delays_ms[i], test_expired, &(timers[i])));
+        SI_TEST_CHECK(delays_ms[i] == SI_TIMERWHEEL_remaining_ms(&g_wheel, &(timers[i].node)));
+    }
+
+    test_advance(delays_ms[timers_num - 1u] + TEST_LEVEL1_MS);
+
+    for (i = 0u; i < timers_num; i++)
+    {
+        SI_TEST_CHECK(1u == timers[i].fired_num);
+        SI_TEST_CHECK((start_ms + delays_ms[i]) == timers[i].fired_ms);
+        SI_TEST_CHECK(FALSE == SI_TIMERWHEEL_is_armed(&(timers[i].node)));
+    }
+}
+
+/**
+ * Elapsed time of several ticks in one call: slots in between and cascades are not skipped
+ */
+static void test_long_advance(void)
+{
+    struct test_timer near = {0};
+    struct test_timer far = {0};
+
+    SI_TIMERWHEEL_init(&g_wheel);
+    g_now_ms = 0u;
+
+    (void)SI_TIMERWHEEL_arm(&g_wheel, &(near.node), 3u * TEST_TICK_MS, test_expired, &near);
+    (void)SI_TIMERWHEEL_arm(&g_wheel, &(far.node), TEST_LEVEL2_MS + TEST_LEVEL1_MS, test_expired, &far);
+
+    SI_TIMERWHEEL_advance(&g_wheel, TEST_LEVEL2_MS);
+    SI_TEST_CHECK(1u == near.fired_num);
+    SI_TEST_CHECK(0u == far.fired_num);
+    SI_TEST_CHECK(TEST_LEVEL1_MS == SI_TIMERWHEEL_remaining_ms(&g_wheel, &(far.node)));
+
+    SI_TIMERWHEEL_advance(&g_wheel, TEST_LEVEL1_MS + (TEST_TICK_MS / 2u));
+    SI_TEST_CHECK(1u == far.fired_num);
+}
+
+/**
+ * Delay is rounded up to the resolution, cancelled and re-armed timers do not fire early
+ */
+static void test_cancel_and_rearm(void)
+{
+    struct test_timer cancelled = {0};
+    struct test_timer rearmed = {0};
+    struct test_timer rounded = {0};
+
+    SI_TIMERWHEEL_init(&g_wheel);
+    g_now_ms = 0u;
+
+    (void)SI_TIMERWHEEL_arm(&g_wheel, &(cancelled.node), TEST_LEVEL1_MS, test_expired, &cancelled);
+    (void)SI_TIMERWHEEL_arm(&g_wheel, &(rearmed.node), TEST_TICK_MS, test_expired, &rearmed);
+    (void)SI_TIMERWHEEL_arm(&g_wheel, &(rounded.node), TEST_TICK_MS + 1u, test_expired, &rounded);
+    (void)SI_TIMERWHEEL_arm(&g_wheel, &(rearmed.node), TEST_LEVEL1_MS * 2u, test_expired, &rearmed);
+    SI_TIMERWHEEL_cancel(&(cancelled.node));
+    SI_TEST_CHECK(FALSE == SI_TIMERWHEEL_is_armed(&(cancelled.node)));
+    SI_TEST_CHECK(0u == SI_TIMERWHEEL_remaining_ms(&g_wheel, &(cancelled.node)));
+
+    test_advance(TEST_LEVEL1_MS * 3u);
+    SI_TEST_CHECK(0u == cancelled.fired_num);
+    SI_TEST_CHECK(1u == rearmed.fired_num);
+    SI_TEST_CHECK((TEST_LEVEL1_MS * 2u) == rearmed.fired_ms);
+    SI_TEST_CHECK((2u * TEST_TICK_MS) == rounded.fired_ms);
+}
+
+/* **************************************************** */
+/*             Global function definitions              */
+/* **************************************************** */
+
+int main(void)
+{
+    test_levels(0u);
+    test_levels(12345u * TEST_TICK_MS);
+    test_long_advance();
+    test_cancel_and_rearm();
+
+    return SI_TEST_RESULT();
+}
+
+/* END OF TEST_TIMERWHEEL.C FILE */